@@ -31,26 +31,30 @@
 #include "aws_sdk_helper.h"
 #include "driver.h"
 
-namespace {
-AWS_SDK_HELPER SDK_HELPER;
-}
+AUTH_UTIL::AUTH_UTIL(const char* region) : region{region ? region : ""} {}
 
-AUTH_UTIL::AUTH_UTIL(const char* region) {
-  ++SDK_HELPER;
+std::string AUTH_UTIL::get_auth_token(const char* host, const char* region, unsigned int port, const char* user) {
+  return get_rds_client()->GenerateConnectAuthToken(host, region, port, user);
+}
 
-  Aws::Auth::DefaultAWSCredentialsProviderChain credentials_provider;
-  Aws::Auth::AWSCredentials credentials = credentials_provider.GetAWSCredentials();
+// Connections using a cached token never need the client, it is created
+// along with the AWS API when the first token is generated.
+std::shared_ptr<Aws::RDS::RDSClient> AUTH_UTIL::get_rds_client() {
+  std::lock_guard<std::mutex> lock(client_mutex);
+  if (!this->rds_client) {
+    AWS_SDK_HELPER::init();
 
-  Aws::RDS::RDSClientConfiguration client_config;
-  if (region) {
-    client_config.region = region;
-  }
+    Aws::Auth::DefaultAWSCredentialsProviderChain credentials_provider;
+    Aws::Auth::AWSCredentials credentials = credentials_provider.GetAWSCredentials();
 
-  this->rds_client = std::make_shared<Aws::RDS::RDSClient>(credentials, client_config);
-};
+    Aws::RDS::RDSClientConfiguration client_config;
+    if (!this->region.empty()) {
+      client_config.region = this->region;
+    }
 
-std::string AUTH_UTIL::get_auth_token(const char* host, const char* region, unsigned int port, const char* user) {
-  return this->rds_client->GenerateConnectAuthToken(host, region, port, user);
+    this->rds_client = std::make_shared<Aws::RDS::RDSClient>(credentials, client_config);
+  }
+  return this->rds_client;
 }
 
 std::string AUTH_UTIL::build_cache_key(const char* host, const char* region, unsigned int port, const char* user) {
@@ -60,5 +64,4 @@ std::string AUTH_UTIL::build_cache_key(const char* host, const char* region, uns
 
 AUTH_UTIL::~AUTH_UTIL() {
   this->rds_client.reset();
-  --SDK_HELPER;
 }
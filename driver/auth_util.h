@@ -32,6 +32,7 @@
 
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 #include <aws/rds/RDSClient.h>
+#include <mutex>
 
 #include "connection_proxy.h"
 
@@ -67,7 +68,12 @@ class AUTH_UTIL {
   static std::string build_cache_key(const char* host, const char* region, unsigned int port, const char* user);
 
  private:
+  // Empty for the default region of the client configuration
+  std::string region;
   std::shared_ptr<Aws::RDS::RDSClient> rds_client;
+  std::mutex client_mutex;
+
+  std::shared_ptr<Aws::RDS::RDSClient> get_rds_client();
 
 #ifdef UNIT_TEST_BUILD
   // Allows for testing private/protected methods
@@ -29,23 +29,26 @@
 
 #include "aws_sdk_helper.h"
 
-std::atomic<int> AWS_SDK_HELPER::sdk_reference_count{0};
+Aws::SDKOptions AWS_SDK_HELPER::sdk_options;
+bool AWS_SDK_HELPER::sdk_initialized = false;
 std::mutex AWS_SDK_HELPER::sdk_mutex;
 
-AWS_SDK_HELPER& AWS_SDK_HELPER::operator++()
+// Concurrent users wait for the initialization. Initializing and shutting the API down
+// is costly, connections come and go without doing either.
+void AWS_SDK_HELPER::init()
 {
-    if (1 == ++sdk_reference_count) {
-        std::lock_guard<std::mutex> lock(sdk_mutex);
+    std::lock_guard<std::mutex> lock(sdk_mutex);
+    if (!sdk_initialized) {
         Aws::InitAPI(sdk_options);
+        sdk_initialized = true;
     }
-    return *this;
 }
 
-AWS_SDK_HELPER& AWS_SDK_HELPER::operator--()
+void AWS_SDK_HELPER::shutdown()
 {
-    if (0 == --sdk_reference_count) {
-        std::lock_guard<std::mutex> lock(sdk_mutex);
+    std::lock_guard<std::mutex> lock(sdk_mutex);
+    if (sdk_initialized) {
         Aws::ShutdownAPI(sdk_options);
+        sdk_initialized = false;
     }
-    return *this;
 }
@@ -32,23 +32,23 @@
 
 #include <aws/core/Aws.h>
 
-#include <atomic>
 #include <mutex>
 
 /**
- * A helper class to initialize/shutdown AWS API once per DLL load/unload.
+ * A helper class to initialize the AWS API when its first user needs it.
+ * The API then stays initialized until the driver is unloaded.
  */
 class AWS_SDK_HELPER {
 public:
-    AWS_SDK_HELPER() = default;
+    // Returns once the AWS API is initialized
+    static void init();
 
-    AWS_SDK_HELPER& operator++();
-
-    AWS_SDK_HELPER& operator--();
+    // Shuts the AWS API down if it was initialized, called when the driver is unloaded
+    static void shutdown();
 
 private:
-    Aws::SDKOptions sdk_options;
-    static std::atomic<int> sdk_reference_count;
+    static Aws::SDKOptions sdk_options;
+    static bool sdk_initialized;
     static std::mutex sdk_mutex;
 };
 
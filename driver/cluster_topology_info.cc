@@ -49,6 +49,7 @@ CLUSTER_TOPOLOGY_INFO::CLUSTER_TOPOLOGY_INFO() {
 CLUSTER_TOPOLOGY_INFO::CLUSTER_TOPOLOGY_INFO(const CLUSTER_TOPOLOGY_INFO& src_info)
     : current_reader{src_info.current_reader},
       last_updated{src_info.last_updated},
+      down_hosts{src_info.down_hosts},
       last_used_reader{src_info.last_used_reader} {
     for (auto host_info_source : src_info.writers) {
         writers.push_back(std::make_shared<HOST_INFO>(*host_info_source)); //default copy
@@ -145,15 +146,27 @@ void CLUSTER_TOPOLOGY_INFO::set_last_used_reader(std::shared_ptr<HOST_INFO> read
 }
 
 void CLUSTER_TOPOLOGY_INFO::mark_host_down(std::shared_ptr<HOST_INFO> host) {
-    host->set_host_state(DOWN);
-    down_hosts.insert(host->get_host_port_pair());
+    set_host_state(host->get_host_id(), DOWN);
+    down_hosts.insert(host->get_host_id());
 }
 
 void CLUSTER_TOPOLOGY_INFO::mark_host_up(std::shared_ptr<HOST_INFO> host) {
-    host->set_host_state(UP);
-    down_hosts.erase(host->get_host_port_pair());
+    set_host_state(host->get_host_id(), UP);
+    down_hosts.erase(host->get_host_id());
+}
+
+// The given host may belong to another copy of the topology, which may be published
+// and read concurrently, so only the matching hosts of this one are updated
+void CLUSTER_TOPOLOGY_INFO::set_host_state(HOST_ID host_id, HOST_STATE state) {
+    for (const auto& hosts : { &writers, &readers }) {
+        for (const auto& host_info : *hosts) {
+            if (host_info->get_host_id() == host_id) {
+                host_info->set_host_state(state);
+            }
+        }
+    }
 }
 
-std::set<std::string> CLUSTER_TOPOLOGY_INFO::get_down_hosts() {
+std::set<HOST_ID> CLUSTER_TOPOLOGY_INFO::get_down_hosts() {
     return down_hosts;
 }
@@ -62,7 +62,7 @@ public:
 private:
     int current_reader = -1;
     std::time_t last_updated;
-    std::set<std::string> down_hosts; // maybe not needed, HOST_INFO has is_host_down() method
+    std::set<HOST_ID> down_hosts; // maybe not needed, HOST_INFO has is_host_down() method
     //std::vector<HOST_INFO*> hosts;
     std::shared_ptr<HOST_INFO> last_used_reader;  // TODO perhaps this overlaps with current_reader and is not needed
 
@@ -76,10 +76,17 @@ private:
     void set_last_used_reader(std::shared_ptr<HOST_INFO> reader);
     void mark_host_down(std::shared_ptr<HOST_INFO> host);
     void mark_host_up(std::shared_ptr<HOST_INFO> host);
-    std::set<std::string> get_down_hosts();
+    std::set<HOST_ID> get_down_hosts();
+    void set_host_state(HOST_ID host_id, HOST_STATE state);
     void update_time();
 
     friend class TOPOLOGY_SERVICE;
+    friend class TOPOLOGY_SNAPSHOT;
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private/protected methods
+    friend class TEST_UTILS;
+#endif
 };
 
 #endif /* __CLUSTERTOPOLOGYINFO_H__ */
@@ -92,25 +92,18 @@ unsigned long get_client_flags(DataSource *ds)
 }
 
 
-void DBC::set_charset(std::string charset)
-{
-  // Use SET NAMES instead of mysql_set_character_set()
-  // because running odbc_stmt() is thread safe.
-  std::string query = "SET NAMES " + charset;
-  if (execute_query(query.c_str(), query.length(), true))
-  {
-    throw MYERROR("HY000", connection_proxy);
-  }
-}
-
 /**
  If it was specified, set the character set for the connection and
  other internal charset properties.
 
- @param[in]  dbc      Database connection
- @param[in]  charset  Character set name
+ The character set is set in the same statement as the other session
+ settings given, to initialize the session in a single round trip.
+
+ @param[in]  charset           Character set name
+ @param[in]  session_settings  Other assignments of the SET statement
 */
-SQLRETURN DBC::set_charset_options(const char *charset)
+SQLRETURN DBC::set_charset_options(const char *charset,
+                                   const std::vector<std::string> &session_settings)
 try
 {
   if (unicode)
@@ -132,10 +125,23 @@ try
     charset = transport_charset;
   }
 
-  if (charset && charset[0])
-    set_charset(charset);
-  else
-    set_charset(ansi_charset_info->csname);
+  /*
+    Use SET NAMES instead of mysql_set_character_set()
+    because running odbc_stmt() is thread safe.
+
+    We always set character_set_results to NULL so we can do our own
+    conversion to the ANSI character set or Unicode.
+  */
+  std::string query = "SET NAMES ";
+  query.append(charset && charset[0] ? charset : ansi_charset_info->csname);
+  query.append(", character_set_results = NULL");
+  for (const auto &setting : session_settings)
+    query.append(", ").append(setting);
+
+  if (execute_query(query.c_str(), query.length(), true))
+  {
+    throw MYERROR("HY000", connection_proxy);
+  }
 
   {
     MY_CHARSET_INFO my_charset;
@@ -146,16 +152,6 @@ try
   if (!unicode)
     ansi_charset_info = cxn_charset_info;
 
-  /*
-    We always set character_set_results to NULL so we can do our own
-    conversion to the ANSI character set or Unicode.
-  */
-  if (execute_query("SET character_set_results = NULL", SQL_NTS, true)
-    != SQL_SUCCESS)
-  {
-    throw error;
-  }
-
   return SQL_SUCCESS;
 }
 catch(const MYERROR &e)
@@ -189,6 +185,137 @@ catch (const MYERROR& e)
   return e.retcode;
 }
 
+
+/**
+  Initialize the session of a newly opened connection: the character set,
+  INITSTMT, and the SQL_AUTO_IS_NULL, autocommit and transaction isolation
+  settings.
+
+  All settings are made with a single SET statement. With INITSTMT, the
+  character set is set before it and the other settings after it, as they
+  depend on the session state INITSTMT leaves, so it takes three statements.
+
+  @param[in]  dsrc  Data source of the connection
+*/
+SQLRETURN DBC::init_session(DataSource *dsrc)
+{
+  SQLRETURN rc = SQL_SUCCESS;
+  const bool has_initstmt = dsrc->opt_INITSTMT;
+
+  if (has_initstmt)
+  {
+    rc = set_charset_options(dsrc->opt_CHARSET);
+
+    // It could be an error with expired password in which case we
+    // still try to execute init statements and retry below.
+    if (rc == SQL_ERROR && error.native_error != ER_MUST_CHANGE_PASSWORD)
+      return SQL_ERROR;
+
+    // Try running INITSTMT.
+    if (!SQL_SUCCEEDED(run_initstmt(this, dsrc)))
+      return error.retcode;
+
+    // If we had expired password error at the beginning
+    // try setting charset options again.
+    // NOTE: charset name is converted to a single-byte
+    //       charset by previous call to ds_get_utf8attr().
+    if (rc == SQL_ERROR)
+      rc = set_charset_options((const char*)dsrc->opt_CHARSET);
+
+    if (!SQL_SUCCEEDED(rc))
+    {
+      return SQL_ERROR;
+    }
+  }
+
+  std::vector<std::string> session_settings;
+
+  /*
+    The MySQL server has a workaround for old versions of Microsoft Access
+    (and possibly other products) that is no longer necessary, but is
+    unfortunately enabled by default. We have to turn it off, or it causes
+    other problems.
+  */
+  if (!dsrc->opt_AUTO_IS_NULL)
+    session_settings.push_back("SQL_AUTO_IS_NULL = 0");
+
+  /* Make sure autocommit is set as configured. */
+  if (commit_flag == CHECK_AUTOCOMMIT_OFF)
+  {
+    if (!transactions_supported() || dsrc->opt_NO_TRANSACTIONS)
+    {
+      commit_flag = CHECK_AUTOCOMMIT_ON;
+      rc = set_error(MYERR_01S02,
+             "Transactions are not enabled, option value "
+             "SQL_AUTOCOMMIT_OFF changed to SQL_AUTOCOMMIT_ON",
+             SQL_SUCCESS_WITH_INFO);
+    }
+    else if (autocommit_is_on())
+    {
+      session_settings.push_back("autocommit = 0");
+    }
+  }
+  else if ((commit_flag == CHECK_AUTOCOMMIT_ON) &&
+           transactions_supported() && !autocommit_is_on())
+  {
+    session_settings.push_back("autocommit = 1");
+  }
+
+  /* Set transaction isolation as configured. */
+  if (txn_isolation != DEFAULT_TXN_ISOLATION)
+  {
+    const char *level;
+
+    if (txn_isolation & SQL_TXN_SERIALIZABLE)
+      level= "'SERIALIZABLE'";
+    else if (txn_isolation & SQL_TXN_REPEATABLE_READ)
+      level= "'REPEATABLE-READ'";
+    else if (txn_isolation & SQL_TXN_READ_COMMITTED)
+      level= "'READ-COMMITTED'";
+    else
+      level= "'READ-UNCOMMITTED'";
+
+    if (transactions_supported())
+    {
+      /* tx_isolation was renamed, and the old name removed in 8.0 */
+      const bool legacy_variable_names =
+        !is_minimum_version(connection_proxy->get_server_version(), "8.0");
+      session_settings.push_back(
+        std::string(legacy_variable_names ? "tx_isolation" : "transaction_isolation") +
+        " = " + level);
+    }
+    else
+    {
+      txn_isolation = SQL_TXN_READ_UNCOMMITTED;
+      rc = set_error(MYERR_01S02,
+             "Transactions are not enabled, so transaction isolation "
+             "was ignored.", SQL_SUCCESS_WITH_INFO);
+    }
+  }
+
+  if (!has_initstmt)
+  {
+    if (!SQL_SUCCEEDED(set_charset_options(dsrc->opt_CHARSET, session_settings)))
+      return SQL_ERROR;
+  }
+  else if (!session_settings.empty())
+  {
+    std::string query = "SET ";
+    for (size_t i = 0; i < session_settings.size(); ++i)
+    {
+      if (i > 0)
+        query.append(", ");
+      query.append(session_settings[i]);
+    }
+
+    if (execute_query(query.c_str(), query.length(), true) != SQL_SUCCESS)
+      return SQL_ERROR;
+  }
+
+  return rc;
+}
+
+
 /*
   Retrieve DNS+SRV list.
 
@@ -921,6 +1048,22 @@ SQLRETURN DBC::connect(DataSource *dsrc, bool failover_enabled, bool is_monitor_
     std::random_device rd;
     std::mt19937 generator(rd()); // seed the generator
 
+    // Take over an idle connection opened with the same options, unless
+    // this is a reconnect of a connection that was already open
+    if (!pool_tag.key.empty() && pool_tag.host.empty())
+    {
+      MYSQL *pooled = CONNECTION_POOL::get_instance().acquire(pool_tag, failover_enabled);
+      if (pooled)
+      {
+        connection_proxy->set_connection(new POOLED_CONNECTION_PROXY(pooled));
+        // Copied, pool_tag is cleared when the connection is returned to the pool
+        dsrc->opt_SERVER = pool_tag.host;
+        dsrc->opt_PORT = pool_tag.port;
+        connected = true;
+        telemetry.set_attribs(this, dsrc);
+      }
+    }
+
 
     while(!hosts.empty() && !connected)
     {
@@ -935,6 +1078,9 @@ SQLRETURN DBC::connect(DataSource *dsrc, bool failover_enabled, bool is_monitor_
       if(do_connect(el->name.c_str(), el->port) == SQL_SUCCESS)
       {
         connected = true;
+        pool_tag.host = el->name;
+        pool_tag.port = el->port;
+        pool_tag.failover_timeouts = failover_enabled;
         telemetry.set_attribs(this, dsrc);
         break;
       }
@@ -979,6 +1125,10 @@ SQLRETURN DBC::connect(DataSource *dsrc, bool failover_enabled, bool is_monitor_
     }
   }
 
+  // The connection was just opened, or validated by the pool, there is
+  // no need to ping it before the first statement
+  last_query_time = (time_t)time((time_t*)0);
+
   has_query_attrs = connection_proxy->get_server_capabilities() & CLIENT_QUERY_ATTRIBUTES;
 
   if (!is_minimum_version(connection_proxy->get_server_version(), "4.1.1"))
@@ -987,40 +1137,9 @@ SQLRETURN DBC::connect(DataSource *dsrc, bool failover_enabled, bool is_monitor_
     return set_error("08001", "Driver does not support server versions under 4.1.1", 0);
   }
 
-  rc = set_charset_options(dsrc->opt_CHARSET);
-
-  // It could be an error with expired password in which case we
-  // still try to execute init statements and retry below.
-  if (rc == SQL_ERROR && error.native_error != ER_MUST_CHANGE_PASSWORD)
-    return SQL_ERROR;
-
-  // Try running INITSTMT.
-  if (!SQL_SUCCEEDED(run_initstmt(this, dsrc)))
-    return error.retcode;
-
-  // If we had expired password error at the beginning
-  // try setting charset options again.
-  // NOTE: charset name is converted to a single-byte
-  //       charset by previous call to ds_get_utf8attr().
-  if (rc == SQL_ERROR)
-    rc = set_charset_options((const char*)dsrc->opt_CHARSET);
-
+  rc = init_session(dsrc);
   if (!SQL_SUCCEEDED(rc))
-  {
-    return SQL_ERROR;
-  }
-
-  /*
-    The MySQL server has a workaround for old versions of Microsoft Access
-    (and possibly other products) that is no longer necessary, but is
-    unfortunately enabled by default. We have to turn it off, or it causes
-    other problems.
-  */
-  if (!dsrc->opt_AUTO_IS_NULL &&
-      execute_query("SET SQL_AUTO_IS_NULL = 0", SQL_NTS, true) != SQL_SUCCESS)
-  {
-    return SQL_ERROR;
-  }
+    return rc;
 
   ds = dsrc;
   /* init all needed UTF-8 strings */
@@ -1051,65 +1170,6 @@ SQLRETURN DBC::connect(DataSource *dsrc, bool failover_enabled, bool is_monitor_
   set_reconnect_result = 1;
 #endif
 
-  /* Make sure autocommit is set as configured. */
-  if (commit_flag == CHECK_AUTOCOMMIT_OFF)
-  {
-    if (!transactions_supported() || ds->opt_NO_TRANSACTIONS)
-    {
-      commit_flag = CHECK_AUTOCOMMIT_ON;
-      rc = set_error(MYERR_01S02,
-             "Transactions are not enabled, option value "
-             "SQL_AUTOCOMMIT_OFF changed to SQL_AUTOCOMMIT_ON",
-             SQL_SUCCESS_WITH_INFO);
-    }
-    else if (autocommit_is_on() && connection_proxy->autocommit(FALSE))
-    {
-      /** @todo set error */
-      return SQL_ERROR;
-    }
-  }
-  else if ((commit_flag == CHECK_AUTOCOMMIT_ON) &&
-           transactions_supported() && !autocommit_is_on())
-  {
-    if (connection_proxy->autocommit(TRUE))
-    {
-      /** @todo set error */
-      return SQL_ERROR;
-    }
-  }
-
-  /* Set transaction isolation as configured. */
-  if (txn_isolation != DEFAULT_TXN_ISOLATION)
-  {
-    char buff[80];
-    const char *level;
-
-    if (txn_isolation & SQL_TXN_SERIALIZABLE)
-      level= "SERIALIZABLE";
-    else if (txn_isolation & SQL_TXN_REPEATABLE_READ)
-      level= "REPEATABLE READ";
-    else if (txn_isolation & SQL_TXN_READ_COMMITTED)
-      level= "READ COMMITTED";
-    else
-      level= "READ UNCOMMITTED";
-
-    if (transactions_supported())
-    {
-      snprintf(buff, sizeof(buff), "SET SESSION TRANSACTION ISOLATION LEVEL %s", level);
-      if (execute_query(buff, SQL_NTS, true) != SQL_SUCCESS)
-      {
-        return SQL_ERROR;
-      }
-    }
-    else
-    {
-      txn_isolation = SQL_TXN_READ_UNCOMMITTED;
-      rc = set_error(MYERR_01S02,
-             "Transactions are not enabled, so transaction isolation "
-             "was ignored.", SQL_SUCCESS_WITH_INFO);
-    }
-  }
-
   /*
     AUTO_RECONNECT option needs to be handled with the following
     considerations:
@@ -1616,6 +1676,8 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC hdbc)
 
   dbc->free_connection_stmts();
 
+  // Keep the physical connection for a later connect with the same options
+  dbc->release_to_pool();
   dbc->close();
 
   if (ds->opt_LOG_QUERY)
@@ -1624,6 +1686,7 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC hdbc)
   /* free allocated packet buffer */
 
   dbc->database.clear();
+  dbc->session_state.clear();
   return SQL_SUCCESS;
 }
 
@@ -1719,15 +1782,24 @@ SQLRETURN DBC::execute_query(const char* query,
     return set_error(MYERR_08S01, "The active SQL connection was lost. Please discard this connection.", 0);
   }
 
-  bool server_alive = is_server_alive(this);
+  // Don't wait for a network timeout on a node that failure detection already found to be down
+  const bool node_unhealthy = this->connection_proxy->is_node_unhealthy();
+  bool server_alive = !node_unhealthy && is_server_alive(this);
   if (!server_alive || this->connection_proxy->real_query(query, query_length)) {
-    const unsigned int mysql_error_code = this->connection_proxy->error_code();
-
-    MYLOG_DBC_TRACE(this, this->connection_proxy->error());
-    result = set_error(MYERR_S1000, this->connection_proxy->error(), mysql_error_code);
+    unsigned int mysql_error_code = 0;
+    if (node_unhealthy) {
+      MYLOG_DBC_TRACE(this, "Not sending the query, the server is known to be unavailable");
+      result = set_error(MYERR_08S01, "The server is known to be unavailable.", 0);
+    } else {
+      mysql_error_code = this->connection_proxy->error_code();
+
+      MYLOG_DBC_TRACE(this, this->connection_proxy->error());
+      result = set_error(MYERR_S1000, this->connection_proxy->error(), mysql_error_code);
+    }
 
     if (!server_alive || is_connection_lost(mysql_error_code)) {
-      bool rollback = (!autocommit_on(this) && trans_supported(this)) || this->transaction_open;
+      bool rollback = !node_unhealthy &&
+        ((!autocommit_on(this) && trans_supported(this)) || this->transaction_open);
       if (rollback) {
         MYLOG_DBC_TRACE(this, "Rolling back");
         this->connection_proxy->real_query("ROLLBACK", 8);
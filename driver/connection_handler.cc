@@ -52,7 +52,7 @@
     }
 #endif
 
-CONNECTION_HANDLER::CONNECTION_HANDLER(DBC* dbc) : dbc{dbc} {}
+CONNECTION_HANDLER::CONNECTION_HANDLER(DBC* dbc) : dbc{dbc}, env{dbc ? dbc->env : nullptr} {}
 
 CONNECTION_HANDLER::~CONNECTION_HANDLER() = default;
 
@@ -66,23 +66,39 @@ CONNECTION_PROXY* CONNECTION_HANDLER::connect(std::shared_ptr<HOST_INFO> host_in
         return nullptr;
     }
 
-    DataSource* ds_to_use = new DataSource();
+    // Owned by the proxy chain returned
+    std::unique_ptr<DataSource> ds_to_use(new DataSource());
     ds_to_use->copy(ds ? ds : dbc->ds);
     const auto new_host = to_sqlwchar_string(host_info->get_host());
-
-    DBC* dbc_clone = clone_dbc(dbc, ds_to_use);
     ds_to_use->opt_SERVER.set_remove_brackets((SQLWCHAR*) new_host.c_str(), new_host.size());
 
+    // Only lives for the connect. It is not registered in the environment, which
+    // spares the environment lock and keeps it from being seen by the application.
+    DBC connect_dbc(env, false);
+    connect_dbc.init_proxy_chain(ds_to_use.get());
+
     CONNECTION_PROXY* new_connection = nullptr;
-    CLEAR_DBC_ERROR(dbc_clone);
-    const SQLRETURN rc = do_connect(dbc_clone, ds_to_use, ds_to_use->opt_ENABLE_CLUSTER_FAILOVER, is_monitor_connection);
+    const SQLRETURN rc = do_connect(&connect_dbc, ds_to_use.get(), ds_to_use->opt_ENABLE_CLUSTER_FAILOVER, is_monitor_connection);
 
     if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO) {
-        new_connection = dbc_clone->connection_proxy;
-        dbc_clone->connection_proxy = nullptr;
+        new_connection = connect_dbc.connection_proxy;
+        connect_dbc.connection_proxy = nullptr;
+        // The proxies outlive the handle they were created with
+        new_connection->set_dbc(dbc);
+        ds_to_use.release();
     }
 
-    my_SQLFreeConnect(dbc_clone);
+    return new_connection;
+}
+
+CONNECTION_PROXY* CONNECTION_HANDLER::connect_background(
+    std::shared_ptr<HOST_INFO> host_info, DataSource* ds, bool is_monitor_connection) {
+
+    CONNECTION_PROXY* new_connection = connect(host_info, ds, is_monitor_connection);
+    if (new_connection) {
+        // The handle may be freed while the connection is still in use
+        new_connection->set_dbc(nullptr);
+    }
 
     return new_connection;
 }
@@ -91,6 +107,9 @@ void CONNECTION_HANDLER::update_connection(
     CONNECTION_PROXY* new_connection, const std::string& new_host_name) {
 
     if (new_connection->is_connected()) {
+        // The last status the server reported for the session being replaced
+        const bool autocommit = dbc->connection_proxy->get_server_status() & SERVER_STATUS_AUTOCOMMIT;
+
         dbc->close();
         dbc->connection_proxy->set_connection(new_connection);
         
@@ -101,27 +120,11 @@ void CONNECTION_HANDLER::update_connection(
         // Update original ds to reflect change in host/server.
 
         dbc->ds->opt_SERVER.set_remove_brackets((SQLWCHAR*) new_host_name_wstr.c_str(), new_host_name_wstr.size());
-    }
-}
-
-DBC* CONNECTION_HANDLER::clone_dbc(DBC* source_dbc, DataSource* ds) {
-
-    DBC* dbc_clone = nullptr;
-
-    SQLRETURN status = SQL_ERROR;
-    if (source_dbc && source_dbc->env) {
-        SQLHDBC hdbc;
-        SQLHENV henv = static_cast<SQLHANDLE>(source_dbc->env);
 
-        status = my_SQLAllocConnect(henv, &hdbc);
-        if (status == SQL_SUCCESS || status == SQL_SUCCESS_WITH_INFO) {
-            dbc_clone = static_cast<DBC*>(hdbc);
-            dbc_clone->init_proxy_chain(ds);
-        } else {
-            const char* err = "Cannot allocate connection handle when cloning DBC";
-            MYLOG_DBC_TRACE(dbc, err);
-            throw std::runtime_error(err);
+        // Set the session up as the application left it, in a single round trip
+        if (!dbc->session_state.restore(dbc, autocommit)) {
+            // The limit is set again before the next query that needs it
+            dbc->sql_select_limit = (SQLULEN)-1;
         }
     }
-    return dbc_clone;
 }
@@ -42,6 +42,7 @@ typedef std::wstring sqlwchar_string;
 sqlwchar_string to_sqlwchar_string(const std::string& src);
 
 struct DBC;
+struct ENV;
 class DataSource;
 class CONNECTION_PROXY;
 typedef short SQLRETURN;
@@ -53,11 +54,14 @@ class CONNECTION_HANDLER {
 
         virtual SQLRETURN do_connect(DBC* dbc_ptr, DataSource* ds, bool failover_enabled, bool is_monitor_connection = false);
         virtual CONNECTION_PROXY* connect(std::shared_ptr<HOST_INFO> host_info, DataSource* ds, bool is_monitor_connection = false);
+        // For monitor, standby and refresher connections, which outlive the handle the handler belongs to.
+        // The proxies returned are not attached to a handle, and ds must not be null.
+        CONNECTION_PROXY* connect_background(std::shared_ptr<HOST_INFO> host_info, DataSource* ds, bool is_monitor_connection = false);
         void update_connection(CONNECTION_PROXY* new_connection, const std::string& new_host_name);
 
     private:
         DBC* dbc;
-        DBC* clone_dbc(DBC* source_dbc, DataSource* ds);
+        ENV* env;
 };
 
 #endif /* __CONNECTION_HANDLER_H__ */
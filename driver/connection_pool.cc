@@ -0,0 +1,251 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "connection_pool.h"
+#include "driver.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+// mysql_reset_connection() keeps the default database, which the application
+// may have changed with USE
+bool reset_connection(MYSQL* mysql, const std::string& database) {
+    if (mysql_reset_connection(mysql) != 0) {
+        return false;
+    }
+    if (!database.empty()) {
+        return mysql_select_db(mysql, database.c_str()) == 0;
+    }
+
+    // There is no way to go back to having no default database
+    if (mysql_query(mysql, "SELECT DATABASE()") != 0) {
+        return false;
+    }
+    MYSQL_RES* result = mysql_store_result(mysql);
+    if (result == nullptr) {
+        return false;
+    }
+    const MYSQL_ROW row = mysql_fetch_row(result);
+    const bool no_database = row != nullptr && row[0] == nullptr;
+    mysql_free_result(result);
+    return no_database;
+}
+}
+
+CONNECTION_POOL::CONNECTION_POOL(POOLED_CONNECTION_RESET reset, POOLED_CONNECTION_CHECK validate,
+                                 POOLED_CONNECTION_CLOSER close)
+    : reset{std::move(reset)}, validate{std::move(validate)}, close{std::move(close)} {}
+
+CONNECTION_POOL::~CONNECTION_POOL() {
+    clear();
+}
+
+CONNECTION_POOL& CONNECTION_POOL::get_instance() {
+    // Never destroyed, idle connections may still be returned while the process exits
+    static CONNECTION_POOL* instance = new CONNECTION_POOL(
+        reset_connection,
+        [](MYSQL* mysql) { return mysql_ping(mysql) == 0; },
+        [](MYSQL* mysql) { mysql_close(mysql); });
+    return *instance;
+}
+
+std::string CONNECTION_POOL::get_key(DataSource* ds) {
+    // Only options that are set are listed, in the same order for every data source
+    const SQLWSTRING options = ds->to_kvpair(';');
+    return std::string(reinterpret_cast<const char*>(options.data()), options.size() * sizeof(SQLWCHAR));
+}
+
+MYSQL* CONNECTION_POOL::acquire(CONNECTION_POOL_TAG& tag, bool failover_timeouts) {
+    std::vector<MYSQL*> to_close;
+    MYSQL* mysql = nullptr;
+
+    while (mysql == nullptr) {
+        IDLE_CONNECTION candidate;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            evict_expired(to_close);
+
+            const auto connections = idle_connections.find(tag.key);
+            if (connections == idle_connections.end()) {
+                break;
+            }
+            auto& queue = connections->second;
+            const auto match = std::find_if(queue.rbegin(), queue.rend(), [failover_timeouts](const IDLE_CONNECTION& c) {
+                return !failover_timeouts || c.tag.failover_timeouts;
+            });
+            if (match == queue.rend()) {
+                break;
+            }
+            candidate = *match;
+            queue.erase(std::next(match).base());
+            if (queue.empty()) {
+                idle_connections.erase(connections);
+            }
+        }
+
+        // The server may have closed the connection while it was idle
+        if (validate(candidate.mysql)) {
+            tag = candidate.tag;
+            mysql = candidate.mysql;
+        } else {
+            to_close.push_back(candidate.mysql);
+        }
+    }
+
+    close_all(to_close);
+    return mysql;
+}
+
+void CONNECTION_POOL::release(const CONNECTION_POOL_TAG& tag, MYSQL* mysql, size_t max_size,
+                              std::chrono::milliseconds max_idle_time) {
+    if (mysql == nullptr) {
+        return;
+    }
+
+    std::vector<MYSQL*> to_close;
+    // Rolls back the transaction and releases locks and temporary tables right away, rather
+    // than when the connection is taken again
+    bool keep = !tag.key.empty() && max_size > 0 &&
+                get_generation(tag.cluster_id) == tag.generation && reset(mysql, tag.database);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        evict_expired(to_close);
+
+        // The cluster may have been invalidated while the connection was reset
+        const auto generation = cluster_generations.find(tag.cluster_id);
+        keep = keep && (generation == cluster_generations.end() ? 0 : generation->second) == tag.generation;
+
+        auto& queue = idle_connections[tag.key];
+        if (keep && queue.size() < max_size) {
+            IDLE_CONNECTION idle;
+            idle.mysql = mysql;
+            idle.tag = tag;
+            idle.expires = max_idle_time.count() > 0
+                ? std::chrono::steady_clock::now() + max_idle_time
+                : std::chrono::steady_clock::time_point::max();
+            queue.push_back(idle);
+        } else {
+            to_close.push_back(mysql);
+            if (queue.empty()) {
+                idle_connections.erase(tag.key);
+            }
+        }
+    }
+
+    close_all(to_close);
+}
+
+uint64_t CONNECTION_POOL::get_generation(const std::string& cluster_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto generation = cluster_generations.find(cluster_id);
+    return generation == cluster_generations.end() ? 0 : generation->second;
+}
+
+void CONNECTION_POOL::invalidate_cluster(const std::string& cluster_id) {
+    std::vector<MYSQL*> to_close;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cluster_generations[cluster_id]++;
+
+        for (auto connections = idle_connections.begin(); connections != idle_connections.end();) {
+            auto& queue = connections->second;
+            for (auto idle = queue.begin(); idle != queue.end();) {
+                if (idle->tag.cluster_id == cluster_id) {
+                    to_close.push_back(idle->mysql);
+                    idle = queue.erase(idle);
+                } else {
+                    ++idle;
+                }
+            }
+            connections = queue.empty() ? idle_connections.erase(connections) : std::next(connections);
+        }
+    }
+
+    close_all(to_close);
+}
+
+size_t CONNECTION_POOL::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t size = 0;
+    for (const auto& connections : idle_connections) {
+        size += connections.second.size();
+    }
+    return size;
+}
+
+void CONNECTION_POOL::clear() {
+    std::vector<MYSQL*> to_close;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& connections : idle_connections) {
+            for (const auto& idle : connections.second) {
+                to_close.push_back(idle.mysql);
+            }
+        }
+        idle_connections.clear();
+    }
+
+    close_all(to_close);
+}
+
+void CONNECTION_POOL::evict_expired(std::vector<MYSQL*>& to_close) {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto connections = idle_connections.begin(); connections != idle_connections.end();) {
+        auto& queue = connections->second;
+        for (auto idle = queue.begin(); idle != queue.end();) {
+            if (idle->expires <= now) {
+                to_close.push_back(idle->mysql);
+                idle = queue.erase(idle);
+            } else {
+                ++idle;
+            }
+        }
+        connections = queue.empty() ? idle_connections.erase(connections) : std::next(connections);
+    }
+}
+
+void CONNECTION_POOL::close_all(const std::vector<MYSQL*>& connections) {
+    for (const auto mysql : connections) {
+        close(mysql);
+    }
+}
+
+POOLED_CONNECTION_PROXY::~POOLED_CONNECTION_PROXY() {
+    if (mysql) {
+        mysql_close(mysql);
+    }
+}
+
+MYSQL* POOLED_CONNECTION_PROXY::move_mysql_connection() {
+    MYSQL* ret = this->mysql;
+    this->mysql = nullptr;
+    return ret;
+}
@@ -0,0 +1,142 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __CONNECTIONPOOL_H__
+#define __CONNECTIONPOOL_H__
+
+#include "connection_proxy.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DataSource;
+
+typedef std::function<bool(MYSQL*)> POOLED_CONNECTION_CHECK;
+// Resets the session and makes the database its default again, or checks that
+// there is no default database if the name is empty
+typedef std::function<bool(MYSQL*, const std::string&)> POOLED_CONNECTION_RESET;
+typedef std::function<void(MYSQL*)> POOLED_CONNECTION_CLOSER;
+
+// Where a connection came from, and which idle connections it may be pooled with
+struct CONNECTION_POOL_TAG {
+    // Normalized options of the data source, empty if the connection is not pooled
+    std::string key;
+    // Default database of the data source, empty if there is none
+    std::string database;
+    // Host and port the connection was opened to, empty until it is open
+    std::string host;
+    unsigned int port = 0;
+    // Whether the connection was opened with the failover connect and network timeouts
+    bool failover_timeouts = false;
+    std::string cluster_id;
+    // Generation of the cluster when the connection was opened, see invalidate_cluster()
+    uint64_t generation = 0;
+};
+
+// Keeps the physical connections of disconnected handles open, to be taken over by later
+// connections with the same options instead of connecting and authenticating again.
+// Connections are reset when they are returned and checked when they are taken, and are
+// closed once they have been idle for too long. A failover in a cluster invalidates all
+// connections to it, pooled or still in use, as some of them may be to the failed instance.
+class CONNECTION_POOL {
+public:
+    CONNECTION_POOL(POOLED_CONNECTION_RESET reset, POOLED_CONNECTION_CHECK validate,
+                    POOLED_CONNECTION_CLOSER close);
+    CONNECTION_POOL(CONNECTION_POOL const&) = delete;
+    CONNECTION_POOL& operator=(CONNECTION_POOL const&) = delete;
+    ~CONNECTION_POOL();
+
+    static CONNECTION_POOL& get_instance();
+    static std::string get_key(DataSource* ds);
+
+    // Takes the most recently returned live connection with the tag's key and fills in the
+    // rest of the tag. Returns null if there is none. With failover_timeouts, only
+    // connections opened with the failover timeouts are taken.
+    MYSQL* acquire(CONNECTION_POOL_TAG& tag, bool failover_timeouts);
+    // Resets the connection, including its default database, and keeps it for up to
+    // max_idle_time, 0 for no limit. The connection is closed instead if there are max_size
+    // idle connections with the same key, if it can't be reset to the database of the tag,
+    // or if its cluster was invalidated since it was opened.
+    void release(const CONNECTION_POOL_TAG& tag, MYSQL* mysql, size_t max_size,
+                 std::chrono::milliseconds max_idle_time);
+
+    uint64_t get_generation(const std::string& cluster_id);
+    // Closes the idle connections to the cluster and starts a new generation for it
+    void invalidate_cluster(const std::string& cluster_id);
+
+    size_t size();
+    void clear();
+
+private:
+    struct IDLE_CONNECTION {
+        MYSQL* mysql = nullptr;
+        CONNECTION_POOL_TAG tag;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    // Moves the idle connections that expired to the list of connections to close
+    void evict_expired(std::vector<MYSQL*>& to_close);
+    void close_all(const std::vector<MYSQL*>& connections);
+
+    POOLED_CONNECTION_RESET reset;
+    POOLED_CONNECTION_CHECK validate;
+    POOLED_CONNECTION_CLOSER close;
+
+    // Idle connections by key, the most recently returned last
+    std::unordered_map<std::string, std::deque<IDLE_CONNECTION>> idle_connections;
+    std::map<std::string, uint64_t> cluster_generations;
+    std::mutex mutex_;
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private/protected methods
+    friend class TEST_UTILS;
+#endif
+};
+
+// Hands a pooled connection to a proxy chain through CONNECTION_PROXY::set_connection()
+class POOLED_CONNECTION_PROXY : public CONNECTION_PROXY {
+public:
+    explicit POOLED_CONNECTION_PROXY(MYSQL* mysql) : mysql{mysql} {}
+    ~POOLED_CONNECTION_PROXY() override;
+
+    MYSQL* move_mysql_connection() override;
+
+private:
+    MYSQL* mysql = nullptr;
+};
+
+#endif /* __CONNECTIONPOOL_H__ */
@@ -194,6 +194,10 @@ int CONNECTION_PROXY::ping() {
     return next_proxy->ping();
 }
 
+net_async_status CONNECTION_PROXY::ping_nonblocking() {
+    return next_proxy->ping_nonblocking();
+}
+
 unsigned long CONNECTION_PROXY::get_client_version(void) {
     return mysql_get_client_version();
 }
@@ -411,6 +415,10 @@ void CONNECTION_PROXY::close_socket() {
     next_proxy->close_socket();
 }
 
+bool CONNECTION_PROXY::is_node_unhealthy() {
+    return next_proxy->is_node_unhealthy();
+}
+
 void CONNECTION_PROXY::set_next_proxy(CONNECTION_PROXY* next_proxy) {
     if (this->next_proxy) {
         throw std::runtime_error("There is already a next proxy present!");
@@ -423,6 +431,13 @@ MYSQL* CONNECTION_PROXY::move_mysql_connection() {
     return next_proxy ? next_proxy->move_mysql_connection() : nullptr;
 }
 
+void CONNECTION_PROXY::set_dbc(DBC* dbc) {
+    this->dbc = dbc;
+    if (next_proxy) {
+        next_proxy->set_dbc(dbc);
+    }
+}
+
 void CONNECTION_PROXY::set_custom_error_message(const char* error_message) {
     this->custom_error_message = error_message;
     has_custom_error_message = true;
@@ -79,6 +79,7 @@ public:
     virtual void get_character_set_info(MY_CHARSET_INFO* charset);
 
     virtual int ping();
+    virtual net_async_status ping_nonblocking();
     static unsigned long get_client_version(void);
     virtual int options(enum mysql_option option, const void* arg);
     virtual int options4(enum mysql_option option, const void* arg1,
@@ -171,10 +172,16 @@ public:
 
     virtual void close_socket();
 
+    // True if the node behind this connection is known to be down
+    virtual bool is_node_unhealthy();
+
     virtual void set_next_proxy(CONNECTION_PROXY* next_proxy);
 
     virtual MYSQL* move_mysql_connection();
 
+    // Makes the proxy chain report to another connection handle
+    void set_dbc(DBC* dbc);
+
     void set_custom_error_message(const char* error_message);
 
 protected:
@@ -183,6 +190,11 @@ protected:
     CONNECTION_PROXY* next_proxy = nullptr;
     bool has_custom_error_message = false;
     std::string custom_error_message = "";
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private/protected methods
+    friend class TEST_UTILS;
+#endif
 };
 
 #endif /* __CONNECTION_PROXY__ */
@@ -34,6 +34,7 @@
 */
 
 #include "driver.h"
+#include "aws_sdk_helper.h"
 #include <locale.h>
 
 std::string thousands_sep, decimal_point, default_locale;
@@ -148,6 +149,9 @@ void myodbc_end()
     my_thread_end_wait_time= 0;
 #endif
 
+    /* Initialized by the first connection that needed it */
+    AWS_SDK_HELPER::shutdown();
+
     mysql_library_end();
   }
 }
@@ -0,0 +1,163 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "dns_cache.h"
+
+#include <cstring>
+#include <memory>
+
+#if defined(__APPLE__) || defined(__linux__)
+    #include <arpa/inet.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <sys/types.h>
+#else
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+DNS_CACHE::DNS_CACHE(HOST_RESOLVER resolver, FAILOVER_EXECUTOR& executor)
+    : resolver{std::move(resolver)}, executor{executor} {}
+
+DNS_CACHE& DNS_CACHE::get_instance() {
+    // Never destroyed, like the executor running its refreshes
+    static DNS_CACHE* instance = new DNS_CACHE(resolve_host, FAILOVER_EXECUTOR::get_instance());
+    return *instance;
+}
+
+std::string DNS_CACHE::resolve(const std::string& host, std::chrono::milliseconds ttl) {
+    if (ttl.count() <= 0) {
+        return resolver(host);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    auto& entry = entries[host];
+
+    if (!entry.address.empty() && now < entry.expires) {
+        if (now >= entry.refresh_after && !entry.refreshing) {
+            entry.refreshing = true;
+            executor.submit([this, host, ttl](int id) { refresh(host, ttl); });
+        }
+        return entry.address;
+    }
+
+    // Another caller is resolving the name already
+    if (entry.pending.valid()) {
+        auto pending = entry.pending;
+        lock.unlock();
+        return pending.get();
+    }
+
+    auto promise = std::make_shared<std::promise<std::string>>();
+    entry.pending = promise->get_future().share();
+    lock.unlock();
+
+    const std::string address = resolver(host);
+
+    lock.lock();
+    auto& resolved_entry = entries[host];
+    resolved_entry.pending = std::shared_future<std::string>();
+    if (!address.empty()) {
+        store(resolved_entry, address, ttl);
+    } else if (!resolved_entry.refreshing) {
+        // Names that do not resolve are not cached
+        entries.erase(host);
+    }
+    lock.unlock();
+
+    promise->set_value(address);
+    return address;
+}
+
+void DNS_CACHE::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Keep the lookups in progress, their callers wait for them
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.pending.valid()) {
+            it->second.address.clear();
+            ++it;
+        } else {
+            it = entries.erase(it);
+        }
+    }
+}
+
+// Keeps the cached address if the name no longer resolves, until the entry expires
+void DNS_CACHE::refresh(const std::string& host, std::chrono::milliseconds ttl) {
+    const std::string address = resolver(host);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries.find(host);
+    if (it == entries.end()) {
+        return;
+    }
+    it->second.refreshing = false;
+    if (!address.empty()) {
+        store(it->second, address, ttl);
+    }
+}
+
+// Must be called with mutex_ held
+void DNS_CACHE::store(ENTRY& entry, const std::string& address, std::chrono::milliseconds ttl) {
+    const auto now = std::chrono::steady_clock::now();
+    entry.address = address;
+    entry.expires = now + ttl;
+    // Refresh once three quarters of the TTL have passed
+    entry.refresh_after = now + ttl * 3 / 4;
+}
+
+std::string DNS_CACHE::resolve_host(const std::string& host) {
+    int status;
+    struct addrinfo hints;
+    struct addrinfo* servinfo;
+    struct addrinfo* p;
+    char ipstr[INET_ADDRSTRLEN] = "";
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET; //IPv4
+    hints.ai_socktype = SOCK_STREAM;
+
+    if ((status = getaddrinfo(host.c_str(), NULL, &hints, &servinfo)) != 0) {
+        return "";
+    }
+
+    for (p = servinfo; p != NULL; p = p->ai_next) {
+        void* addr;
+
+        struct sockaddr_in* ipv4 = (struct sockaddr_in*)p->ai_addr;
+        addr = &(ipv4->sin_addr);
+        inet_ntop(p->ai_family, addr, ipstr, sizeof(ipstr));
+    }
+
+    freeaddrinfo(servinfo);
+    return std::string(ipstr);
+}
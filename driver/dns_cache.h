@@ -0,0 +1,88 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __DNSCACHE_H__
+#define __DNSCACHE_H__
+
+#include "failover_executor.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+
+typedef std::function<std::string(const std::string&)> HOST_RESOLVER;
+
+// Caches the IPv4 address host names resolve to, shared by all connections of the process.
+// Once most of its TTL has passed, an entry is refreshed in the background while the cached
+// address is still returned. Concurrent lookups of a name that is not cached share one resolution.
+class DNS_CACHE {
+public:
+    DNS_CACHE(HOST_RESOLVER resolver, FAILOVER_EXECUTOR& executor);
+    DNS_CACHE(DNS_CACHE const&) = delete;
+    DNS_CACHE& operator=(DNS_CACHE const&) = delete;
+
+    static DNS_CACHE& get_instance();
+
+    // Returns the address the host resolves to, empty if it does not resolve.
+    // A TTL of 0 resolves the host every time.
+    std::string resolve(const std::string& host, std::chrono::milliseconds ttl);
+    void clear();
+
+    // Resolves the host with getaddrinfo
+    static std::string resolve_host(const std::string& host);
+
+private:
+    struct ENTRY {
+        std::string address;
+        std::chrono::steady_clock::time_point refresh_after;
+        std::chrono::steady_clock::time_point expires;
+        bool refreshing = false;
+        // Set while the name is resolved for a caller and no address is cached
+        std::shared_future<std::string> pending;
+    };
+
+    void refresh(const std::string& host, std::chrono::milliseconds ttl);
+    void store(ENTRY& entry, const std::string& address, std::chrono::milliseconds ttl);
+
+    HOST_RESOLVER resolver;
+    FAILOVER_EXECUTOR& executor;
+    std::map<std::string, ENTRY> entries;
+    std::mutex mutex_;
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private/protected methods
+    friend class TEST_UTILS;
+#endif
+};
+
+#endif /* __DNSCACHE_H__ */
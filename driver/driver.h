@@ -37,7 +37,6 @@
 #define __DRIVER_H__
 
 #include <atomic>
-#include <ctpl_stl.h>
 
 #include "../MYODBC_MYSQL.h"
 #include "../MYODBC_CONF.h"
@@ -46,8 +45,10 @@
 #include "util/installer.h"
 
 #include "connection_handler.h"
+#include "connection_pool.h"
 #include "connection_proxy.h"
 #include "failover.h"
+#include "session_state.h"
 
 /* Disable _attribute__ on non-gcc compilers. */
 #if !defined(__attribute__) && !defined(__GNUC__)
@@ -567,7 +568,6 @@ struct	ENV
   std::list<DBC*> conn_list;
   MYERROR      error;
   std::mutex lock;
-  ctpl::thread_pool failover_thread_pool;
 
   ENV(SQLINTEGER ver) : odbc_ver(ver)
   {}
@@ -586,6 +586,7 @@ static std::atomic_ulong last_dbc_id{ 1 };
 struct DBC
 {
   ENV              *env;
+  bool             registered; /* In the connection list of env */
   CONNECTION_PROXY *connection_proxy;
   std::list<STMT*> stmt_list;
   std::list<DESC*> desc_list; // Explicit descriptors
@@ -621,6 +622,8 @@ struct DBC
   // Connection have been put to the pool
   int           need_to_wakeup = 0;
   bool               transaction_open = false;     // Flag to indicate whether we have a transaction open
+  SESSION_STATE      session_state;                // Variables set by the application, restored after failover
+  CONNECTION_POOL_TAG pool_tag;                    // Connection pool the connection is returned to on disconnect
   fido_callback_func fido_callback = nullptr;
 
   telemetry::Telemetry<DBC> telemetry;
@@ -628,7 +631,7 @@ struct DBC
   FAILOVER_HANDLER *fh = nullptr; /* Failover handler */
   std::shared_ptr<CONNECTION_HANDLER> connection_handler = nullptr;
 
-  DBC(ENV *p_env);
+  DBC(ENV *p_env, bool register_in_env = true);
   void free_explicit_descriptors();
   void free_connection_stmts();
   void add_desc(DESC* desc);
@@ -649,10 +652,12 @@ struct DBC
   }
 
   void close();
+  void release_to_pool();
   ~DBC();
 
-  void set_charset(std::string charset);
-  SQLRETURN set_charset_options(const char* charset);
+  SQLRETURN set_charset_options(const char* charset,
+    const std::vector<std::string> &session_settings = {});
+  SQLRETURN init_session(DataSource *dsrc);
   SQLRETURN set_error(myodbc_errid errid, const char* errtext,
     SQLINTEGER errcode);
   SQLRETURN execute_query(const char *query,
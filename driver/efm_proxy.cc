@@ -31,6 +31,55 @@
 
 namespace {
     const char* RETRIEVE_HOST_PORT_SQL = "SELECT CONCAT(@@hostname, ':', @@port)";
+
+    // Indexed by PROXY_CALL
+    const NETWORK_ACTIVITY CALL_NETWORK_ACTIVITY[] = {
+        NETWORK_ACTIVITY::NETWORK,          // SET_CHARACTER_SET
+        NETWORK_ACTIVITY::NETWORK,          // CHANGE_USER
+        NETWORK_ACTIVITY::NETWORK,          // SELECT_DB
+        NETWORK_ACTIVITY::NETWORK,          // QUERY
+        NETWORK_ACTIVITY::NETWORK,          // REAL_QUERY
+        NETWORK_ACTIVITY::NETWORK,          // STORE_RESULT
+        NETWORK_ACTIVITY::LOCAL,            // USE_RESULT
+        NETWORK_ACTIVITY::RESULT_DEPENDENT, // FREE_RESULT
+        NETWORK_ACTIVITY::RESULT_DEPENDENT, // FETCH_ROW
+        NETWORK_ACTIVITY::LOCAL,            // REAL_ESCAPE_STRING
+        NETWORK_ACTIVITY::LOCAL,            // BIND_PARAM
+        NETWORK_ACTIVITY::LOCAL,            // STMT_INIT
+        NETWORK_ACTIVITY::NETWORK,          // STMT_PREPARE
+        NETWORK_ACTIVITY::NETWORK,          // STMT_EXECUTE
+        NETWORK_ACTIVITY::RESULT_DEPENDENT, // STMT_FETCH
+        NETWORK_ACTIVITY::LOCAL,            // STMT_FETCH_COLUMN
+        NETWORK_ACTIVITY::NETWORK,          // STMT_STORE_RESULT
+        NETWORK_ACTIVITY::LOCAL,            // STMT_BIND_NAMED_PARAM
+        NETWORK_ACTIVITY::LOCAL,            // STMT_BIND_PARAM
+        NETWORK_ACTIVITY::LOCAL,            // STMT_BIND_RESULT
+        NETWORK_ACTIVITY::NETWORK,          // STMT_CLOSE
+        NETWORK_ACTIVITY::NETWORK,          // STMT_RESET
+        NETWORK_ACTIVITY::NETWORK,          // STMT_FREE_RESULT
+        NETWORK_ACTIVITY::NETWORK,          // STMT_SEND_LONG_DATA
+        NETWORK_ACTIVITY::LOCAL,            // STMT_RESULT_METADATA
+        NETWORK_ACTIVITY::NETWORK,          // NEXT_RESULT
+        NETWORK_ACTIVITY::LOCAL,            // MORE_RESULTS
+        NETWORK_ACTIVITY::NETWORK           // STMT_NEXT_RESULT
+    };
+
+    static_assert(sizeof(CALL_NETWORK_ACTIVITY) / sizeof(CALL_NETWORK_ACTIVITY[0]) == static_cast<size_t>(PROXY_CALL::COUNT),
+                  "CALL_NETWORK_ACTIVITY must classify every PROXY_CALL");
+
+    // Rows of a result produced by mysql_use_result() are read from the socket
+    // on demand, while mysql_store_result() buffers them all up front.
+    bool is_unbuffered(const MYSQL_RES* result) {
+        return result != nullptr && result->data == nullptr && !result->eof;
+    }
+
+    bool is_unbuffered(const MYSQL_STMT* stmt) {
+        return stmt != nullptr && stmt->result.data == nullptr;
+    }
+}
+
+NETWORK_ACTIVITY EFM_PROXY::get_network_activity(PROXY_CALL call) {
+    return CALL_NETWORK_ACTIVITY[static_cast<size_t>(call)];
 }
 
 EFM_PROXY::EFM_PROXY(DBC* dbc, DataSource* ds) : EFM_PROXY(
@@ -47,60 +96,128 @@ EFM_PROXY::EFM_PROXY(DBC* dbc, DataSource* ds, CONNECTION_PROXY* next_proxy,
     this->next_proxy = next_proxy;
 }
 
-std::shared_ptr<MONITOR_CONNECTION_CONTEXT> EFM_PROXY::start_monitoring() {
+EFM_PROXY::~EFM_PROXY() {
+    release_monitoring_context();
+}
+
+MONITOR_CONNECTION_CONTEXT* EFM_PROXY::start_monitoring(PROXY_CALL call, bool unbuffered_result) {
     if (!ds || !ds->opt_ENABLE_FAILURE_DETECTION) {
         return nullptr;
     }
 
+    // Calls that cannot block on the socket do not need the monitor
+    const NETWORK_ACTIVITY activity = get_network_activity(call);
+    if (activity == NETWORK_ACTIVITY::LOCAL ||
+        (activity == NETWORK_ACTIVITY::RESULT_DEPENDENT && !unbuffered_result)) {
+        return nullptr;
+    }
+
+    // Fast path: the context is still registered with its monitor, so re-arming
+    // it needs neither allocations nor monitor lookups.
+    if (monitoring_context && monitoring_context->is_registered()) {
+        monitoring_context->arm(std::chrono::steady_clock::now());
+        return monitoring_context.get();
+    }
+
     auto failure_detection_timeout = ds->opt_FAILURE_DETECTION_TIMEOUT;
     // Use network timeout defined if failure detection timeout is not set
     if (failure_detection_timeout == 0) {
         failure_detection_timeout = ds->opt_NETWORK_TIMEOUT == 0 ? failure_detection_timeout_default : ds->opt_NETWORK_TIMEOUT;
     }
 
-    return monitor_service->start_monitoring(
+    if (!monitoring_host) {
+        monitoring_host = std::make_shared<HOST_INFO>(get_host(), get_port());
+    }
+
+    monitoring_context = monitor_service->start_monitoring(
         dbc,
         ds,
         node_keys,
-        std::make_shared<HOST_INFO>(get_host(), get_port()),
+        monitoring_host,
         std::chrono::milliseconds{ds->opt_FAILURE_DETECTION_TIME},
         std::chrono::seconds{failure_detection_timeout},
         std::chrono::milliseconds{ds->opt_FAILURE_DETECTION_INTERVAL},
         ds->opt_FAILURE_DETECTION_COUNT,
         std::chrono::milliseconds{ds->opt_MONITOR_DISPOSAL_TIME});
+
+    return monitoring_context.get();
 }
 
-void EFM_PROXY::stop_monitoring(std::shared_ptr<MONITOR_CONNECTION_CONTEXT> context) {
-    if (!ds || !ds->opt_ENABLE_FAILURE_DETECTION || context == nullptr) {
+void EFM_PROXY::stop_monitoring(MONITOR_CONNECTION_CONTEXT* context) {
+    if (context == nullptr) {
         return;
     }
-    monitor_service->stop_monitoring(context);
+    context->invalidate();
     if (context->is_node_unhealthy() && is_connected()) {
+        // The instance may be replaced before it is reachable again
+        SERVER_INFO_CACHE::get_instance().invalidate(get_host(), get_port());
         close_socket();
     }
 }
 
+void EFM_PROXY::release_monitoring_context() {
+    if (monitoring_context == nullptr) {
+        return;
+    }
+    if (monitor_service != nullptr) {
+        monitor_service->stop_monitoring(monitoring_context);
+    }
+    monitoring_context = nullptr;
+}
+
 void EFM_PROXY::generate_node_keys() {
+    release_monitoring_context();
     node_keys.clear();
-    node_keys.insert(std::string(get_host()) + ":" + std::to_string(get_port()));
+    const std::string host = get_host();
+    const unsigned int port = get_port();
+    node_keys.insert(host + ":" + std::to_string(port));
+    monitoring_host = std::make_shared<HOST_INFO>(host, port);
 
     if (is_connected()) {
-        // Temporarily turn off failure detection if on
-        const auto failure_detection_old_state = ds->opt_ENABLE_FAILURE_DETECTION;
-        ds->opt_ENABLE_FAILURE_DETECTION = false;
-
-        const auto error = query(RETRIEVE_HOST_PORT_SQL);
-        if (error == 0) {
-            MYSQL_RES* result = store_result();
-            MYSQL_ROW row;
-            while ((row = fetch_row(result))) {
-                node_keys.insert(std::string(row[0]));
+        auto& server_info_cache = SERVER_INFO_CACHE::get_instance();
+        SERVER_INFO server_info;
+        const bool cacheable = SERVER_INFO_CACHE::is_cacheable(host);
+        if (cacheable) {
+            const char* server_version = get_server_version();
+            server_info.server_version = server_version ? server_version : "";
+        }
+
+        if (!cacheable || !server_info_cache.get(host, port, server_info.server_version, server_info)) {
+            // Temporarily turn off failure detection if on
+            const auto failure_detection_old_state = ds->opt_ENABLE_FAILURE_DETECTION;
+            ds->opt_ENABLE_FAILURE_DETECTION = false;
+
+            const auto error = query(RETRIEVE_HOST_PORT_SQL);
+            if (error == 0) {
+                MYSQL_RES* result = store_result();
+                MYSQL_ROW row;
+                while ((row = fetch_row(result))) {
+                    server_info.node_keys.insert(std::string(row[0]));
+                }
+                free_result(result);
+                server_info_cache.put(host, port, server_info);
             }
-            free_result(result);
+
+            ds->opt_ENABLE_FAILURE_DETECTION = failure_detection_old_state;
         }
 
-        ds->opt_ENABLE_FAILURE_DETECTION = failure_detection_old_state;
+        node_keys.insert(server_info.node_keys.begin(), server_info.node_keys.end());
+    }
+
+    node_health.clear();
+    const auto node_health_table = NODE_HEALTH_TABLE::get_instance();
+    for (const auto& node_key : node_keys) {
+        node_health.push_back(node_health_table->get_entry(node_key));
+    }
+}
+
+bool EFM_PROXY::is_node_unhealthy() {
+    for (const auto& entry : node_health) {
+        if (entry->load()) {
+            return true;
+        }
     }
+    return next_proxy->is_node_unhealthy();
 }
 
 void EFM_PROXY::set_next_proxy(CONNECTION_PROXY* next_proxy) {
@@ -111,6 +228,7 @@ void EFM_PROXY::set_next_proxy(CONNECTION_PROXY* next_proxy) {
 void EFM_PROXY::set_connection(CONNECTION_PROXY* connection_proxy) {
     CONNECTION_PROXY::set_connection(connection_proxy);
 
+    release_monitoring_context();
     if (monitor_service != nullptr && !node_keys.empty()) {
         monitor_service->stop_monitoring_for_all_connections(node_keys);
     }
@@ -119,14 +237,14 @@ void EFM_PROXY::set_connection(CONNECTION_PROXY* connection_proxy) {
 }
 
 int EFM_PROXY::set_character_set(const char* csname) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::SET_CHARACTER_SET);
     const int ret = next_proxy->set_character_set(csname);
     stop_monitoring(context);
     return ret;
 }
 
 bool EFM_PROXY::change_user(const char* user, const char* passwd, const char* db) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::CHANGE_USER);
     const bool ret = next_proxy->change_user(user, passwd, db);
     stop_monitoring(context);
     return ret;
@@ -145,56 +263,56 @@ bool EFM_PROXY::real_connect(
 }
 
 int EFM_PROXY::select_db(const char* db) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::SELECT_DB);
     const int ret = next_proxy->select_db(db);
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::query(const char* q) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::QUERY);
     const int ret = next_proxy->query(q);
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::real_query(const char* q, unsigned long length) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::REAL_QUERY);
     const int ret = next_proxy->real_query(q, length);
     stop_monitoring(context);
     return ret;
 }
 
 MYSQL_RES* EFM_PROXY::store_result() {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STORE_RESULT);
     MYSQL_RES* ret = next_proxy->store_result();
     stop_monitoring(context);
     return ret;
 }
 
 MYSQL_RES* EFM_PROXY::use_result() {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::USE_RESULT);
     MYSQL_RES* ret = next_proxy->use_result();
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::next_result() {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::NEXT_RESULT);
     const int ret = next_proxy->next_result();
     stop_monitoring(context);
     return ret;
 }
 
 bool EFM_PROXY::more_results() {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::MORE_RESULTS);
     const bool ret = next_proxy->more_results();
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::stmt_next_result(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_NEXT_RESULT);
     const int ret = next_proxy->stmt_next_result(stmt);
     stop_monitoring(context);
     return ret;
@@ -212,69 +330,69 @@ bool EFM_PROXY::real_connect_dns_srv(
 }
 
 void EFM_PROXY::free_result(MYSQL_RES* result) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::FREE_RESULT, is_unbuffered(result));
     next_proxy->free_result(result);
     stop_monitoring(context);
 }
 
 MYSQL_ROW EFM_PROXY::fetch_row(MYSQL_RES* result) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::FETCH_ROW, is_unbuffered(result));
     const MYSQL_ROW ret = next_proxy->fetch_row(result);
     stop_monitoring(context);
     return ret;
 }
 
 unsigned long EFM_PROXY::real_escape_string(char* to, const char* from, unsigned long length) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::REAL_ESCAPE_STRING);
     const unsigned long ret = next_proxy->real_escape_string(to, from, length);
     stop_monitoring(context);
     return ret;
 }
 
 bool EFM_PROXY::bind_param(unsigned n_params, MYSQL_BIND* binds, const char** names) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::BIND_PARAM);
     const bool ret = next_proxy->bind_param(n_params, binds, names);
     stop_monitoring(context);
     return ret;
 }
 
 MYSQL_STMT* EFM_PROXY::stmt_init() {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_INIT);
     MYSQL_STMT* ret = next_proxy->stmt_init();
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::stmt_prepare(MYSQL_STMT* stmt, const char* query, unsigned long length) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_PREPARE);
     const int ret = next_proxy->stmt_prepare(stmt, query, length);
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::stmt_execute(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_EXECUTE);
     const int ret = next_proxy->stmt_execute(stmt);
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::stmt_fetch(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_FETCH, is_unbuffered(stmt));
     const int ret = next_proxy->stmt_fetch(stmt);
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::stmt_fetch_column(MYSQL_STMT* stmt, MYSQL_BIND* bind_arg, unsigned int column, unsigned long offset) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_FETCH_COLUMN);
     const int ret = next_proxy->stmt_fetch_column(stmt, bind_arg, column, offset);
     stop_monitoring(context);
     return ret;
 }
 
 int EFM_PROXY::stmt_store_result(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_STORE_RESULT);
     const int ret = next_proxy->stmt_store_result(stmt);
     stop_monitoring(context);
     return ret;
@@ -282,7 +400,7 @@ int EFM_PROXY::stmt_store_result(MYSQL_STMT* stmt) {
 
 bool EFM_PROXY::stmt_bind_named_param(MYSQL_STMT *stmt, MYSQL_BIND *binds,
                                       unsigned n_params, const char **names) {
-  const auto context = start_monitoring();
+  const auto context = start_monitoring(PROXY_CALL::STMT_BIND_NAMED_PARAM);
   const bool ret =
       next_proxy->stmt_bind_named_param(stmt, binds, n_params, names);
   stop_monitoring(context);
@@ -290,35 +408,35 @@ bool EFM_PROXY::stmt_bind_named_param(MYSQL_STMT *stmt, MYSQL_BIND *binds,
 }
 
 bool EFM_PROXY::stmt_bind_param(MYSQL_STMT* stmt, MYSQL_BIND* bnd) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_BIND_PARAM);
     const bool ret = next_proxy->stmt_bind_param(stmt, bnd);
     stop_monitoring(context);
     return ret;
 }
 
 bool EFM_PROXY::stmt_bind_result(MYSQL_STMT* stmt, MYSQL_BIND* bnd) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_BIND_RESULT);
     const bool ret = next_proxy->stmt_bind_result(stmt, bnd);
     stop_monitoring(context);
     return ret;
 }
 
 bool EFM_PROXY::stmt_close(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_CLOSE);
     const bool ret = next_proxy->stmt_close(stmt);
     stop_monitoring(context);
     return ret;
 }
 
 bool EFM_PROXY::stmt_reset(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_RESET);
     const bool ret = next_proxy->stmt_reset(stmt);
     stop_monitoring(context);
     return ret;
 }
 
 bool EFM_PROXY::stmt_free_result(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_FREE_RESULT);
     const bool ret = next_proxy->stmt_free_result(stmt);
     stop_monitoring(context);
     return ret;
@@ -326,14 +444,14 @@ bool EFM_PROXY::stmt_free_result(MYSQL_STMT* stmt) {
 
 bool EFM_PROXY::stmt_send_long_data(MYSQL_STMT* stmt, unsigned int param_number, const char* data,
                                     unsigned long length) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_SEND_LONG_DATA);
     const bool ret = next_proxy->stmt_send_long_data(stmt, param_number, data, length);
     stop_monitoring(context);
     return ret;
 }
 
 MYSQL_RES* EFM_PROXY::stmt_result_metadata(MYSQL_STMT* stmt) {
-    const auto context = start_monitoring();
+    const auto context = start_monitoring(PROXY_CALL::STMT_RESULT_METADATA);
     MYSQL_RES* ret = next_proxy->stmt_result_metadata(stmt);
     stop_monitoring(context);
     return ret;
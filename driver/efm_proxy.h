@@ -33,12 +33,54 @@
 #include "connection_proxy.h"
 #include "driver.h"
 #include "monitor_service.h"
+#include "node_health_table.h"
+#include "server_info_cache.h"
+
+#include <vector>
+
+// Calls forwarded by EFM_PROXY that may need to be monitored.
+enum class PROXY_CALL {
+    SET_CHARACTER_SET,
+    CHANGE_USER,
+    SELECT_DB,
+    QUERY,
+    REAL_QUERY,
+    STORE_RESULT,
+    USE_RESULT,
+    FREE_RESULT,
+    FETCH_ROW,
+    REAL_ESCAPE_STRING,
+    BIND_PARAM,
+    STMT_INIT,
+    STMT_PREPARE,
+    STMT_EXECUTE,
+    STMT_FETCH,
+    STMT_FETCH_COLUMN,
+    STMT_STORE_RESULT,
+    STMT_BIND_NAMED_PARAM,
+    STMT_BIND_PARAM,
+    STMT_BIND_RESULT,
+    STMT_CLOSE,
+    STMT_RESET,
+    STMT_FREE_RESULT,
+    STMT_SEND_LONG_DATA,
+    STMT_RESULT_METADATA,
+    NEXT_RESULT,
+    MORE_RESULTS,
+    STMT_NEXT_RESULT,
+    COUNT
+};
+
+// Whether a call can block on the socket. RESULT_DEPENDENT calls only touch the
+// network when working on an unbuffered result set.
+enum class NETWORK_ACTIVITY { LOCAL, NETWORK, RESULT_DEPENDENT };
 
 class EFM_PROXY : public CONNECTION_PROXY {
 public:
     EFM_PROXY(DBC* dbc, DataSource* ds);
     EFM_PROXY(DBC* dbc, DataSource* ds, CONNECTION_PROXY* next_proxy);
     EFM_PROXY(DBC* dbc, DataSource* ds, CONNECTION_PROXY* next_proxy, std::shared_ptr<MONITOR_SERVICE> monitor_service);
+    ~EFM_PROXY() override;
 
     int set_character_set(const char* csname) override;
     bool change_user(const char* user, const char* passwd,
@@ -85,13 +127,22 @@ public:
 
     void set_connection(CONNECTION_PROXY* connection_proxy) override;
     void set_next_proxy(CONNECTION_PROXY* next_proxy) override;
+    bool is_node_unhealthy() override;
+
+    static NETWORK_ACTIVITY get_network_activity(PROXY_CALL call);
 
 private:
     std::shared_ptr<MONITOR_SERVICE> monitor_service = nullptr;
     std::set<std::string> node_keys;
+    std::shared_ptr<HOST_INFO> monitoring_host;
+    // Entries of the node health table for node_keys, checked before every query
+    std::vector<NODE_HEALTH_ENTRY> node_health;
+    // Registered with the monitor once and re-armed for every monitored call
+    std::shared_ptr<MONITOR_CONNECTION_CONTEXT> monitoring_context;
 
-    std::shared_ptr<MONITOR_CONNECTION_CONTEXT> start_monitoring();
-    void stop_monitoring(std::shared_ptr<MONITOR_CONNECTION_CONTEXT> context);
+    MONITOR_CONNECTION_CONTEXT* start_monitoring(PROXY_CALL call, bool unbuffered_result = true);
+    void stop_monitoring(MONITOR_CONNECTION_CONTEXT* context);
+    void release_monitoring_context();
     void generate_node_keys();
 };
 
@@ -84,6 +84,13 @@ SQLRETURN do_query(STMT *stmt, std::string query)
     MYLOG_STMT_TRACE(stmt, query.c_str());
     DO_LOCK_STMT();
 
+    if (stmt->dbc->connection_proxy->is_node_unhealthy())
+    {
+      /* Fail fast, or fail over below, instead of waiting for a network timeout */
+      stmt->set_error("08S01", "The server is known to be unavailable.", 0);
+      goto exit;
+    }
+
     if ( !is_server_alive( stmt->dbc ) )
     {
       stmt->set_error("08S01" /* "HYT00" */,
@@ -181,6 +188,11 @@ SQLRETURN do_query(STMT *stmt, std::string query)
         goto exit;
       }
       MYLOG_STMT_TRACE(stmt, "ssps has been executed");
+
+      // The values bound to parameters are not known as text, so SET statements with
+      // parameters cannot be replayed after failover
+      if (!native_error && stmt->param_count == 0)
+        stmt->dbc->session_state.track_statement(query);
     }
     else
     {
@@ -199,6 +211,14 @@ SQLRETURN do_query(STMT *stmt, std::string query)
       if (SQL_SUCCEEDED(rc))
       {
           const std::vector<std::string> statements = parse_query_into_statements(query.c_str());
+          std::string used_database;
+          for (const auto& statement : statements)
+          {
+              if (SESSION_STATE::get_used_database(statement, used_database))
+                  stmt->dbc->database = used_database;
+              else
+                  stmt->dbc->session_state.track_statement(statement);
+          }
           for (int i = statements.size() - 1; i >= 0; i--)
           {
               std::string statement = statements[i];
@@ -32,10 +32,15 @@
 
 #include "connection_handler.h"
 #include "connection_proxy.h"
+#include "failover_executor.h"
+#include "reader_selector.h"
+#include "reader_standby_pool.h"
+#include "topology_refresher.h"
 #include "topology_service.h"
 #include "mylog.h"
 
 #include <condition_variable>
+#include <functional>
 
 struct READER_FAILOVER_RESULT {
     bool connected = false;
@@ -52,14 +57,21 @@ struct READER_FAILOVER_RESULT {
           new_connection{new_connection} {}
 };
 
-// FAILOVER_SYNC enables synchronization between threads
-class FAILOVER_SYNC {
+// FAILOVER_SYNC enables synchronization between threads. Completing the process
+// cancels the tasks that are still working on it.
+class FAILOVER_SYNC : public CANCELLATION_TOKEN {
    public:
     FAILOVER_SYNC(int num_tasks);
     void increment_task();
     void mark_as_complete(bool cancel_other_tasks);
     void wait_and_complete(int milliseconds);
+    // Publishes a task's result and completes the process, unless it has already completed
+    bool complete_with(const std::function<void()>& publish_result);
+    // Waits until the process completes or the timeout elapses, returns whether it completed
+    bool wait_for_completion(int milliseconds);
     virtual bool is_completed();
+    bool is_cancelled() override;
+    bool wait_for_cancellation(int milliseconds) override;
 
    private:
     int num_tasks;
@@ -72,15 +84,24 @@ class FAILOVER_READER_HANDLER {
     FAILOVER_READER_HANDLER(
         std::shared_ptr<TOPOLOGY_SERVICE> topology_service,
         std::shared_ptr<CONNECTION_HANDLER> connection_handler,
-        ctpl::thread_pool& thread_pool,
+        FAILOVER_EXECUTOR& executor,
         int failover_timeout_ms, int failover_reader_connect_timeout,
         bool enable_strict_reader_failover,
-        unsigned long dbc_id, bool enable_logging = false);
+        unsigned long dbc_id, bool enable_logging = false,
+        READER_SELECTOR reader_selector = READER_SELECTOR(),
+        int reader_fanout = 2,
+        int reader_stagger_delay_ms = 0);
     
         ~FAILOVER_READER_HANDLER();
     
+        // No standby connection to the host the connection was on is taken over
         std::shared_ptr<READER_FAILOVER_RESULT> failover(
-            std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info);
+            std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info,
+            std::shared_ptr<HOST_INFO> current_host = nullptr);
+
+        // Connections of the pool are handed over to the given handle by failover before
+        // connecting to any host
+        void set_standby_pool(std::shared_ptr<READER_STANDBY_POOL> standby_pool, DBC* dbc);
     
         virtual std::shared_ptr<READER_FAILOVER_RESULT> get_reader_connection(
             std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info,
@@ -97,15 +118,22 @@ class FAILOVER_READER_HANDLER {
     protected:
         int reader_connect_timeout_ms = 30000;   // 30 sec
         int max_failover_timeout_ms = 60000;  // 60 sec
+        // Number of hosts connected to in parallel, each attempt starting
+        // reader_stagger_delay_ms after the previous one
+        int reader_fanout = 2;
+        int reader_stagger_delay_ms = 0;
 
     private:
         std::shared_ptr<TOPOLOGY_SERVICE> topology_service;
         std::shared_ptr<CONNECTION_HANDLER> connection_handler; 
         const int READER_CONNECT_INTERVAL_SEC = 1;  // 1 sec
         bool enable_strict_reader_failover = false;
+        READER_SELECTOR reader_selector;
+        std::shared_ptr<READER_STANDBY_POOL> standby_pool;
+        DBC* standby_dbc = nullptr;
         std::shared_ptr<FILE> logger = nullptr;
         unsigned long dbc_id = 0;
-        ctpl::thread_pool& thread_pool;
+        FAILOVER_EXECUTOR& executor;
 };
 
 // This struct holds results of Writer Failover Process.
@@ -137,7 +165,7 @@ class FAILOVER_WRITER_HANDLER {
         std::shared_ptr<TOPOLOGY_SERVICE> topology_service,
         std::shared_ptr<FAILOVER_READER_HANDLER> reader_handler,
         std::shared_ptr<CONNECTION_HANDLER> connection_handler,
-        ctpl::thread_pool& thread_pool,
+        FAILOVER_EXECUTOR& executor,
         int writer_failover_timeout_ms, int read_topology_interval_ms,
         int reconnect_writer_interval_ms, unsigned long dbc_id, bool enable_logging = false);
     ~FAILOVER_WRITER_HANDLER();
@@ -155,7 +183,7 @@ class FAILOVER_WRITER_HANDLER {
     std::shared_ptr<FAILOVER_READER_HANDLER> reader_handler;
     std::shared_ptr<FILE> logger = nullptr;
     unsigned long dbc_id = 0;
-    ctpl::thread_pool& thread_pool;
+    FAILOVER_EXECUTOR& executor;
 };
 
 class FAILOVER_HANDLER {
@@ -180,6 +208,8 @@ class FAILOVER_HANDLER {
     DBC* dbc = nullptr;
     DataSource* ds = nullptr;
     std::shared_ptr<TOPOLOGY_SERVICE> topology_service;
+    std::shared_ptr<TOPOLOGY_REFRESHER> topology_refresher;
+    std::shared_ptr<READER_STANDBY_POOL> standby_pool;
     std::shared_ptr<FAILOVER_READER_HANDLER> failover_reader_handler;
     std::shared_ptr<FAILOVER_WRITER_HANDLER> failover_writer_handler;
     std::shared_ptr<CLUSTER_TOPOLOGY_INFO> current_topology;
@@ -195,6 +225,8 @@ class FAILOVER_HANDLER {
     void init_cluster_info();
     bool should_connect_to_new_writer();
     void initialize_topology();
+    void start_topology_refresher();
+    void start_standby_pool();
     bool is_read_only();
     virtual std::string host_to_IP(std::string host);
     SQLRETURN reconnect(bool failover_enabled);
@@ -240,7 +272,6 @@ class FAILOVER {
 
    protected:
     bool connect(std::shared_ptr<HOST_INFO> host_info);
-    void sleep(int miliseconds);
     void release_new_connection();
     std::shared_ptr<CONNECTION_HANDLER> connection_handler;
     std::shared_ptr<TOPOLOGY_SERVICE> topology_service;
@@ -254,7 +285,7 @@ public:
     CONNECT_TO_READER_HANDLER(
         std::shared_ptr<CONNECTION_HANDLER> connection_handler,
      std::shared_ptr<TOPOLOGY_SERVICE> topology_service,
-     unsigned long dbc_id, bool enable_logging = false);
+     int start_delay_ms, unsigned long dbc_id, bool enable_logging = false);
     ~CONNECT_TO_READER_HANDLER();
 
     void operator()(
@@ -262,6 +293,10 @@ public:
         std::shared_ptr<HOST_INFO> reader,
         std::shared_ptr<FAILOVER_SYNC> f_sync,
         std::shared_ptr<READER_FAILOVER_RESULT> result);
+
+   private:
+    // Delay before connecting, the attempt is cancelled if another one connects in the meantime
+    int start_delay_ms;
 };
 
 class RECONNECT_TO_WRITER_HANDLER : public FAILOVER {
@@ -0,0 +1,278 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "failover_executor.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // Threads running tasks at a time, unless blocked, and threads in total of the shared executor.
+    // Tasks mostly wait for the network while connecting, so this does not depend on the number of cores.
+    const size_t FAILOVER_PARALLELISM = 64;
+    const size_t MAX_FAILOVER_THREADS = 256;
+    // How long a thread waits for a task before exiting
+    const std::chrono::seconds idle_thread_timeout(60);
+
+    thread_local FAILOVER_EXECUTOR* current_executor = nullptr;
+    thread_local size_t current_slot = 0;
+    thread_local int blocking_depth = 0;
+}
+
+FAILOVER_EXECUTOR::FAILOVER_EXECUTOR(size_t parallelism, size_t max_threads)
+    : parallelism{(std::max)(parallelism, static_cast<size_t>(1))},
+      max_threads{(std::max)(max_threads, (std::max)(parallelism, static_cast<size_t>(1)))} {
+
+    for (size_t i = 0; i < this->max_threads; i++) {
+        workers.push_back(std::make_unique<WORKER>());
+    }
+}
+
+FAILOVER_EXECUTOR::~FAILOVER_EXECUTOR() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopped = true;
+    work_cv.notify_all();
+
+    // Threads finish the queued tasks before exiting, those tasks may start more threads
+    while (true) {
+        std::thread thread;
+        for (const auto& worker : workers) {
+            if (worker->thread.joinable()) {
+                thread = std::move(worker->thread);
+                break;
+            }
+        }
+        if (!thread.joinable()) {
+            break;
+        }
+        lock.unlock();
+        thread.join();
+        lock.lock();
+    }
+}
+
+FAILOVER_EXECUTOR& FAILOVER_EXECUTOR::get_instance() {
+    // Never destroyed, tasks may still be running when static objects are destroyed at exit
+    static FAILOVER_EXECUTOR* instance = new FAILOVER_EXECUTOR(FAILOVER_PARALLELISM, MAX_FAILOVER_THREADS);
+    return *instance;
+}
+
+void FAILOVER_EXECUTOR::submit(std::function<void(int)> task, std::shared_ptr<CANCELLATION_TOKEN> token) {
+    if (token && token->is_cancelled()) {
+        cancelled_tasks++;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool from_task = current_executor == this;
+    // Tasks still finish what they started while the executor stops
+    if (stopped && !from_task) {
+        cancelled_tasks++;
+        return;
+    }
+
+    {
+        std::mutex& queue_mutex = from_task ? workers[current_slot]->mutex_ : shared_mutex_;
+        std::deque<TASK>& queue = from_task ? workers[current_slot]->tasks : shared_tasks;
+        std::lock_guard<std::mutex> queue_lock(queue_mutex);
+        queue.push_back(TASK{std::move(task), std::move(token)});
+    }
+    queued_tasks++;
+
+    if (queued_tasks > idle_threads) {
+        start_thread_if_needed();
+    }
+    work_cv.notify_one();
+}
+
+void FAILOVER_EXECUTOR::begin_blocking() {
+    FAILOVER_EXECUTOR* executor = current_executor;
+    if (!executor || blocking_depth++ > 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(executor->mutex_);
+    executor->blocked_threads++;
+    // The tasks the blocked one waits for may need another thread
+    if (executor->queued_tasks > executor->idle_threads) {
+        executor->start_thread_if_needed();
+    }
+}
+
+void FAILOVER_EXECUTOR::end_blocking() {
+    FAILOVER_EXECUTOR* executor = current_executor;
+    if (!executor || --blocking_depth > 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(executor->mutex_);
+    executor->blocked_threads--;
+}
+
+bool FAILOVER_EXECUTOR::run_submitted_task() {
+    FAILOVER_EXECUTOR* executor = current_executor;
+    if (!executor) {
+        return false;
+    }
+
+    const size_t slot = current_slot;
+    TASK task;
+    {
+        WORKER& worker = *executor->workers[slot];
+        std::lock_guard<std::mutex> lock(worker.mutex_);
+        if (worker.tasks.empty()) {
+            return false;
+        }
+        task = std::move(worker.tasks.front());
+        worker.tasks.pop_front();
+    }
+
+    executor->queued_tasks--;
+    executor->run_task(slot, task);
+    return true;
+}
+
+FAILOVER_EXECUTOR_METRICS FAILOVER_EXECUTOR::get_metrics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FAILOVER_EXECUTOR_METRICS metrics;
+    metrics.queue_depth = queued_tasks;
+    metrics.active_tasks = active_tasks;
+    metrics.threads = threads;
+    metrics.idle_threads = idle_threads;
+    metrics.blocked_threads = blocked_threads;
+    metrics.completed_tasks = completed_tasks;
+    metrics.cancelled_tasks = cancelled_tasks;
+    metrics.stolen_tasks = stolen_tasks;
+    return metrics;
+}
+
+// Must be called with mutex_ held
+void FAILOVER_EXECUTOR::start_thread_if_needed() {
+    if (threads >= max_threads || threads - blocked_threads >= parallelism) {
+        return;
+    }
+
+    for (size_t slot = 0; slot < workers.size(); slot++) {
+        auto& worker = workers[slot];
+        if (!worker->started) {
+            worker->started = true;
+            threads++;
+            worker->thread = std::thread(&FAILOVER_EXECUTOR::work, this, slot);
+            return;
+        }
+    }
+}
+
+// Takes the oldest task of the thread's own queue, then of the tasks submitted from
+// outside of the executor, then steals the oldest task of another thread
+bool FAILOVER_EXECUTOR::next_task(size_t slot, TASK& task) {
+    {
+        std::lock_guard<std::mutex> lock(workers[slot]->mutex_);
+        if (!workers[slot]->tasks.empty()) {
+            task = std::move(workers[slot]->tasks.front());
+            workers[slot]->tasks.pop_front();
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        if (!shared_tasks.empty()) {
+            task = std::move(shared_tasks.front());
+            shared_tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < workers.size(); i++) {
+        auto& victim = workers[(slot + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim->mutex_);
+        if (!victim->tasks.empty()) {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            stolen_tasks++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FAILOVER_EXECUTOR::work(size_t slot) {
+    current_executor = this;
+    current_slot = slot;
+
+    while (true) {
+        TASK task;
+        if (next_task(slot, task)) {
+            queued_tasks--;
+            run_task(slot, task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_threads++;
+        const bool has_tasks = work_cv.wait_for(lock, idle_thread_timeout,
+            [this] { return stopped || queued_tasks > 0; });
+        idle_threads--;
+
+        if (stopped) {
+            // Remaining tasks are taken by the threads still running
+            if (queued_tasks > 0) {
+                continue;
+            }
+            threads--;
+            return;
+        }
+        if (!has_tasks) {
+            // The slot is reused by the next thread started
+            workers[slot]->thread.detach();
+            workers[slot]->started = false;
+            threads--;
+            return;
+        }
+    }
+}
+
+void FAILOVER_EXECUTOR::run_task(size_t slot, TASK& task) {
+    if (task.token && task.token->is_cancelled()) {
+        cancelled_tasks++;
+        return;
+    }
+
+    active_tasks++;
+    try {
+        task.run(static_cast<int>(slot));
+    } catch (...) {
+        // A failing task must not take the thread, and the tasks queued on it, down
+    }
+    active_tasks--;
+    completed_tasks++;
+}
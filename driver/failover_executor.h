@@ -0,0 +1,149 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __FAILOVEREXECUTOR_H__
+#define __FAILOVEREXECUTOR_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tells a task that its result is no longer needed. Tasks check it between steps and
+// wait on it instead of sleeping, so they stop as soon as the failover they belong to is over.
+class CANCELLATION_TOKEN {
+public:
+    virtual ~CANCELLATION_TOKEN() = default;
+    virtual bool is_cancelled() = 0;
+    // Waits until cancelled or the timeout elapses, returns whether it was cancelled
+    virtual bool wait_for_cancellation(int milliseconds) = 0;
+};
+
+struct FAILOVER_EXECUTOR_METRICS {
+    size_t queue_depth = 0;       // Tasks waiting for a thread
+    size_t active_tasks = 0;      // Tasks running
+    size_t threads = 0;
+    size_t idle_threads = 0;
+    size_t blocked_threads = 0;   // Threads whose task waits for tasks it submitted
+    uint64_t completed_tasks = 0;
+    uint64_t cancelled_tasks = 0; // Tasks dropped without running, as their token was cancelled
+    uint64_t stolen_tasks = 0;    // Tasks run by a thread other than the one that submitted them
+};
+
+// Runs the failover tasks of all connections of the process on a bounded set of threads.
+// Every thread has its own queue, the tasks a task submits go to its thread's queue and idle
+// threads steal them. At most `parallelism` threads run tasks at a time, a thread whose task
+// waits for the tasks it submitted does not count, up to `max_threads` threads in total.
+// A waiting task also runs the tasks it submitted that no thread took yet, so they do not
+// starve when all threads are taken. Threads are started on demand and exit after being
+// idle for a while.
+class FAILOVER_EXECUTOR {
+public:
+    FAILOVER_EXECUTOR(size_t parallelism, size_t max_threads);
+    FAILOVER_EXECUTOR(FAILOVER_EXECUTOR const&) = delete;
+    FAILOVER_EXECUTOR& operator=(FAILOVER_EXECUTOR const&) = delete;
+    // Drops the queued tasks and waits for the running ones
+    ~FAILOVER_EXECUTOR();
+
+    // The executor shared by all connections of the process
+    static FAILOVER_EXECUTOR& get_instance();
+
+    // Queues a task, it gets the ID of the thread running it. The task is dropped
+    // without running if the token is cancelled before a thread picks it up.
+    void submit(std::function<void(int)> task, std::shared_ptr<CANCELLATION_TOKEN> token = nullptr);
+
+    // Called by tasks around waiting for the tasks they submitted, so that the wait
+    // does not hold back a thread those tasks need. No-op outside of a task.
+    static void begin_blocking();
+    static void end_blocking();
+    // Runs the oldest task the calling task submitted that is still queued, on the calling
+    // thread. Returns whether there was one. No-op outside of a task.
+    static bool run_submitted_task();
+
+    FAILOVER_EXECUTOR_METRICS get_metrics();
+
+private:
+    struct TASK {
+        std::function<void(int)> run;
+        std::shared_ptr<CANCELLATION_TOKEN> token;
+    };
+
+    struct WORKER {
+        std::mutex mutex_;
+        std::deque<TASK> tasks;
+        std::thread thread;
+        bool started = false;
+    };
+
+    void work(size_t slot);
+    bool next_task(size_t slot, TASK& task);
+    void run_task(size_t slot, TASK& task);
+    void start_thread_if_needed();
+
+    const size_t parallelism;
+    const size_t max_threads;
+
+    // Tasks submitted from outside of the executor's threads
+    std::mutex shared_mutex_;
+    std::deque<TASK> shared_tasks;
+    std::vector<std::unique_ptr<WORKER>> workers;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv;
+    bool stopped = false;
+    size_t threads = 0;
+    size_t idle_threads = 0;
+    size_t blocked_threads = 0;
+
+    std::atomic<size_t> queued_tasks{0};
+    std::atomic<size_t> active_tasks{0};
+    std::atomic<uint64_t> completed_tasks{0};
+    std::atomic<uint64_t> cancelled_tasks{0};
+    std::atomic<uint64_t> stolen_tasks{0};
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private/protected methods
+    friend class TEST_UTILS;
+#endif
+};
+
+// Marks the calling task as blocked for the lifetime of the object
+class FAILOVER_EXECUTOR_BLOCKING_SCOPE {
+public:
+    FAILOVER_EXECUTOR_BLOCKING_SCOPE() { FAILOVER_EXECUTOR::begin_blocking(); }
+    ~FAILOVER_EXECUTOR_BLOCKING_SCOPE() { FAILOVER_EXECUTOR::end_blocking(); }
+};
+
+#endif /* __FAILOVEREXECUTOR_H__ */
@@ -35,60 +35,13 @@
 #include <regex>
 #include <sstream>
 
+#include "dns_cache.h"
 #include "driver.h"
 #include "mylog.h"
-
-#if defined(__APPLE__) || defined(__linux__)
-    #include <arpa/inet.h>    
-    #include <netdb.h>
-    #include <netinet/in.h>
-    #include <sys/socket.h>
-    #include <sys/types.h>
-#endif
+#include "rds_dns_matcher.h"
+#include "server_info_cache.h"
 
 namespace {
-const std::regex AURORA_DNS_PATTERN(
-    R"#((.+)\.(proxy-|cluster-|cluster-ro-|cluster-custom-)?([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
-    std::regex_constants::icase);
-const std::regex AURORA_PROXY_DNS_PATTERN(
-    R"#((.+)\.(proxy-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-|cluster-ro-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
-    std::regex_constants::icase);
-const std::regex AURORA_WRITER_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
-    std::regex_constants::icase);
-const std::regex AURORA_READER_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-ro-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CUSTOM_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-custom-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CHINA_DNS_PATTERN(
-    R"#((.+)\.(proxy-|cluster-|cluster-ro-|cluster-custom-)?([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CHINA_PROXY_DNS_PATTERN(
-    R"#((.+)\.(proxy-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CHINA_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-|cluster-ro-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CHINA_WRITER_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CHINA_READER_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-ro-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
-    std::regex_constants::icase);
-const std::regex AURORA_CHINA_CUSTOM_CLUSTER_PATTERN(
-    R"#((.+)\.(cluster-custom-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
-    std::regex_constants::icase);
-const std::regex IPV4_PATTERN(
-    R"#(^(([1-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\.){1}(([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\.){2}([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])$)#");
-const std::regex IPV6_PATTERN(R"#(^[0-9a-fA-F]{1,4}(:[0-9a-fA-F]{1,4}){7}$)#");
-const std::regex IPV6_COMPRESSED_PATTERN(
-    R"#(^(([0-9A-Fa-f]{1,4}(:[0-9A-Fa-f]{1,4}){0,5})?)::(([0-9A-Fa-f]{1,4}(:[0-9A-Fa-f]{1,4}){0,5})?)$)#");
-
 const char* MYSQL_READONLY_QUERY = "SELECT @@innodb_read_only AS is_reader";
 }  // namespace
 
@@ -115,25 +68,44 @@ FAILOVER_HANDLER::FAILOVER_HANDLER(DBC* dbc, DataSource* ds,
     this->topology_service = topology_service;
     this->topology_service->set_refresh_rate(ds->opt_TOPOLOGY_REFRESH_RATE);
     this->topology_service->set_gather_metric(ds->opt_GATHER_PERF_METRICS);
+    const char* snapshot_dir = (const char*)ds->opt_TOPOLOGY_SNAPSHOT_DIR;
+    this->topology_service->set_topology_snapshot(snapshot_dir ? snapshot_dir : "", ds->opt_TOPOLOGY_SNAPSHOT_TTL);
     this->connection_handler = connection_handler;
 
     this->failover_reader_handler = std::make_shared<FAILOVER_READER_HANDLER>(
         this->topology_service, this->connection_handler,
-        dbc->env->failover_thread_pool, ds->opt_FAILOVER_TIMEOUT,
+        FAILOVER_EXECUTOR::get_instance(), ds->opt_FAILOVER_TIMEOUT,
         ds->opt_FAILOVER_READER_CONNECT_TIMEOUT,
         is_failover_mode(FAILOVER_MODE_STRICT_READER, ds), dbc->id,
-        ds->opt_LOG_QUERY);
+        ds->opt_LOG_QUERY,
+        READER_SELECTOR(READER_SELECTOR::get_strategy((const char*)ds->opt_READER_SELECTION_STRATEGY),
+                        ds->opt_MAX_REPLICA_LAG),
+        ds->opt_FAILOVER_READER_FANOUT, ds->opt_FAILOVER_READER_STAGGER_DELAY);
     this->failover_writer_handler = std::make_shared<FAILOVER_WRITER_HANDLER>(
         this->topology_service, this->failover_reader_handler,
-        this->connection_handler, dbc->env->failover_thread_pool,
+        this->connection_handler, FAILOVER_EXECUTOR::get_instance(),
         ds->opt_FAILOVER_TIMEOUT, ds->opt_FAILOVER_TOPOLOGY_REFRESH_RATE,
         ds->opt_FAILOVER_WRITER_RECONNECT_INTERVAL, dbc->id, ds->opt_LOG_QUERY);
     this->metrics_container = metrics_container;
 }
 
-FAILOVER_HANDLER::~FAILOVER_HANDLER() {}
+FAILOVER_HANDLER::~FAILOVER_HANDLER() {
+    if (standby_pool) {
+        standby_pool->detach(this);
+    }
+    if (topology_refresher) {
+        topology_refresher->detach(this);
+    }
+}
 
 SQLRETURN FAILOVER_HANDLER::init_connection() {
+    // The key is taken before connecting changes the server and failover options
+    dbc->pool_tag = CONNECTION_POOL_TAG();
+    if (ds->opt_ENABLE_CONNECTION_POOL) {
+        dbc->pool_tag.key = CONNECTION_POOL::get_key(ds);
+        dbc->pool_tag.database = ds->opt_DATABASE ? (const char*)ds->opt_DATABASE : "";
+    }
+
     SQLRETURN rc = connection_handler->do_connect(dbc, ds, false);
     if (SQL_SUCCEEDED(rc)) {
         metrics_container->register_invalid_initial_connection(false);
@@ -148,13 +120,17 @@ SQLRETURN FAILOVER_HANDLER::init_connection() {
         this->init_cluster_info();
 
         if (is_failover_enabled()) {
+            start_topology_refresher();
+
             // Since we can't determine whether failover should be enabled
             // before we connect, there is a possibility we need to reconnect
             // again with the correct connection settings for failover.
             const unsigned int connect_timeout = get_connect_timeout(ds->opt_CONNECT_TIMEOUT);
             const unsigned int network_timeout = get_network_timeout(ds->opt_NETWORK_TIMEOUT);
 
-            reconnect_with_updated_timeouts = (connect_timeout != dbc->login_timeout ||
+            // A pooled connection may already have been opened with them
+            reconnect_with_updated_timeouts = !dbc->pool_tag.failover_timeouts &&
+                                              (connect_timeout != dbc->login_timeout ||
                                                network_timeout != ds->opt_READTIMEOUT ||
                                                network_timeout != ds->opt_WRITETIMEOUT);
         }
@@ -166,12 +142,21 @@ SQLRETURN FAILOVER_HANDLER::init_connection() {
                 ds->opt_FAILOVER_MODE.set_remove_brackets((SQLWCHAR*)to_sqlwchar_string(FAILOVER_MODE_STRICT_WRITER).c_str(), SQL_NTS);
             }
         }
+
+        if (is_failover_enabled()) {
+            start_standby_pool();
+        }
     }
 
     if (should_connect_to_new_writer() || reconnect_with_updated_timeouts) {
         rc = reconnect(reconnect_with_updated_timeouts);
     }
 
+    if (SQL_SUCCEEDED(rc) && !dbc->pool_tag.key.empty()) {
+        dbc->pool_tag.cluster_id = cluster_id;
+        dbc->pool_tag.generation = CONNECTION_POOL::get_instance().get_generation(cluster_id);
+    }
+
     return rc;
 }
 
@@ -414,27 +399,27 @@ bool FAILOVER_HANDLER::is_dns_pattern_valid(std::string host) {
 }
 
 bool FAILOVER_HANDLER::is_rds_dns(std::string host) {
-    return std::regex_match(host, AURORA_DNS_PATTERN) || std::regex_match(host, AURORA_CHINA_DNS_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).is_rds;
 }
 
 bool FAILOVER_HANDLER::is_rds_cluster_dns(std::string host) {
-    return std::regex_match(host, AURORA_CLUSTER_PATTERN) || std::regex_match(host, AURORA_CHINA_CLUSTER_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).is_cluster;
 }
 
 bool FAILOVER_HANDLER::is_rds_proxy_dns(std::string host) {
-    return std::regex_match(host, AURORA_PROXY_DNS_PATTERN) || std::regex_match(host, AURORA_CHINA_PROXY_DNS_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).is_proxy;
 }
 
 bool FAILOVER_HANDLER::is_rds_writer_cluster_dns(std::string host) {
-    return std::regex_match(host, AURORA_WRITER_CLUSTER_PATTERN) || std::regex_match(host, AURORA_CHINA_WRITER_CLUSTER_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).is_writer_cluster;
 }
 
 bool FAILOVER_HANDLER::is_rds_reader_cluster_dns(std::string host) {
-    return std::regex_match(host, AURORA_READER_CLUSTER_PATTERN) || std::regex_match(host, AURORA_CHINA_READER_CLUSTER_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).is_reader_cluster;
 }
 
 bool FAILOVER_HANDLER::is_rds_custom_cluster_dns(std::string host) {
-    return std::regex_match(host, AURORA_CUSTOM_CLUSTER_PATTERN) || std::regex_match(host, AURORA_CHINA_CUSTOM_CLUSTER_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).is_custom_cluster;
 }
 
 bool FAILOVER_HANDLER::is_read_only() {
@@ -452,86 +437,15 @@ bool FAILOVER_HANDLER::is_read_only() {
 }
 
 std::string FAILOVER_HANDLER::host_to_IP(std::string host) {
-    int status;
-    struct addrinfo hints;
-    struct addrinfo* servinfo;
-    struct addrinfo* p;
-    char ipstr[INET_ADDRSTRLEN];
-
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_INET; //IPv4
-    hints.ai_socktype = SOCK_STREAM;
-
-    if ((status = getaddrinfo(host.c_str(), NULL, &hints, &servinfo)) != 0) {
-        return "";
-    }
-
-    for (p = servinfo; p != NULL; p = p->ai_next) {
-        void* addr;
-
-        struct sockaddr_in* ipv4 = (struct sockaddr_in*)p->ai_addr;
-        addr = &(ipv4->sin_addr);
-        inet_ntop(p->ai_family, addr, ipstr, sizeof(ipstr));
-    }
-
-    freeaddrinfo(servinfo);
-    return std::string(ipstr);
+    return DNS_CACHE::get_instance().resolve(host, std::chrono::milliseconds(ds->opt_DNS_CACHE_TTL));
 }
 
-#if defined(__APPLE__) || defined(__linux__)
-    #define strcmp_case_insensitive(str1, str2) strcasecmp(str1, str2)
-#else
-    #define strcmp_case_insensitive(str1, str2) strcmpi(str1, str2)
-#endif
-
 std::string FAILOVER_HANDLER::get_rds_cluster_host_url(std::string host) {
-    auto f = [host](const std::regex pattern) {
-        std::smatch m;
-        if (std::regex_search(host, m, pattern) && m.size() > 1) {
-            std::string gr1 = m.size() > 1 ? m.str(1) : std::string("");
-            std::string gr2 = m.size() > 2 ? m.str(2) : std::string("");
-            std::string gr3 = m.size() > 3 ? m.str(3) : std::string("");
-            if (!gr1.empty() && !gr3.empty() &&
-                (strcmp_case_insensitive(gr2.c_str(), "cluster-") == 0 || strcmp_case_insensitive(gr2.c_str(), "cluster-ro-") == 0)) {
-                std::string result;
-                result.assign(gr1);
-                result.append(".cluster-");
-                result.append(gr3);
-
-                return result;
-            }
-        }
-        return std::string();
-    };
-
-    auto result = f(AURORA_CLUSTER_PATTERN);
-    if (!result.empty()) {
-        return result;
-    }
-
-    return f(AURORA_CHINA_CLUSTER_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).cluster_host_url;
 }
 
 std::string FAILOVER_HANDLER::get_rds_instance_host_pattern(std::string host) {
-    auto f = [host](const std::regex pattern) {
-        std::smatch m;
-        if (std::regex_search(host, m, pattern) && m.size() > 3) {
-            if (!m.str(3).empty()) {
-                std::string result("?.");
-                result.append(m.str(3));
-
-                return result;
-            }
-        }
-        return std::string();
-    };
-
-    auto result = f(AURORA_DNS_PATTERN);
-    if (!result.empty()) {
-        return result;
-    }
-
-    return f(AURORA_CHINA_DNS_PATTERN);
+    return RDS_DNS_MATCHER::classify(host).instance_host_pattern;
 }
 
 bool FAILOVER_HANDLER::is_failover_enabled() {
@@ -557,12 +471,58 @@ void FAILOVER_HANDLER::initialize_topology() {
         MYLOG_DBC_TRACE(dbc,
                     "[FAILOVER_HANDLER] m_is_cluster_topology_available=%s",
                     m_is_cluster_topology_available ? "true" : "false");
-        if (is_failover_enabled()) {
-            this->dbc->env->failover_thread_pool.resize(current_topology->total_hosts());
-        }
     }
 }
 
+// Keep the cluster's topology refreshed in the background over a separate connection
+// to the host this connection was opened to.
+void FAILOVER_HANDLER::start_topology_refresher() {
+    if (topology_refresher) {
+        return;
+    }
+
+    std::shared_ptr<DataSource> refresh_ds = std::make_shared<DataSource>();
+    refresh_ds->copy(ds);
+    refresh_ds->opt_ENABLE_CLUSTER_FAILOVER = false;
+    refresh_ds->opt_ENABLE_FAILURE_DETECTION = false;
+
+    const auto host = this->current_host;
+    const auto handler = this->connection_handler;
+
+    topology_service->set_background_refresh(true);
+    topology_refresher = TOPOLOGY_REFRESHER::get_instance(*topology_service);
+    topology_refresher->attach(this, [host, handler, refresh_ds]() {
+        return handler->connect_background(host, refresh_ds.get());
+    }, *topology_service);
+}
+
+// Keep idle connections to other readers, for reader failover to take over instead of connecting.
+void FAILOVER_HANDLER::start_standby_pool() {
+    if (standby_pool || ds->opt_FAILOVER_STANDBY_CONNECTIONS <= 0 ||
+        is_failover_mode(FAILOVER_MODE_STRICT_WRITER, ds)) {
+        return;
+    }
+
+    std::shared_ptr<DataSource> standby_ds = std::make_shared<DataSource>();
+    standby_ds->copy(ds);
+    standby_ds->opt_ENABLE_CLUSTER_FAILOVER = false;
+    standby_ds->opt_ENABLE_FAILURE_DETECTION = false;
+    // Connections asking for a different number of standby connections share the pool
+    standby_ds->opt_FAILOVER_STANDBY_CONNECTIONS = 0;
+
+    const auto handler = this->connection_handler;
+
+    // One pool serves the connections to the cluster with the same credentials and session options
+    standby_pool = READER_STANDBY_POOL::get_instance(
+        *topology_service, CONNECTION_POOL::get_key(standby_ds.get()), dbc->id, ds->opt_LOG_QUERY);
+    standby_pool->attach(this,
+        [handler, standby_ds](std::shared_ptr<HOST_INFO> host) {
+            return handler->connect_background(host, standby_ds.get());
+        },
+        static_cast<size_t>(ds->opt_FAILOVER_STANDBY_CONNECTIONS));
+    failover_reader_handler->set_standby_pool(standby_pool, dbc);
+}
+
 SQLRETURN FAILOVER_HANDLER::reconnect(bool failover_enabled) {
     if (dbc->connection_proxy != nullptr && dbc->connection_proxy->is_connected()) {
         dbc->close();
@@ -571,10 +531,15 @@ SQLRETURN FAILOVER_HANDLER::reconnect(bool failover_enabled) {
 }
 
 bool FAILOVER_HANDLER::is_ipv4(std::string host) {
+    static const std::regex IPV4_PATTERN(
+        R"#(^(([1-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\.){1}(([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])\.){2}([0-9]|[1-9][0-9]|1[0-9]{2}|2[0-4][0-9]|25[0-5])$)#");
     return std::regex_match(host, IPV4_PATTERN);
 }
 
 bool FAILOVER_HANDLER::is_ipv6(std::string host) {
+    static const std::regex IPV6_PATTERN(R"#(^[0-9a-fA-F]{1,4}(:[0-9a-fA-F]{1,4}){7}$)#");
+    static const std::regex IPV6_COMPRESSED_PATTERN(
+        R"#(^(([0-9A-Fa-f]{1,4}(:[0-9A-Fa-f]{1,4}){0,5})?)::(([0-9A-Fa-f]{1,4}(:[0-9A-Fa-f]{1,4}){0,5})?)$)#");
     return std::regex_match(host, IPV6_PATTERN) ||
            std::regex_match(host, IPV6_COMPRESSED_PATTERN);
 }
@@ -601,6 +566,14 @@ bool FAILOVER_HANDLER::trigger_failover_if_needed(const char* error_code,
 
         // invalidate current connection
         current_host = nullptr;
+        // and the pooled ones, which may be to the same instance
+        CONNECTION_POOL::get_instance().invalidate_cluster(cluster_id);
+        // and what connections discovered about the instance, it may be replaced
+        if (ds->opt_SERVER) {
+            SERVER_INFO_CACHE::get_instance().invalidate((const char*)ds->opt_SERVER, ds->opt_PORT);
+        }
+        // and the addresses resolved, the cluster endpoints move to the new writer
+        DNS_CACHE::get_instance().clear();
         // close transaction if needed
         
         long long elasped_time_ms =
@@ -641,7 +614,7 @@ bool FAILOVER_HANDLER::trigger_failover_if_needed(const char* error_code,
 
 bool FAILOVER_HANDLER::failover_to_reader(const char*& new_error_code, const char*& error_msg) {
     MYLOG_DBC_TRACE(dbc, "[FAILOVER_HANDLER] Starting reader failover procedure.");
-    auto result = failover_reader_handler->failover(current_topology);
+    auto result = failover_reader_handler->failover(current_topology, current_host);
 
     if (result->connected) {
         current_host = result->new_host;
@@ -31,7 +31,6 @@
 
 #include <algorithm>
 #include <chrono>
-#include <future>
 #include <random>
 #include <thread>
 #include <vector>
@@ -39,16 +38,21 @@
 FAILOVER_READER_HANDLER::FAILOVER_READER_HANDLER(
     std::shared_ptr<TOPOLOGY_SERVICE> topology_service,
     std::shared_ptr<CONNECTION_HANDLER> connection_handler,
-    ctpl::thread_pool& thread_pool,
+    FAILOVER_EXECUTOR& executor,
     int failover_timeout_ms, int failover_reader_connect_timeout,
     bool enable_strict_reader_failover,
-    unsigned long dbc_id, bool enable_logging)
+    unsigned long dbc_id, bool enable_logging,
+    READER_SELECTOR reader_selector,
+    int reader_fanout, int reader_stagger_delay_ms)
     : topology_service{topology_service},
       connection_handler{connection_handler},
-      thread_pool{thread_pool},
+      executor{executor},
       max_failover_timeout_ms{failover_timeout_ms},
       reader_connect_timeout_ms{failover_reader_connect_timeout},
+      reader_fanout{(std::max)(reader_fanout, 1)},
+      reader_stagger_delay_ms{(std::max)(reader_stagger_delay_ms, 0)},
       enable_strict_reader_failover{enable_strict_reader_failover},
+      reader_selector{reader_selector},
       dbc_id{dbc_id} {
 
     if (enable_logging)
@@ -57,56 +61,67 @@ FAILOVER_READER_HANDLER::FAILOVER_READER_HANDLER(
 
 FAILOVER_READER_HANDLER::~FAILOVER_READER_HANDLER() {}
 
+void FAILOVER_READER_HANDLER::set_standby_pool(std::shared_ptr<READER_STANDBY_POOL> standby_pool, DBC* dbc) {
+    this->standby_pool = std::move(standby_pool);
+    this->standby_dbc = dbc;
+}
+
 // Function called to start the Reader Failover process.
 // This process will generate a list of available hosts: First readers that are up, then readers marked as down, then writers.
 // If it goes through the list and does not succeed to connect, it tries again, endlessly.
 std::shared_ptr<READER_FAILOVER_RESULT> FAILOVER_READER_HANDLER::failover(
-    std::shared_ptr<CLUSTER_TOPOLOGY_INFO> current_topology) {
+    std::shared_ptr<CLUSTER_TOPOLOGY_INFO> current_topology,
+    std::shared_ptr<HOST_INFO> current_host) {
     auto empty_result = std::make_shared<READER_FAILOVER_RESULT>(false, nullptr, nullptr);
     if (!current_topology || current_topology->total_hosts() == 0) {
         return empty_result;
     }
 
-    const auto start = std::chrono::steady_clock::now();
+    // A live standby connection is handed over without waiting for a new one
+    if (standby_pool) {
+        const auto standby = standby_pool->take(current_host, standby_dbc);
+        if (standby.connection) {
+            topology_service->mark_host_up(standby.host);
+            MYLOG_TRACE(logger, dbc_id,
+                "[FAILOVER_READER_HANDLER] Reader failover took over the standby connection to: %s",
+                standby.host->get_host_port_pair().c_str());
+            return std::make_shared<READER_FAILOVER_RESULT>(true, standby.host, standby.connection);
+        }
+    }
+
     auto global_sync = std::make_shared<FAILOVER_SYNC>(1);
+    auto failover_result = std::make_shared<READER_FAILOVER_RESULT>(false, nullptr, nullptr);
 
-    if (thread_pool.n_idle() == 0) {
-        MYLOG_TRACE(logger, dbc_id, "[FAILOVER_READER_HANDLER] Resizing thread pool to %d", thread_pool.size() + 1);
-        thread_pool.resize(thread_pool.size() + 1);
-    }
-    auto reader_result_future = thread_pool.push([=](int id) {
+    executor.submit([=](int id) {
         while (!global_sync->is_completed()) {
             auto hosts_list = build_hosts_list(current_topology, !enable_strict_reader_failover);
             auto reader_result = get_connection_from_hosts(hosts_list, global_sync);
             if (reader_result->connected) {
-                global_sync->mark_as_complete(true);
-                return reader_result;
+                const bool published = global_sync->complete_with([&]() { *failover_result = *reader_result; });
+                // The failover timed out while connecting, nobody takes the connection over
+                if (!published) {
+                    reader_result->new_connection->delete_ds();
+                    delete reader_result->new_connection;
+                }
+                return;
             }
             // TODO Think of changes to the strategy if it went
             // through all the hosts and did not connect.
-            std::this_thread::sleep_for(std::chrono::seconds(READER_CONNECT_INTERVAL_SEC));
+            global_sync->wait_for_completion(READER_CONNECT_INTERVAL_SEC * 1000);
         }
-        return empty_result;
-    });
+    }, global_sync);
 
-    // Wait for task complete signal with specified timeout
+    // Wait for the task to connect or the timeout. The task publishes its result
+    // before signalling, and cannot publish once the wait has returned.
     global_sync->wait_and_complete(max_failover_timeout_ms);
-    // Constantly polling for results until timeout
-    while (true) {
-        if (reader_result_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            MYLOG_TRACE(logger, dbc_id, "[FAILOVER_READER_HANDLER] Reader failover finished.");
-            return reader_result_future.get();
-        }
-
-        // No result it ready, update remaining timeout
-        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
-        const auto remaining_wait_ms = max_failover_timeout_ms - duration.count();
-        if (remaining_wait_ms <= 0) {
-            // Reader failover timed out
-            MYLOG_TRACE(logger, dbc_id, "[FAILOVER_READER_HANDLER] Reader failover timed out. Failed to connect to the reader instance.");
-            return empty_result;
-        }
+    if (failover_result->connected) {
+        MYLOG_TRACE(logger, dbc_id, "[FAILOVER_READER_HANDLER] Reader failover finished.");
+        return failover_result;
     }
+
+    // Reader failover timed out
+    MYLOG_TRACE(logger, dbc_id, "[FAILOVER_READER_HANDLER] Reader failover timed out. Failed to connect to the reader instance.");
+    return empty_result;
 }
 
 // Function to connect to a reader host. Often used to query/update the topology.
@@ -125,6 +140,8 @@ std::shared_ptr<READER_FAILOVER_RESULT> FAILOVER_READER_HANDLER::get_reader_conn
         if (reader_result->connected) {
             return reader_result;
         }
+        // Readers refusing connections fail fast, pause before trying them again
+        f_sync->wait_for_completion(READER_CONNECT_INTERVAL_SEC * 1000);
     }
     // Return a false result if the connection request has been cancelled.
     return std::make_shared<READER_FAILOVER_RESULT>(false, nullptr, nullptr);
@@ -152,10 +169,9 @@ std::vector<std::shared_ptr<HOST_INFO>> FAILOVER_READER_HANDLER::build_hosts_lis
         }
     }
 
-    // Both lists of readers up and down are shuffled.
-    auto rng = std::default_random_engine{};
-    std::shuffle(std::begin(readers_up), std::end(readers_up), rng);
-    std::shuffle(std::begin(readers_down), std::end(readers_down), rng);
+    // Both lists of readers up and down are ordered by the reader selection strategy.
+    reader_selector.order_readers(readers_up);
+    reader_selector.order_readers(readers_down);
 
     // Readers that are marked up go first, readers marked down go after.
     hosts_list.insert(hosts_list.end(), readers_up.begin(), readers_up.end());
@@ -163,7 +179,7 @@ std::vector<std::shared_ptr<HOST_INFO>> FAILOVER_READER_HANDLER::build_hosts_lis
 
     if (include_writers) {
         auto writers = topology_info->get_writers();
-        std::shuffle(std::begin(writers), std::end(writers), rng);
+        std::shuffle(std::begin(writers), std::end(writers), READER_SELECTOR::get_random_engine());
         hosts_list.insert(hosts_list.end(), writers.begin(), writers.end());
     }
 
@@ -182,81 +198,43 @@ std::shared_ptr<READER_FAILOVER_RESULT> FAILOVER_READER_HANDLER::get_connection_
     while (!global_sync->is_completed() && i < total_hosts) {
         const auto start = std::chrono::steady_clock::now();
 
-        // This boolean verifies if the next host in the list is also the last, meaning there's no host for the second thread.
-        const bool odd_hosts_number = (i + 1 == total_hosts);
-
-        auto local_sync = std::make_shared<FAILOVER_SYNC>(1);
-        if (!odd_hosts_number) {
-            local_sync->increment_task();
+        // Connect to the next hosts in parallel, in order of priority
+        const size_t num_attempts = (std::min)(static_cast<size_t>(reader_fanout), total_hosts - i);
+        auto local_sync = std::make_shared<FAILOVER_SYNC>(static_cast<int>(num_attempts));
+
+        std::vector<std::shared_ptr<READER_FAILOVER_RESULT>> connection_results;
+        for (size_t attempt = 0; attempt < num_attempts; attempt++) {
+            // Each attempt starts a stagger delay after the previous one, giving hosts earlier in the list a head start
+            auto connect_handler = std::make_shared<CONNECT_TO_READER_HANDLER>(
+                connection_handler, topology_service,
+                static_cast<int>(attempt) * reader_stagger_delay_ms, dbc_id, logger != nullptr);
+            auto connection_result = std::make_shared<READER_FAILOVER_RESULT>(false, nullptr, nullptr);
+            auto host = hosts_list.at(i + attempt);
+            // Attempts still queued when another one connects are dropped
+            executor.submit([=](int id) { (*connect_handler)(id, host, local_sync, connection_result); }, local_sync);
+            connection_results.push_back(connection_result);
         }
 
-        CONNECT_TO_READER_HANDLER first_connection_handler(connection_handler, topology_service, dbc_id, logger != nullptr);
-        auto first_connection_result = std::make_shared<READER_FAILOVER_RESULT>(false, nullptr, nullptr);
-
-        CONNECT_TO_READER_HANDLER second_connection_handler(connection_handler, topology_service, dbc_id, logger != nullptr);
-        auto second_connection_result = std::make_shared<READER_FAILOVER_RESULT>(false, nullptr, nullptr);
-        
-        std::shared_ptr<HOST_INFO> first_reader_host = hosts_list.at(i);
-
-        if (thread_pool.n_idle() <= 1) {
-            int size = thread_pool.size() + 2 - thread_pool.n_idle();
-            MYLOG_TRACE(logger, dbc_id,
-                        "[FAILOVER_READER_HANDLER] Resizing thread pool to %d", size);
-            thread_pool.resize(size);
-    }
-
-        auto first_result = thread_pool.push(std::move(first_connection_handler), first_reader_host, local_sync, first_connection_result);
-        std::future<void> second_future;
-        if (!odd_hosts_number) {
-            auto second_reader_host = hosts_list.at(i + 1);
-            second_future = thread_pool.push(std::move(second_connection_handler), second_reader_host, local_sync, second_connection_result);
-        }
-
-        // Wait for task complete signal with specified timeout
+        // Wait for the first task to connect, all tasks to fail, or the timeout. Tasks publish
+        // their result before signalling, and cannot publish once the wait has returned.
         local_sync->wait_and_complete(reader_connect_timeout_ms);
 
-        // Constantly polling for results until timeout
-        while (true) {
-            // Check if first reader task result is ready
-            if (first_result.valid() && first_result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-                first_result.get();
-                if (first_connection_result->connected) {
-                    MYLOG_TRACE(logger, dbc_id,
-                        "[FAILOVER_READER_HANDLER] Connected to reader: %s",
-                        first_connection_result->new_host->get_host_port_pair().c_str());
-
-                    return first_connection_result;
-                }
-            }
+        for (const auto& connection_result : connection_results) {
+            if (connection_result->connected) {
+                MYLOG_TRACE(logger, dbc_id,
+                    "[FAILOVER_READER_HANDLER] Connected to reader: %s",
+                    connection_result->new_host->get_host_port_pair().c_str());
 
-            // Check if second reader task result is ready if there is one
-            if (!odd_hosts_number && second_future.valid() &&
-                second_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-                second_future.get();
-                if (second_connection_result->connected) {
-                    MYLOG_TRACE(logger, dbc_id,
-                        "[FAILOVER_READER_HANDLER] Connected to reader: %s",
-                        second_connection_result->new_host->get_host_port_pair().c_str());
-
-                    return second_connection_result;
-                }
-            }
-
-            // Results are ready but non has valid connection
-            if (!first_result.valid() && (odd_hosts_number || !second_future.valid())) {
-                break;
+                return connection_result;
             }
+        }
 
-            // No result it ready, update remaining timeout
-            const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
-            const auto remaining_wait_ms = reader_connect_timeout_ms - duration.count();
-            if (remaining_wait_ms <= 0) {
-                // None has connected. We move on and try new hosts.
-                std::this_thread::sleep_for(std::chrono::seconds(READER_CONNECT_INTERVAL_SEC));
-                break;
-            }
+        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        if (duration.count() >= reader_connect_timeout_ms) {
+            // None has connected. We move on and try new hosts.
+            global_sync->wait_for_completion(READER_CONNECT_INTERVAL_SEC * 1000);
         }
-        i += 2;
+        i += num_attempts;
     }
 
     // The operation was either cancelled either reached the end of the list without connecting.
@@ -268,8 +246,9 @@ std::shared_ptr<READER_FAILOVER_RESULT> FAILOVER_READER_HANDLER::get_connection_
 CONNECT_TO_READER_HANDLER::CONNECT_TO_READER_HANDLER(
     std::shared_ptr<CONNECTION_HANDLER> connection_handler,
     std::shared_ptr<TOPOLOGY_SERVICE> topology_service,
-    unsigned long dbc_id, bool enable_logging)
-    : FAILOVER{connection_handler, topology_service, dbc_id, enable_logging} {}
+    int start_delay_ms, unsigned long dbc_id, bool enable_logging)
+    : FAILOVER{connection_handler, topology_service, dbc_id, enable_logging},
+      start_delay_ms{start_delay_ms} {}
 
 CONNECT_TO_READER_HANDLER::~CONNECT_TO_READER_HANDLER() {}
 
@@ -278,7 +257,12 @@ void CONNECT_TO_READER_HANDLER::operator()(
     std::shared_ptr<HOST_INFO> reader,
     std::shared_ptr<FAILOVER_SYNC> f_sync,
     std::shared_ptr<READER_FAILOVER_RESULT> result) {
-    
+
+    // Returns early when another attempt connects, or all attempts time out, in the meantime
+    if (start_delay_ms > 0) {
+        f_sync->wait_for_completion(start_delay_ms);
+    }
+
     if (reader && !f_sync->is_completed()) {
 
         MYLOG_TRACE(logger, dbc_id,
@@ -287,20 +271,20 @@ void CONNECT_TO_READER_HANDLER::operator()(
 
         if (connect(reader)) {
             topology_service->mark_host_up(reader);
-            if (f_sync->is_completed()) {
-                // If another thread finishes first, or both timeout, this thread is canceled.
-                release_new_connection();
-            } else {
-                result->connected =true;
+            const bool published = f_sync->complete_with([&]() {
+                result->connected = true;
                 result->new_host = reader;
                 result->new_connection = std::move(this->new_connection);
-                f_sync->mark_as_complete(true);
+                this->new_connection = nullptr;
+            });
+            if (published) {
                 MYLOG_TRACE(
                     logger, dbc_id,
                     "Thread ID %d - [CONNECT_TO_READER_HANDLER] Connected to reader: %s",
                     id, reader->get_host_port_pair().c_str());
                 return;
             }
+            // If another thread finishes first, or both timeout, this thread is canceled.
         } else {
             topology_service->mark_host_down(reader);
             MYLOG_TRACE(
@@ -30,8 +30,6 @@
 #include "driver.h"
 
 #include <chrono>
-#include <future>
-#include <thread>
 
 // **** FAILOVER_SYNC ***************************************
 // used for thread synchronization
@@ -53,20 +51,54 @@ void FAILOVER_SYNC::mark_as_complete(bool cancel_other_tasks) {
         num_tasks--;
     }
 
-    cv.notify_one();
+    cv.notify_all();
 }
 
 void FAILOVER_SYNC::wait_and_complete(int milliseconds) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+    // Tasks waiting here wait for the tasks they submitted. Those no other thread took yet
+    // are run here, they may otherwise wait behind other waiting tasks until the timeout.
+    FAILOVER_EXECUTOR_BLOCKING_SCOPE blocking;
+    while (!is_completed() && std::chrono::steady_clock::now() < deadline &&
+           FAILOVER_EXECUTOR::run_submitted_task()) {
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
-    cv.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return num_tasks <= 0; });
+    cv.wait_until(lock, deadline, [this] { return num_tasks <= 0; });
     num_tasks = 0;
 }
 
+bool FAILOVER_SYNC::complete_with(const std::function<void()>& publish_result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (num_tasks <= 0) {
+        return false;
+    }
+
+    publish_result();
+    num_tasks = 0;
+    cv.notify_all();
+    return true;
+}
+
+bool FAILOVER_SYNC::wait_for_completion(int milliseconds) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return num_tasks <= 0; });
+}
+
 bool FAILOVER_SYNC::is_completed() {
     std::unique_lock<std::mutex> lock(mutex_);
     return num_tasks <= 0; 
 }
 
+bool FAILOVER_SYNC::is_cancelled() {
+    return is_completed();
+}
+
+bool FAILOVER_SYNC::wait_for_cancellation(int milliseconds) {
+    return wait_for_completion(milliseconds);
+}
+
 // ************* FAILOVER ***********************************
 // Base class of two writer failover task handlers
 FAILOVER::FAILOVER(
@@ -87,12 +119,13 @@ bool FAILOVER::is_writer_connected() {
 }
 
 bool FAILOVER::connect(std::shared_ptr<HOST_INFO> host_info) {
+    const auto start = std::chrono::steady_clock::now();
     new_connection = connection_handler->connect(host_info, nullptr);
-    return is_writer_connected();
-}
+    const bool connected = is_writer_connected();
 
-void FAILOVER::sleep(int miliseconds) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(miliseconds));
+    TOPOLOGY_SERVICE::record_connect_attempt(host_info->get_host_id(), connected,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+    return connected;
 }
 
 // Close new connection if not needed (other task finishes and returns first)
@@ -135,20 +168,23 @@ void RECONNECT_TO_WRITER_HANDLER::operator()(
                     is_current_host_writer(original_writer, latest_topology)) {
 
                     topology_service->mark_host_up(original_writer);
-                    if (f_sync->is_completed()) {
-                        break;
+                    const bool published = f_sync->complete_with([&]() {
+                        result->connected = true;
+                        result->is_new_host = false;
+                        result->new_topology = latest_topology;
+                        result->new_connection = std::move(new_connection);
+                        new_connection = nullptr;
+                    });
+                    if (published) {
+                        MYLOG_TRACE(logger, dbc_id, "Thread ID %d - [RECONNECT_TO_WRITER_HANDLER] [TaskA] Finished", id);
+                        return;
                     }
-                    result->connected = true;
-                    result->is_new_host = false;
-                    result->new_topology = latest_topology;
-                    result->new_connection = std::move(new_connection);
-                    f_sync->mark_as_complete(true);
-                    MYLOG_TRACE(logger, dbc_id, "Thread ID %d - [RECONNECT_TO_WRITER_HANDLER] [TaskA] Finished", id);
-                    return;
+                    break;
                 }
                 release_new_connection();
             }
-            sleep(reconnect_interval_ms);
+            // Returns early when the other task connects, or the failover times out, in the meantime
+            f_sync->wait_for_completion(reconnect_interval_ms);
         }
         MYLOG_TRACE(logger, dbc_id, "Thread ID %d - [RECONNECT_TO_WRITER_HANDLER] [TaskA] Cancelled", id);
     }
@@ -197,13 +233,17 @@ void WAIT_NEW_WRITER_HANDLER::operator()(
             refresh_topology_and_connect_to_new_writer(original_writer, f_sync);
             clean_up_reader_connection();
         } else {
-            result->connected = true;
-            result->is_new_host = true;
-            result->new_topology = current_topology;
-            result->new_connection = std::move(new_connection);
-            f_sync->mark_as_complete(true);
-            MYLOG_TRACE(logger, dbc_id, "Thread ID %d - [WAIT_NEW_WRITER_HANDLER] [TaskB] Finished", id);
-            return;
+            const bool published = f_sync->complete_with([&]() {
+                result->connected = true;
+                result->is_new_host = true;
+                result->new_topology = current_topology;
+                result->new_connection = std::move(new_connection);
+                new_connection = nullptr;
+            });
+            if (published) {
+                MYLOG_TRACE(logger, dbc_id, "Thread ID %d - [WAIT_NEW_WRITER_HANDLER] [TaskB] Finished", id);
+                return;
+            }
         }
     }
     MYLOG_TRACE(logger, dbc_id, "Thread ID %d - [WAIT_NEW_WRITER_HANDLER] [TaskB] Cancelled", id);
@@ -244,7 +284,7 @@ void WAIT_NEW_WRITER_HANDLER::refresh_topology_and_connect_to_new_writer(
                 if (connect_to_writer(writer_candidate)) return;
             }
         }
-        sleep(read_topology_interval_ms);
+        f_sync->wait_for_completion(read_topology_interval_ms);
     }
 }
 
@@ -281,13 +321,13 @@ FAILOVER_WRITER_HANDLER::FAILOVER_WRITER_HANDLER(
     std::shared_ptr<TOPOLOGY_SERVICE> topology_service,
     std::shared_ptr<FAILOVER_READER_HANDLER> reader_handler,
     std::shared_ptr<CONNECTION_HANDLER> connection_handler,
-    ctpl::thread_pool& thread_pool,
+    FAILOVER_EXECUTOR& executor,
     int writer_failover_timeout_ms, int read_topology_interval_ms,
     int reconnect_writer_interval_ms, unsigned long dbc_id, bool enable_logging)
     : connection_handler{connection_handler},
       topology_service{topology_service},
       reader_handler{reader_handler},
-      thread_pool{thread_pool},
+      executor{executor},
       writer_failover_timeout_ms{writer_failover_timeout_ms},
       read_topology_interval_ms{read_topology_interval_ms},
       reconnect_writer_interval_ms{reconnect_writer_interval_ms},
@@ -309,14 +349,12 @@ std::shared_ptr<WRITER_FAILOVER_RESULT> FAILOVER_WRITER_HANDLER::failover(
         return std::make_shared<WRITER_FAILOVER_RESULT>(false, false, nullptr, nullptr);
     }
 
-    const auto start = std::chrono::steady_clock::now();
-
     auto failover_sync = std::make_shared<FAILOVER_SYNC>(2);
 
     // Constructing the function objects
-    RECONNECT_TO_WRITER_HANDLER reconnect_handler(
+    auto reconnect_handler = std::make_shared<RECONNECT_TO_WRITER_HANDLER>(
         connection_handler, topology_service, reconnect_writer_interval_ms, dbc_id, logger != nullptr);
-    WAIT_NEW_WRITER_HANDLER new_writer_handler(
+    auto new_writer_handler = std::make_shared<WAIT_NEW_WRITER_HANDLER>(
         connection_handler, topology_service, current_topology, reader_handler,
         read_topology_interval_ms, dbc_id, logger != nullptr);
 
@@ -326,59 +364,30 @@ std::shared_ptr<WRITER_FAILOVER_RESULT> FAILOVER_WRITER_HANDLER::failover(
     auto reconnect_result = std::make_shared<WRITER_FAILOVER_RESULT>(false, false, nullptr, nullptr);
     auto new_writer_result = std::make_shared<WRITER_FAILOVER_RESULT>(false, false, nullptr, nullptr);
 
-    if (thread_pool.n_idle() <= 1) {
-        int size = thread_pool.size() + 2 - thread_pool.n_idle();
-        MYLOG_TRACE(logger, dbc_id,
-                    "[FAILOVER_WRITER_HANDLER] Resizing thread pool to %d", size);
-        thread_pool.resize(size);
-    }
-
-    auto reconnect_future = thread_pool.push(std::move(reconnect_handler), original_writer, failover_sync, reconnect_result);
-    auto wait_new_writer_future = thread_pool.push(std::move(new_writer_handler), original_writer, failover_sync, new_writer_result);
+    executor.submit([=](int id) { (*reconnect_handler)(id, original_writer, failover_sync, reconnect_result); },
+                    failover_sync);
+    executor.submit([=](int id) { (*new_writer_handler)(id, original_writer, failover_sync, new_writer_result); },
+                    failover_sync);
 
-    // Wait for task complete signal with specified timeout
+    // Wait for the first task to connect or the timeout. Tasks publish their
+    // result before signalling, and cannot publish once the wait has returned.
     failover_sync->wait_and_complete(writer_failover_timeout_ms);
 
-    // Constantly polling for results until timeout
-    while (true) {
-        // Check if reconnect task result is ready
-        if (reconnect_future.valid() && reconnect_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            reconnect_future.get();
-            if (reconnect_result->connected) {
-                MYLOG_TRACE(logger, dbc_id,
-                    "[FAILOVER_WRITER_HANDLER] Successfully re-connected to the current writer instance: %s",
-                    reconnect_result->new_topology->get_writer()->get_host_port_pair().c_str());
-                return reconnect_result;
-            }
-        }
-
-        // Check if wait new writer task result is ready
-        if (wait_new_writer_future.valid() && wait_new_writer_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            wait_new_writer_future.get();
-            if (new_writer_result->connected) {
-                MYLOG_TRACE(logger, dbc_id,
-                    "[FAILOVER_WRITER_HANDLER] Successfully connected to the new writer instance: %s",
-                    new_writer_result->new_topology->get_writer()->get_host_port_pair().c_str());
-                return new_writer_result;
-            }
-        }
-
-        // Results are ready but non has valid connection
-        if (!reconnect_future.valid() && !wait_new_writer_future.valid()) {
-            break;
-        }
+    if (reconnect_result->connected) {
+        MYLOG_TRACE(logger, dbc_id,
+            "[FAILOVER_WRITER_HANDLER] Successfully re-connected to the current writer instance: %s",
+            reconnect_result->new_topology->get_writer()->get_host_port_pair().c_str());
+        return reconnect_result;
+    }
 
-        // No result it ready, update remaining timeout
-        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
-        const auto remaining_wait_ms = writer_failover_timeout_ms - duration.count();
-        if (remaining_wait_ms <= 0) {
-            // Writer failover timed out
-            MYLOG_TRACE(logger, dbc_id, "[FAILOVER_WRITER_HANDLER] Writer failover timed out. Failed to connect to the writer instance.");
-            return std::make_shared<WRITER_FAILOVER_RESULT>(false, false, nullptr, nullptr);
-        }
+    if (new_writer_result->connected) {
+        MYLOG_TRACE(logger, dbc_id,
+            "[FAILOVER_WRITER_HANDLER] Successfully connected to the new writer instance: %s",
+            new_writer_result->new_topology->get_writer()->get_host_port_pair().c_str());
+        return new_writer_result;
     }
 
-    // Writer failover finished but not connected
-    MYLOG_TRACE(logger, dbc_id, "[FAILOVER_WRITER_HANDLER] Failed to connect to the writer instance.");
+    // Writer failover timed out
+    MYLOG_TRACE(logger, dbc_id, "[FAILOVER_WRITER_HANDLER] Writer failover timed out. Failed to connect to the writer instance.");
     return std::make_shared<WRITER_FAILOVER_RESULT>(false, false, nullptr, nullptr);
 }
@@ -76,16 +76,24 @@ bool ENV::has_connections()
   return conn_list.size() > 0;
 }
 
-DBC::DBC(ENV *p_env)
+/*
+  Handles not registered in the environment only open connections for
+  other handles, they are not visible to the application.
+*/
+DBC::DBC(ENV *p_env, bool register_in_env)
     : id{last_dbc_id++},
       env(p_env),
+      registered(register_in_env),
       connection_proxy(nullptr),
       txn_isolation(DEFAULT_TXN_ISOLATION),
       last_query_time((time_t)time((time_t *)0))
 {
   //mysql->net.vio = nullptr;
-  myodbc_ov_init(env->odbc_ver);
-  env->add_dbc(this);
+  if (registered)
+  {
+    myodbc_ov_init(env->odbc_ver);
+    env->add_dbc(this);
+  }
 }
 
 void DBC::add_desc(DESC* desc)
@@ -116,6 +124,23 @@ void DBC::close()
   connection_proxy->close();
 }
 
+/*
+  Hands the physical connection over to the connection pool, if it was
+  opened for one. The proxy chain is left without a connection.
+*/
+void DBC::release_to_pool()
+{
+  if (pool_tag.key.empty() || connection_proxy == nullptr ||
+      !connection_proxy->is_connected() || connection_proxy->is_node_unhealthy())
+    return;
+
+  MYSQL *mysql = connection_proxy->move_mysql_connection();
+  CONNECTION_POOL::get_instance().release(
+    pool_tag, mysql, static_cast<size_t>(ds->opt_CONNECTION_POOL_MAX_SIZE),
+    std::chrono::milliseconds(ds->opt_CONNECTION_POOL_MAX_IDLE_TIME));
+  pool_tag = CONNECTION_POOL_TAG();
+}
+
 // construct a proxy chain, example: iam->efm->mysql
 void DBC::init_proxy_chain(DataSource* dsrc)
 {
@@ -146,7 +171,7 @@ void DBC::init_proxy_chain(DataSource* dsrc)
 
 DBC::~DBC()
 {
-  if (env)
+  if (env && registered)
     env->remove_dbc(this);
 
   if (connection_proxy)
@@ -385,6 +410,8 @@ int wakeup_connection(DBC *dbc)
     return 1;
   }
 
+  /* The session was reset to the user's defaults */
+  dbc->session_state.clear();
   dbc->need_to_wakeup= 0;
   return 0;
 }
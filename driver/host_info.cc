@@ -29,6 +29,23 @@
 
 #include "host_info.h"
 
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    const char HOST_PORT_SEPARATOR = ':';
+
+    // Ids are never released, the number of distinct hosts a process connects to is small
+    HOST_ID intern_host_id(const std::string& host_port_pair) {
+        static std::unordered_map<std::string, HOST_ID> host_ids;
+        static std::mutex host_ids_mutex;
+
+        std::unique_lock<std::mutex> lock(host_ids_mutex);
+        const auto result = host_ids.emplace(host_port_pair, static_cast<HOST_ID>(host_ids.size()));
+        return result.first->second;
+    }
+}
+
 // TODO
 // the entire HOST_INFO needs to be reviewed based on needed interfaces and other objects like CLUSTER_TOPOLOGY_INFO
 // most/all of the HOST_INFO potentially could be internal to CLUSTER_TOPOLOGY_INFO and specfic information may be accessed
@@ -45,13 +62,16 @@ HOST_INFO::HOST_INFO(const char* host, int port)
     : HOST_INFO(host, port, UP, false) {}
 
 HOST_INFO::HOST_INFO(std::string host, int port, HOST_STATE state, bool is_writer)
-    : host{ host }, port{ port }, host_state{ state }, is_writer{ is_writer }
+    : host{ host }, port{ port },
+      host_port_pair{ host + HOST_PORT_SEPARATOR + std::to_string(port) },
+      host_id{ intern_host_id(host_port_pair) },
+      host_state{ state }, is_writer{ is_writer }
 {
 }
 
 // would need some checks for nulls
 HOST_INFO::HOST_INFO(const char* host, int port, HOST_STATE state, bool is_writer)
-    : host{ host }, port{ port }, host_state{ state }, is_writer{ is_writer }
+    : HOST_INFO(std::string(host), port, state, is_writer)
 {
 }
 
@@ -80,13 +100,21 @@ int HOST_INFO::get_port() {
  *
  * @return the host:port representation of this host
  */
-std::string HOST_INFO::get_host_port_pair() {
-    return get_host() + HOST_PORT_SEPARATOR + std::to_string(get_port());
+const std::string& HOST_INFO::get_host_port_pair() {
+    return host_port_pair;
 }
 
+/**
+ * Returns the id shared by all hosts with the same host and port.
+ *
+ * @return the id of this host
+ */
+HOST_ID HOST_INFO::get_host_id() {
+    return host_id;
+}
 
 bool HOST_INFO::equal_host_port_pair(HOST_INFO& hi) {
-    return get_host_port_pair() == hi.get_host_port_pair();
+    return get_host_id() == hi.get_host_id();
 }
 
 HOST_STATE HOST_INFO::get_host_state() {
@@ -30,11 +30,17 @@
 #ifndef __HOSTINFO_H__
 #define __HOSTINFO_H__
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 enum HOST_STATE { UP, DOWN };
 
+// Process-wide identifier of a host:port pair. Hosts with the same host and port
+// have the same id, so hosts can be compared and tracked without string operations.
+typedef uint32_t HOST_ID;
+
 // TODO Think about char types. Using strings for now, but should SQLCHAR *, or CHAR * be employed?
 // Most of the strings are for internal failover things
 class HOST_INFO {
@@ -49,7 +55,8 @@ public:
 
     int get_port();
     std::string get_host();
-    std::string get_host_port_pair();
+    const std::string& get_host_port_pair();
+    HOST_ID get_host_id();
     bool equal_host_port_pair(HOST_INFO& hi);
     HOST_STATE get_host_state();
     void set_host_state(HOST_STATE state);
@@ -59,17 +66,19 @@ public:
     void mark_as_writer(bool writer);
     static bool is_host_same(std::shared_ptr<HOST_INFO> h1, std::shared_ptr<HOST_INFO> h2);
     static constexpr int NO_PORT = -1;
+    static constexpr int NO_REPLICA_LAG = -1;
 
-    // used to be properties - TODO - remove the ones that are not necessary
+    // Topology details of the host, parsed from the topology query
     std::string session_id;
-    std::string last_updated;
-    std::string replica_lag;
+    std::chrono::system_clock::time_point last_updated;
+    int replica_lag_ms = NO_REPLICA_LAG;
     std::string instance_name;
 
 private:
-    const std::string HOST_PORT_SEPARATOR = ":";
     const std::string host;
     const int port = NO_PORT;
+    const std::string host_port_pair;
+    const HOST_ID host_id;
 
     HOST_STATE host_state;
     bool is_writer;
@@ -35,6 +35,17 @@
 #include "monitor_service.h"
 #include "mylog.h"
 
+namespace {
+    // Monitoring connections are opened on these threads, so that the scheduler threads
+    // keep checking the other nodes while a node does not answer
+    FAILOVER_EXECUTOR& get_connect_executor() {
+        // Never destroyed, connects may still be running when static objects are destroyed at exit
+        static FAILOVER_EXECUTOR* executor =
+            new FAILOVER_EXECUTOR(monitor_connect_parallelism, monitor_connect_max_threads);
+        return *executor;
+    }
+}
+
 MONITOR::MONITOR(
     std::shared_ptr<HOST_INFO> host_info,
     std::shared_ptr<CONNECTION_HANDLER> connection_handler,
@@ -66,13 +77,18 @@ MONITOR::MONITOR(
     this->disposal_time = monitor_disposal_time;
     this->ds = new DataSource();
     this->ds->copy(ds);
+    this->phi_threshold = static_cast<int>(this->ds->opt_FAILURE_DETECTION_PHI_THRESHOLD);
     this->connection_proxy = proxy;
     this->connection_check_interval = (std::chrono::milliseconds::max)();
+    this->node_health_table = NODE_HEALTH_TABLE::get_instance();
     if (enable_logging)
         this->logger = init_log_file();
 }
 
 MONITOR::~MONITOR() {
+    this->update_node_health(false, true, {});
+    this->abandon_connect();
+
     if (this->ds) {
         delete ds;
         this->ds = nullptr;
@@ -99,6 +115,10 @@ void MONITOR::start_monitoring(std::shared_ptr<MONITOR_CONNECTION_CONTEXT> conte
         std::unique_lock<std::mutex> lock(mutex_);
         this->contexts.push_back(context);
     }
+    context->set_monitor(shared_from_this());
+    context->set_registered(true);
+
+    this->wake();
 }
 
 void MONITOR::stop_monitoring(std::shared_ptr<MONITOR_CONNECTION_CONTEXT> context) {
@@ -110,6 +130,7 @@ void MONITOR::stop_monitoring(std::shared_ptr<MONITOR_CONNECTION_CONTEXT> contex
     }
 
     context->invalidate();
+    context->set_registered(false);
 
     {
         std::unique_lock<std::mutex> lock(mutex_);
@@ -117,69 +138,207 @@ void MONITOR::stop_monitoring(std::shared_ptr<MONITOR_CONNECTION_CONTEXT> contex
     }
 
     this->connection_check_interval = this->find_shortest_interval();
+    this->last_context_timestamp = get_current_time();
+
+    // Let the scheduler start the disposal countdown if this was the last context
+    this->wake();
 }
 
 bool MONITOR::is_stopped() {
     return this->stopped.load();
 }
 
+void MONITOR::start() {
+    this->stopped.store(false);
+}
+
 void MONITOR::stop() {
-    this->stopped.store(true);
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        this->stopped.store(true);
+    }
+    this->wake_cv.notify_all();
+}
+
+// Request the monitor to run as soon as possible instead of waiting for its next scheduled check.
+void MONITOR::wake() {
+    std::shared_ptr<MONITOR_THREAD_CONTAINER> container;
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        this->wake_requested = true;
+        container = this->thread_container.lock();
+    }
+    this->wake_cv.notify_all();
+
+    if (container) {
+        container->wake_task(shared_from_this());
+    }
+}
+
+// Called on every monitored call. Only the first call since the monitor went idle wakes it up,
+// and that without locking the container's tasks.
+void MONITOR::wake_if_idle() {
+    if (!this->idle.exchange(false)) {
+        return;
+    }
+
+    std::shared_ptr<MONITOR_THREAD_CONTAINER> container;
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        this->wake_requested = true;
+        container = this->thread_container.lock();
+    }
+    this->wake_cv.notify_all();
+
+    if (container) {
+        container->wake_parked_task(shared_from_this());
+    }
+}
+
+void MONITOR::set_thread_container(std::weak_ptr<MONITOR_THREAD_CONTAINER> container) {
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    this->thread_container = std::move(container);
 }
 
 void MONITOR::clear_contexts() {
     {
         std::unique_lock<std::mutex> lock(mutex_);
+        for (const auto& context : this->contexts) {
+            context->set_registered(false);
+        }
         this->contexts.clear();
     }
 
     this->connection_check_interval = (std::chrono::milliseconds::max)();
+    this->wake();
 }
 
-// Periodically ping the server and update the contexts' connection status.
+// Ping the server until the monitor is disposed of. Used when the monitor is not driven by
+// the MONITOR_THREAD_CONTAINER scheduler; waits between checks instead of polling.
 void MONITOR::run(std::shared_ptr<MONITOR_SERVICE> service) {
     this->stopped = false;
-    while (!this->stopped) {
+    std::chrono::milliseconds next_run_delay(0);
+    while (this->run_once(service, next_run_delay)) {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        const auto wake_condition = [this] { return this->wake_requested || this->stopped; };
+        if (next_run_delay == (std::chrono::milliseconds::max)()) {
+            this->wake_cv.wait(lock, wake_condition);
+        } else {
+            this->wake_cv.wait_for(lock, next_run_delay, wake_condition);
+        }
+        this->wake_requested = false;
+    }
+}
+
+// Ping the server once if any context is armed and update the contexts' connection status.
+// The ping doesn't block: while the reply is outstanding the monitor asks to be run again
+// shortly and only updates the contexts once the ping completes or times out.
+// Contexts stay registered for the lifetime of their connection, so the server is only pinged
+// while at least one of them is armed by an in-flight call. Returns false once the monitor
+// has been disposed of, otherwise sets how long to wait before the next run.
+// A delay of milliseconds::max() means the monitor is idle until woken up.
+bool MONITOR::run_once(std::shared_ptr<MONITOR_SERVICE> service, std::chrono::milliseconds& next_run_delay) {
+    if (!this->stopped) {
+        // Mark idle before looking at the contexts so that a context armed
+        // concurrently either gets seen here or wakes the monitor up.
+        this->idle.store(true);
+
         bool have_contexts;
+        bool have_active_contexts = false;
         {
             std::unique_lock<std::mutex> lock(mutex_);
             have_contexts = !this->contexts.empty();
+            for (const auto& context : this->contexts) {
+                if (context->is_active_context()) {
+                    have_active_contexts = true;
+                    break;
+                }
+            }
         }
-        if (have_contexts) {
-            auto status_check_start_time = this->get_current_time();
+
+        // Keep checking a node marked unhealthy, even without armed contexts, so that
+        // connections waiting on it learn as soon as it is reachable again.
+        const bool node_marked_unhealthy = have_contexts && !this->unhealthy_node_keys.empty();
+        if (have_active_contexts || this->ping_in_progress || this->connect_attempt || node_marked_unhealthy) {
+            this->idle.store(false);
+
+            CONNECTION_STATUS status;
+            if (!this->poll_connection_status(status)) {
+                // The server hasn't replied yet, come back later instead of blocking the scheduler thread
+                next_run_delay = ping_poll_interval;
+                return true;
+            }
+
+            auto status_check_start_time = this->status_check_start_time;
             this->last_context_timestamp = status_check_start_time;
 
-            CONNECTION_STATUS status = this->check_connection_status();
+            const auto current_time = status_check_start_time + status.elapsed_time;
+            const bool use_phi_detection = this->use_phi_detection();
+            if (status.is_valid) {
+                this->unresponsive_since = std::chrono::steady_clock::time_point{};
+            } else if (this->unresponsive_since == std::chrono::steady_clock::time_point{}) {
+                this->unresponsive_since = status_check_start_time;
+            }
+            const double suspicion_level = use_phi_detection ? this->get_suspicion_level(current_time) : 0;
 
+            bool node_unhealthy = false;
+            std::set<std::string> node_keys;
             {
                 std::unique_lock<std::mutex> lock(mutex_);
                 for (auto it = this->contexts.begin(); it != this->contexts.end(); ++it) {
                     std::shared_ptr<MONITOR_CONNECTION_CONTEXT> context = *it;
-                    context->update_connection_status(
-                        status_check_start_time,
-                        status_check_start_time + status.elapsed_time,
-                        status.is_valid);
+                    if (use_phi_detection) {
+                        context->update_connection_suspicion(
+                            status_check_start_time,
+                            current_time,
+                            status.is_valid,
+                            suspicion_level,
+                            this->phi_threshold);
+                    } else {
+                        context->update_connection_status(
+                            status_check_start_time,
+                            current_time,
+                            status.is_valid);
+                    }
+
+                    if (context->is_active_context() && context->is_node_unhealthy()) {
+                        node_unhealthy = true;
+                    }
+                    const auto context_node_keys = context->get_node_keys();
+                    node_keys.insert(context_node_keys.begin(), context_node_keys.end());
                 }
             }
+            this->update_node_health(node_unhealthy, status.is_valid, node_keys);
 
             std::chrono::milliseconds check_interval = this->get_connection_check_interval();
-            auto sleep_time = check_interval - status.elapsed_time;
-            if (sleep_time > std::chrono::milliseconds(0)) {
-                std::this_thread::sleep_for(sleep_time);
+            if (check_interval == (std::chrono::milliseconds::max)()) {
+                // All contexts were cleared while checking the connection
+                next_run_delay = std::chrono::milliseconds(0);
+            } else {
+                next_run_delay = (std::max)(check_interval - status.elapsed_time, std::chrono::milliseconds(0));
             }
+            return true;
         }
-        else {
-            auto time_inactive = std::chrono::duration_cast<std::chrono::milliseconds>(this->get_current_time() - this->last_context_timestamp);
-            if (time_inactive >= this->disposal_time) {
-                break;
-            }
-            std::this_thread::sleep_for(thread_sleep_when_inactive);
+
+        if (have_contexts) {
+            this->last_context_timestamp = this->get_current_time();
+            next_run_delay = (std::chrono::milliseconds::max)();
+            return true;
+        }
+
+        auto time_inactive = std::chrono::duration_cast<std::chrono::milliseconds>(this->get_current_time() - this->last_context_timestamp);
+        if (time_inactive < this->disposal_time) {
+            next_run_delay = this->disposal_time - time_inactive;
+            return true;
         }
     }
 
+    this->clear_contexts();
+    this->update_node_health(false, true, {});
     service->notify_unused(shared_from_this());
 
     this->stopped = true;
+    return false;
 }
 
 std::chrono::milliseconds MONITOR::get_connection_check_interval() {
@@ -211,11 +370,136 @@ CONNECTION_STATUS MONITOR::check_connection_status() {
     };
 }
 
-bool MONITOR::connect() {
+// Start or continue a non-blocking ping of the server. Returns false while the reply is still
+// outstanding, otherwise fills in the status of the completed check. A ping that takes longer
+// than the failure detection timeout fails the check and drops the monitoring connection so
+// that the next check reconnects. Reconnecting is done on another thread, the check is polled
+// the same way until the connection is open, fails, or takes longer than the timeout.
+bool MONITOR::poll_connection_status(CONNECTION_STATUS& status) {
+    if (!this->ping_in_progress && !this->connect_attempt) {
+        this->status_check_start_time = this->get_current_time();
+        if (this->connection_proxy == nullptr || !this->connection_proxy->is_connected()) {
+            this->start_connect();
+        } else {
+            this->ping_in_progress = true;
+        }
+    }
+
+    const auto timeout = this->failure_detection_timeout.count() == 0
+        ? std::chrono::seconds(failure_detection_timeout_default)
+        : this->failure_detection_timeout;
+
+    if (this->connect_attempt) {
+        CONNECTION_PROXY* connection = nullptr;
+        const bool completed = this->poll_connect(connection);
+        const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            this->get_current_time() - this->status_check_start_time);
+        if (!completed) {
+            if (elapsed_time < timeout) {
+                return false;
+            }
+
+            MYLOG_TRACE(
+                this->logger, 0,
+                "[MONITOR] Connecting to %s timed out after %d ms",
+                this->host->get_host().c_str(), static_cast<int>(elapsed_time.count()));
+            this->abandon_connect();
+        }
+
+        this->connection_proxy = connection;
+        status = CONNECTION_STATUS{ connection != nullptr && connection->is_connected(), elapsed_time };
+        return true;
+    }
+
+    const net_async_status result = this->connection_proxy->ping_nonblocking();
+    const auto current_time = this->get_current_time();
+    const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        current_time - this->status_check_start_time);
+
+    if (result == NET_ASYNC_COMPLETE) {
+        this->phi_detector.add_sample(current_time - this->status_check_start_time);
+    }
+
+    if (result == NET_ASYNC_NOT_READY) {
+        // With phi accrual detection, give up on the probe once the node is suspected
+        const bool suspected = this->use_phi_detection() && this->get_suspicion_level(current_time) >= this->phi_threshold;
+        if (elapsed_time < timeout && !suspected) {
+            return false;
+        }
+
+        MYLOG_TRACE(
+            this->logger, 0,
+            "[MONITOR] Ping to %s timed out after %d ms",
+            this->host->get_host().c_str(), static_cast<int>(elapsed_time.count()));
+        this->close_connection();
+    }
+
+    this->ping_in_progress = false;
+    status = CONNECTION_STATUS{ result == NET_ASYNC_COMPLETE, elapsed_time };
+    return true;
+}
+
+void MONITOR::close_connection() {
     if (this->connection_proxy) {
         this->connection_proxy->close();
         delete this->connection_proxy;
+        this->connection_proxy = nullptr;
+    }
+}
+
+// Publish the node's health to the other connections. A node is marked unhealthy once one of
+// the armed contexts declares it dead, and healthy again after the next successful check.
+void MONITOR::update_node_health(bool node_unhealthy, bool is_valid, const std::set<std::string>& node_keys) {
+    if (node_unhealthy && this->unhealthy_node_keys.empty() && !node_keys.empty()) {
+        MYLOG_TRACE(
+            this->logger, 0,
+            "[MONITOR] Marking node %s as unhealthy for all connections", this->host->get_host_port_pair().c_str());
+        this->unhealthy_node_keys = node_keys;
+        this->node_health_table->set_node_unhealthy(this->unhealthy_node_keys, true);
+    } else if (is_valid && !this->unhealthy_node_keys.empty()) {
+        MYLOG_TRACE(
+            this->logger, 0,
+            "[MONITOR] Node %s is reachable again", this->host->get_host_port_pair().c_str());
+        this->node_health_table->set_node_unhealthy(this->unhealthy_node_keys, false);
+        this->unhealthy_node_keys.clear();
+    }
+}
+
+// Phi accrual detection only kicks in once enough round-trip times have been observed,
+// the failure count is used until then.
+bool MONITOR::use_phi_detection() {
+    return this->phi_threshold > 0 && this->phi_detector.has_enough_samples();
+}
+
+// Suspicion level for the node based on how long it has gone without answering.
+// That is the time since the start of the first failed check, or of the ongoing one.
+// The node may pause for up to the shortest detection interval without being suspected.
+double MONITOR::get_suspicion_level(std::chrono::steady_clock::time_point current_time) {
+    const auto since = this->unresponsive_since != std::chrono::steady_clock::time_point{}
+        ? this->unresponsive_since
+        : this->status_check_start_time;
+
+    auto detection_interval = this->get_connection_check_interval();
+    if (detection_interval == (std::chrono::milliseconds::max)()) {
+        detection_interval = std::chrono::milliseconds(0);
+    }
+    return this->phi_detector.phi(current_time - since, detection_interval);
+}
+
+bool MONITOR::connect() {
+    this->prepare_connect();
+
+    this->connection_proxy = this->connection_handler->connect_background(this->host, this->ds, true);
+    if (!this->connection_proxy) {
+        return false;
     }
+
+    return this->connection_proxy->is_connected();
+}
+
+void MONITOR::prepare_connect() {
+    this->abandon_connect();
+    this->close_connection();
     // Timeout shouldn't be 0 by now, but double check just in case
     unsigned int timeout_sec = this->failure_detection_timeout.count() == 0 ? failure_detection_timeout_default : this->failure_detection_timeout.count();
 
@@ -230,13 +514,74 @@ bool MONITOR::connect() {
     }
 
     this->ds->opt_ENABLE_FAILURE_DETECTION= false;
+}
 
-    this->connection_proxy = this->connection_handler->connect(this->host, this->ds, true);
-    if (!this->connection_proxy) {
+// Opens the monitoring connection on the connect executor, see poll_connect()
+void MONITOR::start_connect() {
+    this->prepare_connect();
+
+    auto attempt = std::make_shared<CONNECT_ATTEMPT>();
+    // The monitor may be disposed of before the connect completes
+    auto connect_ds = std::make_shared<DataSource>();
+    connect_ds->copy(this->ds);
+    const auto host = this->host;
+    const auto connection_handler = this->connection_handler;
+
+    this->connect_attempt = attempt;
+    get_connect_executor().submit([attempt, connect_ds, host, connection_handler](int id) {
+        CONNECTION_PROXY* connection = connection_handler->connect_background(host, connect_ds.get(), true);
+
+        std::unique_lock<std::mutex> lock(attempt->mutex_);
+        if (!attempt->abandoned) {
+            attempt->connection_proxy = connection;
+            attempt->completed = true;
+            return;
+        }
+        lock.unlock();
+
+        if (connection) {
+            connection->close();
+            connection->delete_ds();
+            delete connection;
+        }
+    });
+}
+
+// Returns whether the connect started by start_connect() completed, and if so hands over the connection
+bool MONITOR::poll_connect(CONNECTION_PROXY*& connection) {
+    std::unique_lock<std::mutex> lock(this->connect_attempt->mutex_);
+    if (!this->connect_attempt->completed) {
         return false;
     }
 
-    return this->connection_proxy->is_connected();
+    connection = this->connect_attempt->connection_proxy;
+    this->connect_attempt->connection_proxy = nullptr;
+    lock.unlock();
+
+    this->connect_attempt.reset();
+    return true;
+}
+
+// Stops waiting for the connect in progress, the connection is closed once it completes
+void MONITOR::abandon_connect() {
+    if (!this->connect_attempt) {
+        return;
+    }
+
+    CONNECTION_PROXY* connection = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(this->connect_attempt->mutex_);
+        this->connect_attempt->abandoned = true;
+        connection = this->connect_attempt->connection_proxy;
+        this->connect_attempt->connection_proxy = nullptr;
+    }
+    this->connect_attempt.reset();
+
+    if (connection) {
+        connection->close();
+        connection->delete_ds();
+        delete connection;
+    }
 }
 
 std::chrono::milliseconds MONITOR::find_shortest_interval() {
@@ -31,10 +31,14 @@
 #define __MONITOR_H__
 
 #include "connection_handler.h"
+#include "failover_executor.h"
 #include "host_info.h"
 #include "monitor_connection_context.h"
+#include "node_health_table.h"
+#include "phi_accrual_detector.h"
 
 #include <atomic>
+#include <condition_variable>
 #include <list>
 
 struct CONNECTION_STATUS {
@@ -44,11 +48,16 @@ struct CONNECTION_STATUS {
 
 class DataSource;
 class MONITOR_SERVICE;
+class MONITOR_THREAD_CONTAINER;
 class CONNECTION_PROXY;
 
 namespace {
-    const std::chrono::milliseconds thread_sleep_when_inactive = std::chrono::milliseconds(100);
     const unsigned int failure_detection_timeout_default = 5;
+    // How often the scheduler polls a ping that is still waiting for the server's reply
+    const auto ping_poll_interval = std::chrono::milliseconds(10);
+    // Threads opening monitoring connections at a time, and in total
+    const size_t monitor_connect_parallelism = 16;
+    const size_t monitor_connect_max_threads = 64;
 }
 
 class MONITOR : public std::enable_shared_from_this<MONITOR> {
@@ -75,10 +84,22 @@ public:
     virtual bool is_stopped();
     virtual void clear_contexts();
     virtual void run(std::shared_ptr<MONITOR_SERVICE> service);
+    virtual bool run_once(std::shared_ptr<MONITOR_SERVICE> service, std::chrono::milliseconds& next_run_delay);
+    void start();
     void stop();
+    void wake();
+    void wake_if_idle();
+    void set_thread_container(std::weak_ptr<MONITOR_THREAD_CONTAINER> container);
 
 private:
     std::atomic_bool stopped{ true };
+    // Set while the monitor has no armed contexts and is parked by its scheduler,
+    // cleared by the first context armed
+    std::atomic_bool idle{ false };
+    bool wake_requested = false;
+    std::weak_ptr<MONITOR_THREAD_CONTAINER> thread_container;
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
     std::shared_ptr<HOST_INFO> host;
     std::shared_ptr<CONNECTION_HANDLER> connection_handler;
     std::chrono::milliseconds connection_check_interval;
@@ -86,6 +107,25 @@ private:
     std::chrono::milliseconds disposal_time;
     std::list<std::shared_ptr<MONITOR_CONNECTION_CONTEXT>> contexts;
     std::chrono::steady_clock::time_point last_context_timestamp;
+    bool ping_in_progress = false;
+    std::chrono::steady_clock::time_point status_check_start_time;
+    // Monitoring connection being opened off the scheduler threads
+    struct CONNECT_ATTEMPT {
+        std::mutex mutex_;
+        bool completed = false;
+        // Set once the monitor no longer waits for the connection, which is then closed
+        bool abandoned = false;
+        CONNECTION_PROXY* connection_proxy = nullptr;
+    };
+    std::shared_ptr<CONNECT_ATTEMPT> connect_attempt;
+    std::shared_ptr<NODE_HEALTH_TABLE> node_health_table;
+    // Phi accrual failure detection, used instead of the failure count when the threshold isn't 0
+    PHI_ACCRUAL_DETECTOR phi_detector;
+    double phi_threshold = 0;
+    // Start of the check the node first failed to answer, unset while the node answers
+    std::chrono::steady_clock::time_point unresponsive_since;
+    // Node keys this monitor has marked unhealthy in the node health table
+    std::set<std::string> unhealthy_node_keys;
     CONNECTION_PROXY* connection_proxy = nullptr;
     DataSource* ds = nullptr;
     std::shared_ptr<FILE> logger;
@@ -93,7 +133,16 @@ private:
 
     std::chrono::milliseconds get_connection_check_interval();
     CONNECTION_STATUS check_connection_status();
+    bool poll_connection_status(CONNECTION_STATUS& status);
+    void close_connection();
+    void update_node_health(bool node_unhealthy, bool is_valid, const std::set<std::string>& node_keys);
+    bool use_phi_detection();
+    double get_suspicion_level(std::chrono::steady_clock::time_point current_time);
     bool connect();
+    void prepare_connect();
+    void start_connect();
+    bool poll_connect(CONNECTION_PROXY*& connection);
+    void abandon_connect();
     std::chrono::milliseconds find_shortest_interval();
     virtual std::chrono::steady_clock::time_point get_current_time();
 
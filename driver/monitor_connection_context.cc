@@ -29,6 +29,7 @@
 
 #include "monitor_connection_context.h"
 #include "driver.h"
+#include "monitor.h"
 
 #include <algorithm>
 #include <mutex>
@@ -52,11 +53,11 @@ MONITOR_CONNECTION_CONTEXT::MONITOR_CONNECTION_CONTEXT(DBC* connection_to_abort,
 MONITOR_CONNECTION_CONTEXT::~MONITOR_CONNECTION_CONTEXT() {}
 
 std::chrono::steady_clock::time_point MONITOR_CONNECTION_CONTEXT::get_start_monitor_time() {
-    return start_monitor_time;
+    return start_monitor_time.load();
 }
 
 void MONITOR_CONNECTION_CONTEXT::set_start_monitor_time(std::chrono::steady_clock::time_point time) {
-    start_monitor_time = time;
+    start_monitor_time.store(time);
 }
 
 std::set<std::string> MONITOR_CONNECTION_CONTEXT::get_node_keys() {
@@ -76,11 +77,11 @@ int MONITOR_CONNECTION_CONTEXT::get_failure_detection_count() {
 }
 
 int MONITOR_CONNECTION_CONTEXT::get_failure_count() {
-    return failure_count;
+    return failure_count.load();
 }
 
 void MONITOR_CONNECTION_CONTEXT::set_failure_count(int count) {
-    failure_count = count;
+    failure_count.store(count);
 }
 
 void MONITOR_CONNECTION_CONTEXT::increment_failure_count() {
@@ -88,29 +89,29 @@ void MONITOR_CONNECTION_CONTEXT::increment_failure_count() {
 }
 
 void MONITOR_CONNECTION_CONTEXT::set_invalid_node_start_time(std::chrono::steady_clock::time_point time) {
-    invalid_node_start_time = time;
+    invalid_node_start_time.store(time);
 }
 
 void MONITOR_CONNECTION_CONTEXT::reset_invalid_node_start_time() {
     std::chrono::steady_clock::time_point timestamp_zero{};
-    invalid_node_start_time = timestamp_zero;
+    invalid_node_start_time.store(timestamp_zero);
 }
 
 bool MONITOR_CONNECTION_CONTEXT::is_invalid_node_start_time_defined() {
     std::chrono::steady_clock::time_point timestamp_zero{};
-    return invalid_node_start_time > timestamp_zero;
+    return invalid_node_start_time.load() > timestamp_zero;
 }
 
 std::chrono::steady_clock::time_point MONITOR_CONNECTION_CONTEXT::get_invalid_node_start_time() {
-    return invalid_node_start_time;
+    return invalid_node_start_time.load();
 }
 
 bool MONITOR_CONNECTION_CONTEXT::is_node_unhealthy() {
-    return node_unhealthy;
+    return node_unhealthy.load();
 }
 
 void MONITOR_CONNECTION_CONTEXT::set_node_unhealthy(bool node) {
-    node_unhealthy = node;
+    node_unhealthy.store(node);
 }
 
 bool MONITOR_CONNECTION_CONTEXT::is_active_context() {
@@ -121,6 +122,32 @@ void MONITOR_CONNECTION_CONTEXT::invalidate() {
     active_context.store(false);
 }
 
+// Re-activate a context that was previously invalidated so it can be reused for
+// another monitored call without going through the monitor service again.
+void MONITOR_CONNECTION_CONTEXT::arm(std::chrono::steady_clock::time_point time) {
+    set_failure_count(0);
+    reset_invalid_node_start_time();
+    set_node_unhealthy(false);
+    set_start_monitor_time(time);
+    active_context.store(true);
+
+    if (const auto registered_monitor = monitor.lock()) {
+        registered_monitor->wake_if_idle();
+    }
+}
+
+bool MONITOR_CONNECTION_CONTEXT::is_registered() {
+    return registered.load();
+}
+
+void MONITOR_CONNECTION_CONTEXT::set_registered(bool registered) {
+    this->registered.store(registered);
+}
+
+void MONITOR_CONNECTION_CONTEXT::set_monitor(std::weak_ptr<MONITOR> monitor) {
+    this->monitor = std::move(monitor);
+}
+
 DBC* MONITOR_CONNECTION_CONTEXT::get_connection_to_abort() {
     return connection_to_abort;
 }
@@ -183,6 +210,58 @@ void MONITOR_CONNECTION_CONTEXT::set_connection_valid(
     MYLOG_TRACE(logger, get_dbc_id(), "[MONITOR_CONNECTION_CONTEXT] Node '%s' is *alive*.", node_keys_str.c_str());
 }
 
+// Used instead of update_connection_status() when the monitor runs the phi accrual failure
+// detector. The node is deemed dead once the suspicion level reaches the threshold, but no
+// sooner than the failure interval and count allow, so a single slow probe doesn't abort
+// the connection.
+void MONITOR_CONNECTION_CONTEXT::update_connection_suspicion(
+    std::chrono::steady_clock::time_point status_check_start_time,
+    std::chrono::steady_clock::time_point current_time,
+    bool is_valid,
+    double suspicion_level,
+    double suspicion_threshold) {
+
+    if (!is_active_context()) {
+      return;
+    }
+
+    auto total_elapsed_time = current_time - get_start_monitor_time();
+    if (total_elapsed_time <= get_failure_detection_time()) {
+      return;
+    }
+
+    const auto node_keys_str = build_node_keys_str();
+    if (!is_valid) {
+        increment_failure_count();
+
+        if (!is_invalid_node_start_time_defined()) {
+            set_invalid_node_start_time(status_check_start_time);
+        }
+
+        const auto invalid_node_duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - get_invalid_node_start_time());
+        const auto min_invalid_node_duration = get_failure_detection_interval() * (std::max)(0, get_failure_detection_count());
+
+        if (suspicion_level >= suspicion_threshold && invalid_node_duration_ms >= min_invalid_node_duration) {
+            MYLOG_TRACE(
+                logger, get_dbc_id(),
+                "[MONITOR_CONNECTION_CONTEXT] Node '%s' is *dead* (phi %.2f).", node_keys_str.c_str(), suspicion_level);
+            set_node_unhealthy(true);
+            abort_connection();
+            return;
+        }
+
+        MYLOG_TRACE(
+            logger, get_dbc_id(),
+            "[MONITOR_CONNECTION_CONTEXT] Node '%s' is *not responding* (phi %.2f).", node_keys_str.c_str(), suspicion_level);
+        return;
+    }
+
+    set_failure_count(0);
+    reset_invalid_node_start_time();
+    set_node_unhealthy(false);
+    MYLOG_TRACE(logger, get_dbc_id(), "[MONITOR_CONNECTION_CONTEXT] Node '%s' is *alive*.", node_keys_str.c_str());
+}
+
 void MONITOR_CONNECTION_CONTEXT::abort_connection() {
     std::lock_guard<std::mutex> lock(mutex_);
     if ((!get_connection_to_abort()) || (!is_active_context())) {
@@ -38,6 +38,7 @@
 #include <string>
 
 struct DBC;
+class MONITOR;
 
 // Monitoring context for each connection. This contains each connection's criteria for
 // whether a server should be considered unhealthy.
@@ -68,6 +69,10 @@ public:
     void set_node_unhealthy(bool node);
     bool is_active_context();
     void invalidate();
+    void arm(std::chrono::steady_clock::time_point time);
+    bool is_registered();
+    void set_registered(bool registered);
+    void set_monitor(std::weak_ptr<MONITOR> monitor);
     DBC* get_connection_to_abort();
     unsigned long get_dbc_id();
 
@@ -79,6 +84,12 @@ public:
         bool connection_valid,
         std::chrono::steady_clock::time_point status_check_start_time,
         std::chrono::steady_clock::time_point current_time);
+    void update_connection_suspicion(
+        std::chrono::steady_clock::time_point status_check_start_time,
+        std::chrono::steady_clock::time_point current_time,
+        bool is_valid,
+        double suspicion_level,
+        double suspicion_threshold);
     void abort_connection();
 
 private:
@@ -90,12 +101,17 @@ private:
 
     std::set<std::string> node_keys;
     DBC* connection_to_abort;
+    // Set once when the context is registered, used to wake up an idle monitor
+    std::weak_ptr<MONITOR> monitor;
 
-    std::chrono::steady_clock::time_point start_monitor_time;
-    std::chrono::steady_clock::time_point invalid_node_start_time;
-    int failure_count;
-    bool node_unhealthy;
+    // Contexts are reused across calls and re-armed by the connection thread
+    // while the monitor thread updates them, so all mutable state is atomic.
+    std::atomic<std::chrono::steady_clock::time_point> start_monitor_time{ std::chrono::steady_clock::time_point{} };
+    std::atomic<std::chrono::steady_clock::time_point> invalid_node_start_time{ std::chrono::steady_clock::time_point{} };
+    std::atomic_int failure_count;
+    std::atomic_bool node_unhealthy;
     std::atomic_bool active_context{ true };
+    std::atomic_bool registered{ false };
     std::shared_ptr<FILE> logger;
 
     std::string build_node_keys_str();
@@ -43,6 +43,17 @@ std::shared_ptr<MONITOR_THREAD_CONTAINER> MONITOR_THREAD_CONTAINER::get_instance
     return singleton;
 }
 
+MONITOR_THREAD_CONTAINER::~MONITOR_THREAD_CONTAINER() {
+    this->stop_scheduler();
+
+    WOKEN_TASK* woken = this->woken_tasks.exchange(nullptr);
+    while (woken) {
+        WOKEN_TASK* next = woken->next;
+        delete woken;
+        woken = next;
+    }
+}
+
 void MONITOR_THREAD_CONTAINER::release_instance() {
     if (!singleton) {
         return;
@@ -54,13 +65,10 @@ void MONITOR_THREAD_CONTAINER::release_instance() {
 }
 
 std::string MONITOR_THREAD_CONTAINER::get_node(std::set<std::string> node_keys) {
-    std::unique_lock<std::mutex> lock(monitor_map_mutex);
-    if (!this->monitor_map.empty()) {
-        for (auto it = node_keys.begin(); it != node_keys.end(); ++it) {
-            std::string node = *it;
-            if (this->monitor_map.count(node) > 0) {
-                return node;
-            }
+    for (auto it = node_keys.begin(); it != node_keys.end(); ++it) {
+        std::string node = *it;
+        if (this->get_monitor(node) != nullptr) {
+            return node;
         }
     }
 
@@ -68,8 +76,9 @@ std::string MONITOR_THREAD_CONTAINER::get_node(std::set<std::string> node_keys)
 }
 
 std::shared_ptr<MONITOR> MONITOR_THREAD_CONTAINER::get_monitor(std::string node) {
-    std::unique_lock<std::mutex> lock(monitor_map_mutex);
-    return this->monitor_map.count(node) > 0 ? this->monitor_map.at(node) : nullptr;
+    const auto monitors = std::atomic_load(&this->get_shard(node).monitors);
+    const auto it = monitors->find(node);
+    return it != monitors->end() ? it->second : nullptr;
 }
 
 std::shared_ptr<MONITOR> MONITOR_THREAD_CONTAINER::get_or_create_monitor(
@@ -83,13 +92,19 @@ std::shared_ptr<MONITOR> MONITOR_THREAD_CONTAINER::get_or_create_monitor(
 
     std::shared_ptr<MONITOR> monitor;
 
-    std::unique_lock<std::mutex> lock(mutex_);
+    // Connections to a node that is already monitored don't need to serialize on mutex_
     std::string node = this->get_node(node_keys);
     if (!node.empty()) {
-        std::unique_lock<std::mutex> lock(monitor_map_mutex);
-        monitor = this->monitor_map[node];
+        monitor = this->get_monitor(node);
+        if (monitor != nullptr && this->is_mapped_to(node_keys, monitor)) {
+            return monitor;
+        }
     }
-    else {
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    node = this->get_node(node_keys);
+    monitor = node.empty() ? nullptr : this->get_monitor(node);
+    if (monitor == nullptr) {
         monitor = this->get_available_monitor();
         if (monitor == nullptr) {
             monitor = this->create_monitor(std::move(host), std::move(connection_handler), failure_detection_timeout, disposal_time, ds, enable_logging);
@@ -108,9 +123,68 @@ void MONITOR_THREAD_CONTAINER::add_task(const std::shared_ptr<MONITOR>& monitor,
 
     std::unique_lock<std::mutex> lock(task_map_mutex);
     if (this->task_map.count(monitor) == 0) {
-        this->thread_pool.resize(this->thread_pool.size() + 1);
-        auto run_monitor = [monitor, service](int id) { monitor->run(service); };
-        this->task_map[monitor] = this->thread_pool.push(run_monitor);
+        if (!this->scheduler_started) {
+            this->scheduler_started = true;
+            this->thread_pool.resize(monitor_scheduler_threads);
+            for (int i = 0; i < monitor_scheduler_threads; i++) {
+                this->thread_pool.push([this](int id) { this->run_scheduler(); });
+            }
+        }
+
+        monitor->start();
+        monitor->set_thread_container(shared_from_this());
+
+        MONITOR_TASK& task = this->task_map[monitor];
+        task.service = service;
+        this->schedule_task(task, monitor, std::chrono::milliseconds(0));
+    }
+}
+
+void MONITOR_THREAD_CONTAINER::wake_task(const std::shared_ptr<MONITOR>& monitor) {
+    std::unique_lock<std::mutex> lock(task_map_mutex);
+    auto it = this->task_map.find(monitor);
+    if (it == this->task_map.end()) {
+        return;
+    }
+
+    // A running monitor gets rescheduled right away once its current run completes
+    if (it->second.running) {
+        it->second.wake_requested = true;
+        return;
+    }
+
+    this->schedule_task(it->second, monitor, std::chrono::milliseconds(0));
+}
+
+void MONITOR_THREAD_CONTAINER::wake_parked_task(const std::shared_ptr<MONITOR>& monitor) {
+    WOKEN_TASK* woken = new WOKEN_TASK{monitor};
+    woken->next = this->woken_tasks.load();
+    while (!this->woken_tasks.compare_exchange_weak(woken->next, woken)) {}
+
+    // A scheduler thread that missed the push holds the lock until it waits, so the notify can't be lost.
+    // Only the first call since the monitor was parked gets here, so this doesn't lock every monitored call.
+    {
+        std::lock_guard<std::mutex> lock(task_map_mutex);
+    }
+    this->scheduler_cv.notify_one();
+}
+
+// Must be called with task_map_mutex held.
+void MONITOR_THREAD_CONTAINER::schedule_woken_tasks() {
+    WOKEN_TASK* woken = this->woken_tasks.exchange(nullptr);
+    while (woken) {
+        auto it = this->task_map.find(woken->monitor);
+        if (it != this->task_map.end()) {
+            if (it->second.running) {
+                it->second.wake_requested = true;
+            } else {
+                this->schedule_task(it->second, woken->monitor, std::chrono::milliseconds(0));
+            }
+        }
+
+        WOKEN_TASK* next = woken->next;
+        delete woken;
+        woken = next;
     }
 }
 
@@ -132,38 +206,149 @@ void MONITOR_THREAD_CONTAINER::release_resource(std::shared_ptr<MONITOR> monitor
 
     this->remove_monitor_mapping(monitor);
 
-    {
-        std::unique_lock<std::mutex> lock(task_map_mutex);
-        if (this->task_map.count(monitor) > 0) {
-            this->task_map.erase(monitor);
+    std::unique_lock<std::mutex> lock(task_map_mutex);
+    if (this->task_map.count(monitor) > 0) {
+        this->task_map.erase(monitor);
+    }
+}
+
+// Must be called with task_map_mutex held.
+void MONITOR_THREAD_CONTAINER::schedule_task(
+    MONITOR_TASK& task, const std::shared_ptr<MONITOR>& monitor, std::chrono::milliseconds delay) {
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto max_delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        (std::chrono::steady_clock::time_point::max)() - now);
+    if (delay >= max_delay) {
+        task.next_run = (std::chrono::steady_clock::time_point::max)();
+        return;
+    }
+
+    task.next_run = now + delay;
+    this->task_queue.emplace(task.next_run, monitor);
+    this->scheduler_cv.notify_one();
+}
+
+// Scheduler loop run by each of the shared monitor threads. Runs every monitor whose next
+// check is due and sleeps until the earliest upcoming check or until a monitor is woken up.
+void MONITOR_THREAD_CONTAINER::run_scheduler() {
+    std::unique_lock<std::mutex> lock(task_map_mutex);
+    while (!this->scheduler_stopped) {
+        this->schedule_woken_tasks();
+
+        if (this->task_queue.empty()) {
+            this->scheduler_cv.wait(lock);
+            continue;
+        }
+
+        const SCHEDULED_RUN next = this->task_queue.top();
+        if (next.first > std::chrono::steady_clock::now()) {
+            this->scheduler_cv.wait_until(lock, next.first);
+            continue;
+        }
+        this->task_queue.pop();
+
+        auto it = this->task_map.find(next.second);
+        if (it == this->task_map.end() || it->second.running || it->second.next_run != next.first) {
+            continue;
         }
+
+        std::shared_ptr<MONITOR> monitor = next.second;
+        std::shared_ptr<MONITOR_SERVICE> service = it->second.service;
+        it->second.running = true;
+        it->second.wake_requested = false;
+
+        lock.unlock();
+        std::chrono::milliseconds next_run_delay(0);
+        const bool keep_running = monitor->run_once(service, next_run_delay);
+        lock.lock();
+
+        // The monitor is no longer tracked once it has been disposed of
+        it = this->task_map.find(monitor);
+        if (it == this->task_map.end()) {
+            continue;
+        }
+
+        it->second.running = false;
+        if (!keep_running) {
+            continue;
+        }
+
+        if (it->second.wake_requested) {
+            next_run_delay = std::chrono::milliseconds(0);
+        }
+        this->schedule_task(it->second, monitor, next_run_delay);
     }
+}
 
-    if (this->thread_pool.n_idle() > 0) {
-        this->thread_pool.resize(this->thread_pool.size() - 1);
+void MONITOR_THREAD_CONTAINER::stop_scheduler() {
+    {
+        std::unique_lock<std::mutex> lock(task_map_mutex);
+        this->scheduler_stopped = true;
     }
+    this->scheduler_cv.notify_all();
+
+    // Wait for scheduler threads to finish
+    this->thread_pool.stop(true);
 }
 
 void MONITOR_THREAD_CONTAINER::populate_monitor_map(
     std::set<std::string> node_keys, const std::shared_ptr<MONITOR>& monitor) {
 
     for (auto it = node_keys.begin(); it != node_keys.end(); ++it) {
-        std::unique_lock<std::mutex> lock(monitor_map_mutex);
-        this->monitor_map[*it] = monitor;
+        MONITOR_MAP_SHARD& shard = this->get_shard(*it);
+        std::unique_lock<std::mutex> lock(shard.write_mutex);
+        const auto existing = shard.monitors->find(*it);
+        if (existing != shard.monitors->end() && existing->second == monitor) {
+            continue;
+        }
+
+        auto monitors = std::make_shared<MONITOR_MAP>(*shard.monitors);
+        (*monitors)[*it] = monitor;
+        std::atomic_store(&shard.monitors, std::shared_ptr<const MONITOR_MAP>(std::move(monitors)));
     }
 }
 
 void MONITOR_THREAD_CONTAINER::remove_monitor_mapping(const std::shared_ptr<MONITOR>& monitor) {
-    std::unique_lock<std::mutex> lock(monitor_map_mutex);
-    for (auto it = this->monitor_map.begin(); it != this->monitor_map.end();) {
-        std::string node = (*it).first;
-        if (this->monitor_map[node] == monitor) {
-            it = this->monitor_map.erase(it);
+    for (auto& shard : this->monitor_map) {
+        std::unique_lock<std::mutex> lock(shard.write_mutex);
+        std::shared_ptr<MONITOR_MAP> monitors;
+        for (const auto& mapping : *shard.monitors) {
+            if (mapping.second == monitor) {
+                monitors = std::make_shared<MONITOR_MAP>(*shard.monitors);
+                break;
+            }
+        }
+        if (monitors == nullptr) {
+            continue;
+        }
+
+        for (auto it = monitors->begin(); it != monitors->end();) {
+            if (it->second == monitor) {
+                it = monitors->erase(it);
+            }
+            else {
+                ++it;
+            }
         }
-        else {
-            ++it;
+        std::atomic_store(&shard.monitors, std::shared_ptr<const MONITOR_MAP>(std::move(monitors)));
+    }
+}
+
+bool MONITOR_THREAD_CONTAINER::is_mapped_to(
+    const std::set<std::string>& node_keys, const std::shared_ptr<MONITOR>& monitor) {
+
+    for (const auto& node_key : node_keys) {
+        if (this->get_monitor(node_key) != monitor) {
+            return false;
         }
     }
+
+    return true;
+}
+
+MONITOR_MAP_SHARD& MONITOR_THREAD_CONTAINER::get_shard(const std::string& node_key) {
+    return this->monitor_map[std::hash<std::string>{}(node_key) % monitor_map_shard_count];
 }
 
 std::shared_ptr<MONITOR> MONITOR_THREAD_CONTAINER::get_available_monitor() {
@@ -211,17 +396,18 @@ void MONITOR_THREAD_CONTAINER::release_resources() {
         }
     }
 
-    // Wait for monitor threads to finish
-    this->thread_pool.stop(true);
+    this->stop_scheduler();
 
-    {
-        std::unique_lock<std::mutex> lock(monitor_map_mutex);
-        this->monitor_map.clear();
+    for (auto& shard : this->monitor_map) {
+        std::unique_lock<std::mutex> lock(shard.write_mutex);
+        std::atomic_store(&shard.monitors, std::shared_ptr<const MONITOR_MAP>(std::make_shared<MONITOR_MAP>()));
     }
 
     {
         std::unique_lock<std::mutex> lock(task_map_mutex);
         this->task_map.clear();
+        std::priority_queue<SCHEDULED_RUN, std::vector<SCHEDULED_RUN>, std::greater<SCHEDULED_RUN>> empty;
+        std::swap(task_queue, empty);
     }
 
     {
@@ -33,16 +33,53 @@
 #include "connection_handler.h"
 #include "monitor.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <ctpl_stl.h>
-#include <future>
 #include <map>
 #include <queue>
+#include <unordered_map>
 
-class MONITOR_THREAD_CONTAINER {
+namespace {
+    // Number of threads shared by all monitors to run their connection checks
+    const int monitor_scheduler_threads = 4;
+    // Number of independently locked partitions of the node key to monitor mapping
+    const int monitor_map_shard_count = 16;
+}
+
+typedef std::unordered_map<std::string, std::shared_ptr<MONITOR>> MONITOR_MAP;
+
+// Partition of the node key to monitor mapping. Lookups load the current map snapshot without
+// taking write_mutex, writers copy it under write_mutex and publish the modified copy. Mappings change when a
+// connection starts being monitored or a monitor is disposed of, while they are read for
+// every new monitored connection.
+struct MONITOR_MAP_SHARD {
+    std::shared_ptr<const MONITOR_MAP> monitors = std::make_shared<MONITOR_MAP>();
+    std::mutex write_mutex;
+};
+
+// Scheduling state of a monitor driven by the MONITOR_THREAD_CONTAINER scheduler.
+struct MONITOR_TASK {
+    std::shared_ptr<MONITOR_SERVICE> service;
+    // time_point::max() while the monitor is idle and waiting to be woken up
+    std::chrono::steady_clock::time_point next_run;
+    bool running = false;
+    bool wake_requested = false;
+};
+
+typedef std::pair<std::chrono::steady_clock::time_point, std::shared_ptr<MONITOR>> SCHEDULED_RUN;
+
+// Monitor woken up while parked, in a list pushed to without locking
+struct WOKEN_TASK {
+    std::shared_ptr<MONITOR> monitor;
+    WOKEN_TASK* next = nullptr;
+};
+
+class MONITOR_THREAD_CONTAINER : public std::enable_shared_from_this<MONITOR_THREAD_CONTAINER> {
 public:
     MONITOR_THREAD_CONTAINER(MONITOR_THREAD_CONTAINER const&) = delete;
     MONITOR_THREAD_CONTAINER& operator=(MONITOR_THREAD_CONTAINER const&) = delete;
-    virtual ~MONITOR_THREAD_CONTAINER() = default;
+    virtual ~MONITOR_THREAD_CONTAINER();
     std::string get_node(std::set<std::string> node_keys);
     std::shared_ptr<MONITOR> get_monitor(std::string node);
     std::shared_ptr<MONITOR> get_or_create_monitor(
@@ -54,6 +91,9 @@ public:
         std::shared_ptr<CONNECTION_HANDLER> connection_handler,
         bool enable_logging = false);
     virtual void add_task(const std::shared_ptr<MONITOR>& monitor, const std::shared_ptr<MONITOR_SERVICE>& service);
+    void wake_task(const std::shared_ptr<MONITOR>& monitor);
+    // Same as wake_task() with task_map_mutex only held around the notify, for monitors woken up on monitored calls
+    void wake_parked_task(const std::shared_ptr<MONITOR>& monitor);
     void reset_resource(const std::shared_ptr<MONITOR>& monitor);
     void release_resource(std::shared_ptr<MONITOR> monitor);
 
@@ -64,6 +104,8 @@ protected:
     MONITOR_THREAD_CONTAINER() = default;
     void populate_monitor_map(std::set<std::string> node_keys, const std::shared_ptr<MONITOR>& monitor);
     void remove_monitor_mapping(const std::shared_ptr<MONITOR>& monitor);
+    bool is_mapped_to(const std::set<std::string>& node_keys, const std::shared_ptr<MONITOR>& monitor);
+    MONITOR_MAP_SHARD& get_shard(const std::string& node_key);
     std::shared_ptr<MONITOR> get_available_monitor();
     virtual std::shared_ptr<MONITOR> create_monitor(
         std::shared_ptr<HOST_INFO> host,
@@ -73,13 +115,24 @@ protected:
         DataSource* ds,
         bool enable_logging = false);
     void release_resources();
+    void run_scheduler();
+    void schedule_task(MONITOR_TASK& task, const std::shared_ptr<MONITOR>& monitor, std::chrono::milliseconds delay);
+    void schedule_woken_tasks();
+    void stop_scheduler();
 
-    std::map<std::string, std::shared_ptr<MONITOR>> monitor_map;
-    std::map<std::shared_ptr<MONITOR>, std::future<void>> task_map;
+    MONITOR_MAP_SHARD monitor_map[monitor_map_shard_count];
+    std::map<std::shared_ptr<MONITOR>, MONITOR_TASK> task_map;
+    // Min-heap of monitor runs ordered by time. Entries that no longer match
+    // the monitor's MONITOR_TASK::next_run are stale and skipped.
+    std::priority_queue<SCHEDULED_RUN, std::vector<SCHEDULED_RUN>, std::greater<SCHEDULED_RUN>> task_queue;
+    // Most recently woken up first, taken over by the scheduler threads
+    std::atomic<WOKEN_TASK*> woken_tasks{ nullptr };
     std::queue<std::shared_ptr<MONITOR>> available_monitors;
-    std::mutex monitor_map_mutex;
     std::mutex task_map_mutex;
     std::mutex available_monitors_mutex;
+    std::condition_variable scheduler_cv;
+    bool scheduler_started = false;
+    bool scheduler_stopped = false;
     ctpl::thread_pool thread_pool;
     std::mutex mutex_;
 
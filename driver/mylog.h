@@ -40,8 +40,11 @@
     if ((A)->dbc->ds->opt_LOG_QUERY)                                         \
       trace_print((A)->dbc->log_file, (A)->dbc->id, (const char *)B);       \
   }
-#define MYLOG_DBC_TRACE(A, ...) \
-  { trace_print_va_args((A)->log_file, (A)->id, __VA_ARGS__); }
+#define MYLOG_DBC_TRACE(A, ...)                                          \
+  {                                                                      \
+    if ((A) != nullptr)                                                  \
+      trace_print_va_args((A)->log_file, (A)->id, __VA_ARGS__);          \
+  }
 
 #define MYLOG_TRACE(A, B, ...)                                    \
   {                                                               \
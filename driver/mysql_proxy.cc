@@ -34,6 +34,8 @@
 
 namespace {
     const auto SOCKET_CLOSE_DELAY = std::chrono::milliseconds(100);
+    // Cheapest statement that makes a round trip to the server
+    const char PING_QUERY[] = "DO 1";
 }
 
 MYSQL_PROXY::MYSQL_PROXY(DBC* dbc, DataSource* ds) : CONNECTION_PROXY(dbc, ds) {
@@ -176,6 +178,12 @@ int MYSQL_PROXY::ping() {
     return mysql_ping(mysql);
 }
 
+// Send a ping without waiting for the reply. Keep calling until the status is
+// no longer NET_ASYNC_NOT_READY to collect the reply.
+net_async_status MYSQL_PROXY::ping_nonblocking() {
+    return mysql_real_query_nonblocking(mysql, PING_QUERY, sizeof(PING_QUERY) - 1);
+}
+
 int MYSQL_PROXY::get_option(mysql_option option, const void* arg) {
     return mysql_get_option(mysql, option, arg);
 }
@@ -395,7 +403,7 @@ MYSQL* MYSQL_PROXY::move_mysql_connection() {
 void MYSQL_PROXY::set_connection(CONNECTION_PROXY* connection_proxy) {
     close();
     this->mysql = connection_proxy->move_mysql_connection();
-    // delete the ds initialized in CONNECTION_HANDLER::clone_dbc()
+    // delete the proxy chain created by CONNECTION_HANDLER::connect()
     delete connection_proxy;
 }
 
@@ -411,3 +419,8 @@ void MYSQL_PROXY::close_socket() {
         MYLOG_DBC_TRACE(dbc, "closesocket() with return code: %d, error message: %s,", ret, strerror(socket_errno));
     }
 }
+
+bool MYSQL_PROXY::is_node_unhealthy() {
+    // Node health is only tracked when failure detection is enabled
+    return false;
+}
@@ -67,6 +67,7 @@ public:
     void get_character_set_info(MY_CHARSET_INFO* charset) override;
 
     int ping() override;
+    net_async_status ping_nonblocking() override;
     int options(enum mysql_option option, const void* arg) override;
     int options4(enum mysql_option option, const void* arg1,
         const void* arg2) override;
@@ -162,6 +163,8 @@ public:
 
     void close_socket() override;
 
+    bool is_node_unhealthy() override;
+
 private:
     MYSQL* mysql = nullptr;
     std::shared_ptr<HOST_INFO> host = nullptr;
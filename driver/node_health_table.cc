@@ -0,0 +1,56 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+#include "node_health_table.h"
+
+std::shared_ptr<NODE_HEALTH_TABLE> NODE_HEALTH_TABLE::get_instance() {
+    static const std::shared_ptr<NODE_HEALTH_TABLE> instance(new NODE_HEALTH_TABLE);
+    return instance;
+}
+
+NODE_HEALTH_ENTRY NODE_HEALTH_TABLE::get_entry(const std::string& node_key) {
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    auto& entry = this->entries[node_key];
+    if (!entry) {
+        entry = std::make_shared<std::atomic_bool>(false);
+    }
+    return entry;
+}
+
+void NODE_HEALTH_TABLE::set_node_unhealthy(const std::set<std::string>& node_keys, bool unhealthy) {
+    for (const auto& node_key : node_keys) {
+        this->get_entry(node_key)->store(unhealthy);
+    }
+}
+
+bool NODE_HEALTH_TABLE::is_node_unhealthy(const std::string& node_key) {
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    const auto it = this->entries.find(node_key);
+    return it != this->entries.end() && it->second->load();
+}
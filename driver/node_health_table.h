@@ -0,0 +1,64 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+#ifndef __NODEHEALTHTABLE_H__
+#define __NODEHEALTHTABLE_H__
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+typedef std::shared_ptr<std::atomic_bool> NODE_HEALTH_ENTRY;
+
+// Process-wide record of the nodes that enhanced failure monitoring found to be dead.
+// Monitors mark nodes unhealthy or healthy again; connections keep the entries of the
+// node they are connected to and check them with a single atomic load before sending
+// a query, instead of waiting for a network timeout on a node already known to be down.
+class NODE_HEALTH_TABLE {
+public:
+    NODE_HEALTH_TABLE(NODE_HEALTH_TABLE const&) = delete;
+    NODE_HEALTH_TABLE& operator=(NODE_HEALTH_TABLE const&) = delete;
+    static std::shared_ptr<NODE_HEALTH_TABLE> get_instance();
+
+    // Entries are never removed, so callers can hold on to them for the lifetime of their connection.
+    NODE_HEALTH_ENTRY get_entry(const std::string& node_key);
+    void set_node_unhealthy(const std::set<std::string>& node_keys, bool unhealthy);
+    bool is_node_unhealthy(const std::string& node_key);
+
+private:
+    NODE_HEALTH_TABLE() = default;
+
+    std::map<std::string, NODE_HEALTH_ENTRY> entries;
+    std::mutex entries_mutex;
+};
+
+#endif /* __NODEHEALTHTABLE_H__ */
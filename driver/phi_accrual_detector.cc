@@ -0,0 +1,86 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+#include "phi_accrual_detector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+PHI_ACCRUAL_DETECTOR::PHI_ACCRUAL_DETECTOR(size_t window_size) : window_size{(std::max)(window_size, static_cast<size_t>(1))} {
+    this->samples.reserve(this->window_size);
+}
+
+void PHI_ACCRUAL_DETECTOR::add_sample(std::chrono::duration<double, std::milli> round_trip_time) {
+    const double sample = round_trip_time.count();
+    if (this->samples.size() < this->window_size) {
+        this->samples.push_back(sample);
+    } else {
+        const double oldest = this->samples[this->next_sample];
+        this->sum -= oldest;
+        this->sum_of_squares -= oldest * oldest;
+        this->samples[this->next_sample] = sample;
+        this->next_sample = (this->next_sample + 1) % this->window_size;
+    }
+
+    this->sum += sample;
+    this->sum_of_squares += sample * sample;
+}
+
+bool PHI_ACCRUAL_DETECTOR::has_enough_samples() const {
+    return this->samples.size() >= (std::min)(phi_min_samples, this->window_size);
+}
+
+double PHI_ACCRUAL_DETECTOR::phi(std::chrono::duration<double, std::milli> elapsed_time,
+                                 std::chrono::milliseconds detection_interval) const {
+    if (!this->has_enough_samples()) {
+        return 0;
+    }
+
+    const double count = static_cast<double>(this->samples.size());
+    const double average = this->sum / count;
+    const double variance = (std::max)(this->sum_of_squares / count - average * average, 0.0);
+
+    const double interval = static_cast<double>(detection_interval.count());
+    // The acceptable pause shifts the distribution, the probe is expected to take that much longer
+    const double mean = average + interval;
+    const double std_dev = (std::max)(std::sqrt(variance), interval * phi_min_std_dev_ratio);
+    if (std_dev <= 0) {
+        // Every probe took exactly as long
+        return elapsed_time.count() > mean ? std::numeric_limits<double>::infinity() : 0;
+    }
+
+    // Logistic approximation of the normal distribution's complementary CDF
+    const double y = (elapsed_time.count() - mean) / std_dev;
+    const double e = std::exp(-y * (1.5976 + 0.070566 * y * y));
+    if (elapsed_time.count() > mean) {
+        return -std::log10(e / (1.0 + e));
+    }
+    return -std::log10(1.0 - 1.0 / (1.0 + e));
+}
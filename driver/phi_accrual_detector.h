@@ -0,0 +1,69 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+#ifndef __PHIACCRUALDETECTOR_H__
+#define __PHIACCRUALDETECTOR_H__
+
+#include <chrono>
+#include <vector>
+
+namespace {
+    // Number of most recent round-trip times the suspicion level is based on
+    const size_t phi_window_size_default = 100;
+    // Round-trip times needed before the suspicion level is considered meaningful
+    const size_t phi_min_samples = 10;
+    // Lower bound of the standard deviation as a fraction of the detection interval, so that
+    // a very steady node isn't suspected as soon as a probe is slightly slower than usual
+    const double phi_min_std_dev_ratio = 0.1;
+}
+
+// Phi accrual failure detector over the round-trip times of monitoring probes.
+// phi is -log10 of the probability that a healthy node takes longer than the given time to
+// answer, based on a normal distribution fitted to the sliding window of observed round-trip
+// times. A phi of 1 means a 10% chance of being wrong when suspecting the node, 2 means 1%, etc.
+// A probe may take up to a detection interval longer than usual, for pauses of the node or the
+// client, before the node gets suspected.
+class PHI_ACCRUAL_DETECTOR {
+public:
+    PHI_ACCRUAL_DETECTOR(size_t window_size = phi_window_size_default);
+
+    void add_sample(std::chrono::duration<double, std::milli> round_trip_time);
+    bool has_enough_samples() const;
+    double phi(std::chrono::duration<double, std::milli> elapsed_time,
+               std::chrono::milliseconds detection_interval = std::chrono::milliseconds(0)) const;
+
+private:
+    size_t window_size;
+    std::vector<double> samples;
+    size_t next_sample = 0;
+    double sum = 0;
+    double sum_of_squares = 0;
+};
+
+#endif /* __PHIACCRUALDETECTOR_H__ */
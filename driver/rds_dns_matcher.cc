@@ -0,0 +1,224 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "rds_dns_matcher.h"
+
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    const char* RDS_SUFFIX = ".rds.amazonaws.com";
+    const char* CHINA_SUFFIX = ".amazonaws.com.cn";
+
+    const char* PROXY_PREFIX = "proxy-";
+    const char* CLUSTER_PREFIX = "cluster-";
+    const char* READER_CLUSTER_PREFIX = "cluster-ro-";
+    const char* CUSTOM_CLUSTER_PREFIX = "cluster-custom-";
+
+    // Hosts classified before are looked up instead of matched again
+    const size_t MAX_CACHED_HOSTS = 256;
+    std::mutex cache_mutex;
+    std::unordered_map<std::string, RDS_DNS_INFO> cache;
+
+    bool equals_ignore_case(const std::string& str, size_t pos, size_t len, const char* expected) {
+        if (len != std::strlen(expected)) {
+            return false;
+        }
+        for (size_t i = 0; i < len; i++) {
+            if (std::tolower(static_cast<unsigned char>(str[pos + i])) != expected[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ends_with_ignore_case(const std::string& str, size_t end, const char* suffix) {
+        const size_t len = std::strlen(suffix);
+        return end >= len && equals_ignore_case(str, end - len, len, suffix);
+    }
+
+    bool is_alnum(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) != 0;
+    }
+
+    // [a-zA-Z0-9]+
+    bool is_alnum_label(const std::string& str, size_t pos, size_t len) {
+        if (len == 0) {
+            return false;
+        }
+        for (size_t i = pos; i < pos + len; i++) {
+            if (!is_alnum(str[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // [a-zA-Z0-9\-]+
+    bool is_label(const std::string& str, size_t pos, size_t len) {
+        if (len == 0) {
+            return false;
+        }
+        for (size_t i = pos; i < pos + len; i++) {
+            if (!is_alnum(str[i]) && str[i] != '-') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Whether the text is one or more repetitions of the given prefixes
+    bool is_repeated(const std::string& str, size_t pos, size_t len, std::initializer_list<const char*> prefixes) {
+        if (len == 0) {
+            return true;
+        }
+        for (const char* prefix : prefixes) {
+            const size_t prefix_len = std::strlen(prefix);
+            if (prefix_len <= len && equals_ignore_case(str, pos, prefix_len, prefix) &&
+                is_repeated(str, pos + prefix_len, len - prefix_len, prefixes)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Finds the start of the last label of str[0, end), the position after its last dot
+    size_t last_label_start(const std::string& str, size_t end) {
+        const size_t dot = end == 0 ? std::string::npos : str.rfind('.', end - 1);
+        return dot == std::string::npos ? std::string::npos : dot + 1;
+    }
+}  // namespace
+
+RDS_DNS_INFO RDS_DNS_MATCHER::classify(const std::string& host) {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        const auto it = cache.find(host);
+        if (it != cache.end()) {
+            return it->second;
+        }
+    }
+
+    RDS_DNS_INFO info = match(host);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (cache.size() >= MAX_CACHED_HOSTS) {
+        cache.clear();
+    }
+    cache.emplace(host, info);
+    return info;
+}
+
+void RDS_DNS_MATCHER::clear_cache() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache.clear();
+}
+
+// A host is "<name>.<prefix><id>.<region>.rds.amazonaws.com", or "<name>.<prefix><id>.rds.<region>.amazonaws.com.cn"
+// or "<name>.<prefix><id>.<region>.rds.amazonaws.com.cn" in China, where the name may contain dots and the prefix
+// is empty, "proxy-", "cluster-", "cluster-ro-" or "cluster-custom-".
+RDS_DNS_INFO RDS_DNS_MATCHER::match(const std::string& host) {
+    RDS_DNS_INFO info;
+
+    // The name matches any character but line terminators
+    if (host.find_first_of("\r\n") != std::string::npos) {
+        return info;
+    }
+
+    // End of the "<prefix><id>" label
+    size_t id_end;
+    if (ends_with_ignore_case(host, host.size(), RDS_SUFFIX)) {
+        const size_t region_end = host.size() - std::strlen(RDS_SUFFIX);
+        const size_t region_start = last_label_start(host, region_end);
+        if (region_start == std::string::npos || !is_label(host, region_start, region_end - region_start)) {
+            return info;
+        }
+        id_end = region_start - 1;
+    } else if (ends_with_ignore_case(host, host.size(), CHINA_SUFFIX)) {
+        const size_t second_end = host.size() - std::strlen(CHINA_SUFFIX);
+        const size_t second_start = last_label_start(host, second_end);
+        if (second_start == std::string::npos) {
+            return info;
+        }
+        const size_t first_end = second_start - 1;
+        const size_t first_start = last_label_start(host, first_end);
+        if (first_start == std::string::npos) {
+            return info;
+        }
+        // "rds.<region>" or "<region>.rds"
+        const bool rds_first = equals_ignore_case(host, first_start, first_end - first_start, "rds") &&
+                               is_label(host, second_start, second_end - second_start);
+        const bool rds_second = equals_ignore_case(host, second_start, second_end - second_start, "rds") &&
+                                is_label(host, first_start, first_end - first_start);
+        if (!rds_first && !rds_second) {
+            return info;
+        }
+        id_end = first_start - 1;
+    } else {
+        return info;
+    }
+
+    const size_t label_start = last_label_start(host, id_end);
+    // The name before the label cannot be empty
+    if (label_start == std::string::npos || label_start < 2) {
+        return info;
+    }
+
+    // The id follows the last dash of the label, the prefix is everything up to it
+    const size_t last_dash = host.rfind('-', id_end - 1);
+    const size_t id_start = (last_dash == std::string::npos || last_dash < label_start) ? label_start : last_dash + 1;
+    if (!is_alnum_label(host, id_start, id_end - id_start)) {
+        return info;
+    }
+    const size_t prefix_len = id_start - label_start;
+
+    info.is_rds = prefix_len == 0 ||
+                  equals_ignore_case(host, label_start, prefix_len, PROXY_PREFIX) ||
+                  equals_ignore_case(host, label_start, prefix_len, CLUSTER_PREFIX) ||
+                  equals_ignore_case(host, label_start, prefix_len, READER_CLUSTER_PREFIX) ||
+                  equals_ignore_case(host, label_start, prefix_len, CUSTOM_CLUSTER_PREFIX);
+    if (prefix_len > 0) {
+        info.is_proxy = is_repeated(host, label_start, prefix_len, {PROXY_PREFIX});
+        info.is_cluster = is_repeated(host, label_start, prefix_len, {CLUSTER_PREFIX, READER_CLUSTER_PREFIX});
+        info.is_writer_cluster = is_repeated(host, label_start, prefix_len, {CLUSTER_PREFIX});
+        info.is_reader_cluster = is_repeated(host, label_start, prefix_len, {READER_CLUSTER_PREFIX});
+        info.is_custom_cluster = is_repeated(host, label_start, prefix_len, {CUSTOM_CLUSTER_PREFIX});
+    }
+
+    const std::string domain = host.substr(id_start);
+    if (info.is_rds) {
+        info.instance_host_pattern = "?." + domain;
+    }
+    if (info.is_cluster) {
+        info.cluster_host_url = host.substr(0, label_start - 1) + ".cluster-" + domain;
+    }
+    return info;
+}
@@ -0,0 +1,63 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __RDSDNSMATCHER_H__
+#define __RDSDNSMATCHER_H__
+
+#include <string>
+
+// What a host name says about the RDS endpoint it is
+struct RDS_DNS_INFO {
+    bool is_rds = false;
+    bool is_proxy = false;
+    bool is_cluster = false;          // Writer or reader cluster endpoint
+    bool is_writer_cluster = false;
+    bool is_reader_cluster = false;
+    bool is_custom_cluster = false;
+    // "?." followed by the domain of the cluster's instances, empty if not an RDS host
+    std::string instance_host_pattern;
+    // The writer cluster endpoint of a cluster endpoint, empty otherwise
+    std::string cluster_host_url;
+};
+
+// Classifies Aurora host names, e.g. "<name>.cluster-ro-<id>.<region>.rds.amazonaws.com" and
+// "<name>.proxy-<id>.rds.<region>.amazonaws.com.cn". Hand-written equivalent of the Aurora DNS
+// regular expressions, the classification of recently seen hosts is cached.
+class RDS_DNS_MATCHER {
+public:
+    static RDS_DNS_INFO classify(const std::string& host);
+
+    // Classifies the host without looking it up in the cache
+    static RDS_DNS_INFO match(const std::string& host);
+
+    static void clear_cache();
+};
+
+#endif /* __RDSDNSMATCHER_H__ */
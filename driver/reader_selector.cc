@@ -0,0 +1,167 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver.h"
+#include "reader_selector.h"
+#include "topology_service.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // Expected connect times are scaled by a random factor up to this far from 1, so that
+    // clients do not all pick the same reader when several are about as fast
+    const double connect_time_jitter = 0.25;
+
+    int get_lag(const std::shared_ptr<HOST_INFO>& reader) {
+        return reader->replica_lag_ms == HOST_INFO::NO_REPLICA_LAG ? INT_MAX : reader->replica_lag_ms;
+    }
+}
+
+READER_SELECTOR::READER_SELECTOR(READER_SELECTION_STRATEGY strategy, int max_replica_lag_ms)
+    : strategy{strategy}, max_replica_lag_ms{max_replica_lag_ms} {}
+
+READER_SELECTION_STRATEGY READER_SELECTOR::get_strategy(const char* name) {
+    if (name == nullptr) {
+        return RANDOM_SELECTION;
+    }
+    if (myodbc_strcasecmp(name, READER_SELECTION_LEAST_LAG) == 0) {
+        return LEAST_LAG_SELECTION;
+    }
+    if (myodbc_strcasecmp(name, READER_SELECTION_LAG_WEIGHTED) == 0) {
+        return LAG_WEIGHTED_SELECTION;
+    }
+    if (myodbc_strcasecmp(name, READER_SELECTION_LOWEST_LATENCY) == 0) {
+        return LOWEST_LATENCY_SELECTION;
+    }
+    return RANDOM_SELECTION;
+}
+
+// Orders the readers from the most to the least preferred
+void READER_SELECTOR::order_readers(std::vector<std::shared_ptr<HOST_INFO>>& readers) {
+    std::shuffle(readers.begin(), readers.end(), get_random_engine());
+
+    switch (strategy) {
+        case LEAST_LAG_SELECTION:
+            std::stable_sort(readers.begin(), readers.end(),
+                [](const std::shared_ptr<HOST_INFO>& a, const std::shared_ptr<HOST_INFO>& b) {
+                    return get_lag(a) < get_lag(b);
+                });
+            break;
+        case LAG_WEIGHTED_SELECTION:
+            order_by_lag_weight(readers);
+            break;
+        case LOWEST_LATENCY_SELECTION:
+            order_by_connect_time(readers);
+            break;
+        default:
+            break;
+    }
+
+    if (max_replica_lag_ms > 0) {
+        std::stable_partition(readers.begin(), readers.end(), [this](const std::shared_ptr<HOST_INFO>& reader) {
+            return reader->replica_lag_ms <= max_replica_lag_ms;
+        });
+    }
+}
+
+// Weighted random order where a reader's weight is inversely proportional to its lag.
+// Each reader draws a key log(u) / weight with u uniform in (0, 1), and the readers are
+// ordered by decreasing key. Readers with an unknown lag are weighted like the most lagging one.
+void READER_SELECTOR::order_by_lag_weight(std::vector<std::shared_ptr<HOST_INFO>>& readers) {
+    int max_lag = 0;
+    for (const auto& reader : readers) {
+        max_lag = (std::max)(max_lag, reader->replica_lag_ms);
+    }
+
+    auto& random_engine = get_random_engine();
+    std::uniform_real_distribution<double> distribution((std::numeric_limits<double>::min)(), 1.0);
+
+    std::vector<std::pair<double, std::shared_ptr<HOST_INFO>>> keyed_readers;
+    keyed_readers.reserve(readers.size());
+    for (const auto& reader : readers) {
+        const int lag = reader->replica_lag_ms == HOST_INFO::NO_REPLICA_LAG ? max_lag : reader->replica_lag_ms;
+        const double weight = 1.0 / (1.0 + lag);
+        keyed_readers.emplace_back(std::log(distribution(random_engine)) / weight, reader);
+    }
+
+    std::stable_sort(keyed_readers.begin(), keyed_readers.end(),
+        [](const std::pair<double, std::shared_ptr<HOST_INFO>>& a, const std::pair<double, std::shared_ptr<HOST_INFO>>& b) {
+            return a.first > b.first;
+        });
+
+    for (size_t i = 0; i < readers.size(); i++) {
+        readers[i] = keyed_readers[i].second;
+    }
+}
+
+// Orders the readers by their expected time until connected, with jitter. Readers never
+// connected to are expected to take the average time of the readers that have been.
+void READER_SELECTOR::order_by_connect_time(std::vector<std::shared_ptr<HOST_INFO>>& readers) {
+    std::vector<std::pair<double, std::shared_ptr<HOST_INFO>>> keyed_readers;
+    keyed_readers.reserve(readers.size());
+
+    double total_connect_time_ms = 0;
+    int known_readers = 0;
+    for (const auto& reader : readers) {
+        const auto stats = TOPOLOGY_SERVICE::get_connect_stats(reader->get_host_id());
+        const bool known = stats.successes + stats.failures > 0;
+        const double connect_time_ms = known ? stats.get_expected_connect_time_ms() : -1;
+        if (known) {
+            total_connect_time_ms += connect_time_ms;
+            known_readers++;
+        }
+        keyed_readers.emplace_back(connect_time_ms, reader);
+    }
+
+    const double average_connect_time_ms = known_readers > 0 ? total_connect_time_ms / known_readers : 0;
+    auto& random_engine = get_random_engine();
+    std::uniform_real_distribution<double> jitter(1.0 - connect_time_jitter, 1.0 + connect_time_jitter);
+    for (auto& keyed_reader : keyed_readers) {
+        const double connect_time_ms = keyed_reader.first < 0 ? average_connect_time_ms : keyed_reader.first;
+        keyed_reader.first = connect_time_ms * jitter(random_engine);
+    }
+
+    std::stable_sort(keyed_readers.begin(), keyed_readers.end(),
+        [](const std::pair<double, std::shared_ptr<HOST_INFO>>& a, const std::pair<double, std::shared_ptr<HOST_INFO>>& b) {
+            return a.first < b.first;
+        });
+
+    for (size_t i = 0; i < readers.size(); i++) {
+        readers[i] = keyed_readers[i].second;
+    }
+}
+
+std::mt19937& READER_SELECTOR::get_random_engine() {
+    static thread_local std::mt19937 random_engine{std::random_device{}()};
+    return random_engine;
+}
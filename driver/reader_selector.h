@@ -0,0 +1,76 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __READERSELECTOR_H__
+#define __READERSELECTOR_H__
+
+#include "host_info.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+enum READER_SELECTION_STRATEGY {
+    RANDOM_SELECTION,
+    LEAST_LAG_SELECTION,
+    LAG_WEIGHTED_SELECTION,
+    LOWEST_LATENCY_SELECTION
+};
+
+// Decides the order in which readers are tried when connecting to a reader.
+// Readers are ranked by the strategy using the replica lag reported by the topology
+// or the connect statistics the topology service keeps of each host. Readers ranked
+// equally, or whose lag is unknown, are tried in random order. With a maximum replica
+// lag set, readers known to lag further behind are only tried after all the others.
+class READER_SELECTOR {
+public:
+    READER_SELECTOR(READER_SELECTION_STRATEGY strategy = RANDOM_SELECTION, int max_replica_lag_ms = 0);
+
+    // Maps a READER_SELECTION_STRATEGY option value to its strategy, RANDOM_SELECTION if it is not recognized
+    static READER_SELECTION_STRATEGY get_strategy(const char* name);
+
+    void order_readers(std::vector<std::shared_ptr<HOST_INFO>>& readers);
+
+    static std::mt19937& get_random_engine();
+
+private:
+    READER_SELECTION_STRATEGY strategy;
+    int max_replica_lag_ms;
+
+    void order_by_lag_weight(std::vector<std::shared_ptr<HOST_INFO>>& readers);
+    void order_by_connect_time(std::vector<std::shared_ptr<HOST_INFO>>& readers);
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private methods
+    friend class TEST_UTILS;
+#endif
+};
+
+#endif /* __READERSELECTOR_H__ */
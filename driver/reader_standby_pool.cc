@@ -0,0 +1,335 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "reader_standby_pool.h"
+#include "reader_selector.h"
+
+#include <algorithm>
+
+std::map<std::pair<std::string, std::string>, std::weak_ptr<READER_STANDBY_POOL>> READER_STANDBY_POOL::pools;
+std::mutex READER_STANDBY_POOL::pools_mutex;
+
+READER_STANDBY_POOL::READER_STANDBY_POOL(std::shared_ptr<TOPOLOGY_SERVICE> topology_service,
+                                         unsigned long dbc_id, bool enable_logging)
+    : topology_service{std::move(topology_service)},
+      dbc_id{dbc_id} {
+
+    if (enable_logging) {
+        this->logger = init_log_file();
+    }
+
+    this->pool_thread = std::thread(&READER_STANDBY_POOL::run, this);
+}
+
+READER_STANDBY_POOL::~READER_STANDBY_POOL() {
+    stop();
+}
+
+std::shared_ptr<READER_STANDBY_POOL> READER_STANDBY_POOL::get_instance(const TOPOLOGY_SERVICE& topology_service,
+                                                                       const std::string& key, unsigned long dbc_id,
+                                                                       bool enable_logging) {
+    std::unique_lock<std::mutex> lock(pools_mutex);
+
+    auto& pool = pools[std::make_pair(topology_service.cluster_id, key)];
+    auto instance = pool.lock();
+    if (!instance) {
+        instance = std::make_shared<READER_STANDBY_POOL>(
+            std::make_shared<TOPOLOGY_SERVICE>(topology_service), dbc_id, enable_logging);
+        pool = instance;
+    }
+
+    return instance;
+}
+
+void READER_STANDBY_POOL::attach(const void* owner, STANDBY_CONNECTION_FACTORY connection_factory, size_t pool_size) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        this->owners[owner] = {std::move(connection_factory), pool_size};
+    }
+    this->pool_cv.notify_all();
+}
+
+// Waits for a connection attempt or ping through the owner's handles in progress and closes
+// the standby connections its factory opened, so the owner may release what it uses as soon
+// as this returns. The pool replaces them through the other owners.
+void READER_STANDBY_POOL::detach(const void* owner) {
+    std::deque<STANDBY_CONNECTION> connections;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        this->owners.erase(owner);
+        this->pool_cv.wait(lock, [this, owner] { return this->busy_owners.count(owner) == 0; });
+
+        for (auto it = this->standby_connections.begin(); it != this->standby_connections.end();) {
+            if (it->owner == owner) {
+                connections.push_back(*it);
+                it = this->standby_connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (const auto& standby : connections) {
+        close_connection(standby.connection);
+    }
+    this->pool_cv.notify_all();
+}
+
+void READER_STANDBY_POOL::stop() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        this->stopped = true;
+    }
+    this->pool_cv.notify_all();
+
+    if (this->pool_thread.joinable()) {
+        this->pool_thread.join();
+    }
+
+    std::deque<STANDBY_CONNECTION> connections;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        connections.swap(this->standby_connections);
+    }
+    for (const auto& standby : connections) {
+        close_connection(standby.connection);
+    }
+}
+
+STANDBY_CONNECTION READER_STANDBY_POOL::take(std::shared_ptr<HOST_INFO> excluded_host, DBC* dbc) {
+    STANDBY_CONNECTION result;
+    while (true) {
+        STANDBY_CONNECTION standby;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (this->stopped) {
+                break;
+            }
+            // The most recently checked connection is the most likely to be alive
+            auto it = std::find_if(this->standby_connections.rbegin(), this->standby_connections.rend(),
+                [&excluded_host](const STANDBY_CONNECTION& standby) {
+                    return !excluded_host || !HOST_INFO::is_host_same(standby.host, excluded_host);
+                });
+            if (it == this->standby_connections.rend()) {
+                break;
+            }
+            standby = *it;
+            this->standby_connections.erase(std::next(it).base());
+            this->pending_hosts.insert(standby.host->get_host_id());
+
+            // From now on the connection belongs to the taker, its owner may go away
+            standby.connection->set_dbc(dbc);
+            standby.owner = nullptr;
+        }
+
+        const bool alive = standby.connection->ping() == 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            this->pending_hosts.erase(standby.host->get_host_id());
+        }
+
+        if (alive) {
+            MYLOG_TRACE(this->logger, this->dbc_id,
+                "[READER_STANDBY_POOL] Handing over the standby connection to '%s'",
+                standby.host->get_host_port_pair().c_str());
+            result = standby;
+            break;
+        }
+
+        MYLOG_TRACE(this->logger, this->dbc_id,
+            "[READER_STANDBY_POOL] Standby connection to '%s' was lost",
+            standby.host->get_host_port_pair().c_str());
+        close_connection(standby.connection);
+    }
+
+    // Replaces what was taken or lost
+    this->pool_cv.notify_all();
+    return result;
+}
+
+size_t READER_STANDBY_POOL::size() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return this->standby_connections.size();
+}
+
+// Must be called with mutex_ held
+size_t READER_STANDBY_POOL::get_pool_size() {
+    size_t pool_size = 0;
+    for (const auto& owner : this->owners) {
+        pool_size = (std::max)(pool_size, owner.second.pool_size);
+    }
+    return pool_size;
+}
+
+void READER_STANDBY_POOL::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto next_keep_alive_time = std::chrono::steady_clock::now() + standby_keep_alive_interval;
+    while (!this->stopped) {
+        lock.unlock();
+        replenish();
+        lock.lock();
+
+        // Wakes up to replace a connection that was taken or lost, or to check the idle ones
+        const bool woken = this->pool_cv.wait_until(lock, next_keep_alive_time, [this] {
+            return this->stopped ||
+                this->standby_connections.size() + this->pending_hosts.size() < get_pool_size();
+        });
+        if (this->stopped) {
+            break;
+        }
+
+        if (!woken) {
+            lock.unlock();
+            keep_alive();
+            lock.lock();
+            next_keep_alive_time = std::chrono::steady_clock::now() + standby_keep_alive_interval;
+        }
+    }
+}
+
+void READER_STANDBY_POOL::replenish() {
+    for (const auto& host : get_candidates()) {
+        const void* owner;
+        STANDBY_CONNECTION_FACTORY connection_factory;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (this->stopped || this->owners.empty() ||
+                this->standby_connections.size() + this->pending_hosts.size() >= get_pool_size()) {
+                return;
+            }
+            if (this->pending_hosts.count(host->get_host_id()) > 0) {
+                continue;
+            }
+            owner = this->owners.begin()->first;
+            connection_factory = this->owners.begin()->second.connection_factory;
+            this->pending_hosts.insert(host->get_host_id());
+            this->busy_owners.insert(owner);
+        }
+
+        // Connecting takes long, the pool stays usable meanwhile
+        CONNECTION_PROXY* connection = connection_factory(host);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        this->pending_hosts.erase(host->get_host_id());
+        if (connection && !this->stopped && this->owners.count(owner) > 0) {
+            MYLOG_TRACE(this->logger, this->dbc_id,
+                "[READER_STANDBY_POOL] Opened a standby connection to '%s'", host->get_host_port_pair().c_str());
+            this->standby_connections.push_back({host, connection, owner});
+            connection = nullptr;
+        }
+        lock.unlock();
+
+        // Closed before the owner may go away
+        close_connection(connection);
+        lock.lock();
+        this->busy_owners.erase(this->busy_owners.find(owner));
+        lock.unlock();
+        this->pool_cv.notify_all();
+    }
+}
+
+void READER_STANDBY_POOL::keep_alive() {
+    size_t remaining;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        remaining = this->standby_connections.size();
+    }
+
+    // Checks one connection at a time, the others can be taken meanwhile
+    for (; remaining > 0; remaining--) {
+        STANDBY_CONNECTION standby;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (this->stopped || this->standby_connections.empty()) {
+                return;
+            }
+            standby = this->standby_connections.front();
+            this->standby_connections.pop_front();
+            this->pending_hosts.insert(standby.host->get_host_id());
+            this->busy_owners.insert(standby.owner);
+        }
+
+        bool alive = standby.connection->ping() == 0;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        this->pending_hosts.erase(standby.host->get_host_id());
+        alive = alive && !this->stopped && this->owners.count(standby.owner) > 0;
+        if (alive) {
+            this->standby_connections.push_back(standby);
+        }
+        lock.unlock();
+
+        if (!alive) {
+            MYLOG_TRACE(this->logger, this->dbc_id,
+                "[READER_STANDBY_POOL] Standby connection to '%s' was lost",
+                standby.host->get_host_port_pair().c_str());
+            close_connection(standby.connection);
+        }
+
+        lock.lock();
+        this->busy_owners.erase(this->busy_owners.find(standby.owner));
+        lock.unlock();
+        this->pool_cv.notify_all();
+    }
+}
+
+std::vector<std::shared_ptr<HOST_INFO>> READER_STANDBY_POOL::get_candidates() {
+    std::vector<std::shared_ptr<HOST_INFO>> candidates;
+    const auto topology = this->topology_service->get_cached_topology();
+    if (!topology) {
+        return candidates;
+    }
+
+    std::set<HOST_ID> pooled_hosts;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (const auto& standby : this->standby_connections) {
+            pooled_hosts.insert(standby.host->get_host_id());
+        }
+    }
+
+    for (const auto& reader : topology->get_readers()) {
+        if (reader->is_host_down() || pooled_hosts.count(reader->get_host_id()) > 0) {
+            continue;
+        }
+        candidates.push_back(reader);
+    }
+
+    // Spreads the standby connections of all clients over the readers
+    std::shuffle(candidates.begin(), candidates.end(), READER_SELECTOR::get_random_engine());
+    return candidates;
+}
+
+void READER_STANDBY_POOL::close_connection(CONNECTION_PROXY* connection) {
+    if (connection) {
+        connection->close();
+        connection->delete_ds();
+        delete connection;
+    }
+}
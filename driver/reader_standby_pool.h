@@ -0,0 +1,131 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __READERSTANDBYPOOL_H__
+#define __READERSTANDBYPOOL_H__
+
+#include "topology_service.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+    // How often idle standby connections are pinged to keep them open
+    const std::chrono::seconds standby_keep_alive_interval(30);
+}
+
+typedef std::function<CONNECTION_PROXY*(std::shared_ptr<HOST_INFO>)> STANDBY_CONNECTION_FACTORY;
+
+struct STANDBY_CONNECTION {
+    std::shared_ptr<HOST_INFO> host;
+    CONNECTION_PROXY* connection = nullptr;
+    // Whose factory opened the connection, it uses the handles of that owner
+    const void* owner = nullptr;
+};
+
+// Keeps a few idle, authenticated connections to readers of a cluster, shared by all the
+// connections of the process to it, so that reader failover can take one over instead of
+// connecting. A background thread opens the connections, pings them to keep them open,
+// and replaces the ones that are taken or lost.
+class READER_STANDBY_POOL {
+public:
+    READER_STANDBY_POOL(std::shared_ptr<TOPOLOGY_SERVICE> topology_service, unsigned long dbc_id,
+                        bool enable_logging = false);
+    READER_STANDBY_POOL(READER_STANDBY_POOL const&) = delete;
+    READER_STANDBY_POOL& operator=(READER_STANDBY_POOL const&) = delete;
+    virtual ~READER_STANDBY_POOL();
+
+    // Returns the running pool of the cluster of the given topology service for connections
+    // opened with the options of the key, see CONNECTION_POOL::get_key(), or starts one.
+    // Standby connections are only handed over to connections with the same options, which
+    // carry the same credentials and session settings.
+    static std::shared_ptr<READER_STANDBY_POOL> get_instance(const TOPOLOGY_SERVICE& topology_service,
+                                                             const std::string& key, unsigned long dbc_id,
+                                                             bool enable_logging = false);
+
+    // The pool keeps as many connections as the largest size asked for by the attached owners
+    void attach(const void* owner, STANDBY_CONNECTION_FACTORY connection_factory, size_t pool_size);
+    void detach(const void* owner);
+    // Hands over a live standby connection to a host other than the excluded one, moved to
+    // the given handle. The connection is null if there is none.
+    STANDBY_CONNECTION take(std::shared_ptr<HOST_INFO> excluded_host, DBC* dbc);
+    size_t size();
+    // Stops the background thread and closes the standby connections
+    void stop();
+
+protected:
+    struct STANDBY_OWNER {
+        STANDBY_CONNECTION_FACTORY connection_factory;
+        size_t pool_size;
+    };
+
+    void run();
+    void replenish();
+    void keep_alive();
+    size_t get_pool_size();
+    std::vector<std::shared_ptr<HOST_INFO>> get_candidates();
+    static void close_connection(CONNECTION_PROXY* connection);
+
+    std::shared_ptr<TOPOLOGY_SERVICE> topology_service;
+    std::map<const void*, STANDBY_OWNER> owners;
+
+    // Idle standby connections, the least recently checked first
+    std::deque<STANDBY_CONNECTION> standby_connections;
+    // Hosts a standby connection is being opened to or checked
+    std::set<HOST_ID> pending_hosts;
+    // Owners whose factory or handles are in use, they are waited for on detach
+    std::multiset<const void*> busy_owners;
+
+    std::mutex mutex_;
+    std::condition_variable pool_cv;
+    bool stopped = false;
+    std::thread pool_thread;
+
+    std::shared_ptr<FILE> logger = nullptr;
+    unsigned long dbc_id = 0;
+
+    // By cluster id and options key
+    static std::map<std::pair<std::string, std::string>, std::weak_ptr<READER_STANDBY_POOL>> pools;
+    static std::mutex pools_mutex;
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private/protected methods
+    friend class TEST_UTILS;
+#endif
+};
+
+#endif /* __READERSTANDBYPOOL_H__ */
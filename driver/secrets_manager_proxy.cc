@@ -42,7 +42,6 @@
 using namespace Aws::SecretsManager;
 
 namespace {
-    AWS_SDK_HELPER SDK_HELPER;
     const Aws::String USERNAME_KEY{ "username" };
     const Aws::String PASSWORD_KEY{ "password" };
     const std::string SECRETS_ARN_PATTERN{ "arn:aws:secretsmanager:([-a-zA-Z0-9]+):.*" };
@@ -52,8 +51,6 @@ std::map<std::pair<Aws::String, Aws::String>, Aws::Utils::Json::JsonValue> SECRE
 std::mutex SECRETS_MANAGER_PROXY::secrets_cache_mutex;
 
 SECRETS_MANAGER_PROXY::SECRETS_MANAGER_PROXY(DBC* dbc, DataSource* ds) : CONNECTION_PROXY(dbc, ds) {
-    ++SDK_HELPER;
-
     const char* secret_ID = nullptr;
     std::string region;
     if (ds->opt_AUTH_SECRET_ID) {
@@ -67,11 +64,9 @@ SECRETS_MANAGER_PROXY::SECRETS_MANAGER_PROXY(DBC* dbc, DataSource* ds) : CONNECT
         try_parse_region_from_secret(secret_ID, region);
     }
 
-    SecretsManagerClientConfiguration config;
-    config.region = !region.empty() ? region : Aws::Region::US_EAST_1;
-    this->sm_client = std::make_shared<SecretsManagerClient>(config);
-
-    this->secret_key = std::make_pair(secret_ID ? secret_ID : "", config.region);
+    // The client is created when the secret is not cached
+    this->secret_key = std::make_pair(secret_ID ? secret_ID : "",
+                                      !region.empty() ? region.c_str() : Aws::Region::US_EAST_1);
     this->next_proxy = nullptr;
 }
 
@@ -89,7 +84,6 @@ SECRETS_MANAGER_PROXY::SECRETS_MANAGER_PROXY(DBC* dbc, DataSource* ds, CONNECTIO
 
 SECRETS_MANAGER_PROXY::~SECRETS_MANAGER_PROXY() {
     this->sm_client.reset();
-    --SDK_HELPER;
 }
 
 bool SECRETS_MANAGER_PROXY::connect(const char* host, const char* user, const char* passwd, const char* database,
@@ -161,6 +155,14 @@ bool SECRETS_MANAGER_PROXY::fetch_latest_credentials() {
     Aws::String secret_string;
     MYLOG_DBC_TRACE(dbc, "[SECRETS_MANAGER_PROXY] Fetching credentials from Secrets Manager Service.");
 
+    if (!this->sm_client) {
+        AWS_SDK_HELPER::init();
+
+        SecretsManagerClientConfiguration config;
+        config.region = this->secret_key.second;
+        this->sm_client = std::make_shared<SecretsManagerClient>(config);
+    }
+
     Model::GetSecretValueRequest request;
     request.SetSecretId(this->secret_key.first);
     auto get_secret_value_outcome = this->sm_client->GetSecretValue(request);
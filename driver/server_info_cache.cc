@@ -0,0 +1,103 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "server_info_cache.h"
+
+#include "rds_dns_matcher.h"
+
+namespace {
+    // Instances keep their host name and port, but may be replaced behind the endpoint
+    const std::chrono::minutes SERVER_INFO_CACHE_TTL(10);
+}
+
+SERVER_INFO_CACHE::SERVER_INFO_CACHE(std::chrono::milliseconds ttl) : ttl{ttl} {}
+
+SERVER_INFO_CACHE& SERVER_INFO_CACHE::get_instance() {
+    // Never destroyed, connections may use it while the process exits
+    static SERVER_INFO_CACHE* instance = new SERVER_INFO_CACHE(SERVER_INFO_CACHE_TTL);
+    return *instance;
+}
+
+bool SERVER_INFO_CACHE::is_cacheable(const std::string& host) {
+    const RDS_DNS_INFO info = RDS_DNS_MATCHER::classify(host);
+    return info.is_rds && !info.is_cluster && !info.is_custom_cluster && !info.is_proxy;
+}
+
+bool SERVER_INFO_CACHE::get(const std::string& host, unsigned int port,
+                            const std::string& server_version, SERVER_INFO& info) {
+    if (!is_cacheable(host)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries.find(get_key(host, port));
+    if (it == entries.end()) {
+        return false;
+    }
+
+    if (std::chrono::steady_clock::now() >= it->second.expires ||
+        it->second.info.server_version != server_version) {
+        entries.erase(it);
+        return false;
+    }
+
+    info = it->second.info;
+    return true;
+}
+
+void SERVER_INFO_CACHE::put(const std::string& host, unsigned int port, const SERVER_INFO& info) {
+    if (!is_cacheable(host)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries[get_key(host, port)];
+    entry.info = info;
+    entry.expires = std::chrono::steady_clock::now() + ttl;
+}
+
+void SERVER_INFO_CACHE::invalidate(const std::string& host, unsigned int port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.erase(get_key(host, port));
+}
+
+void SERVER_INFO_CACHE::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.clear();
+}
+
+size_t SERVER_INFO_CACHE::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries.size();
+}
+
+std::string SERVER_INFO_CACHE::get_key(const std::string& host, unsigned int port) {
+    return host + ":" + std::to_string(port);
+}
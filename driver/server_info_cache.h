@@ -0,0 +1,86 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __SERVERINFOCACHE_H__
+#define __SERVERINFOCACHE_H__
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+// What connections discover about the server instance they are connected to
+struct SERVER_INFO {
+    // Version the server reported in the handshake, tells apart the servers
+    // a host:port reached without a query
+    std::string server_version;
+    // "<@@hostname>:<@@port>" of the instance
+    std::set<std::string> node_keys;
+};
+
+// Caches what connections discover about server instances, shared by all connections of
+// the process, so that connecting again to a known instance skips the discovery queries.
+// Only instance endpoints are cached, cluster and proxy endpoints reach another instance
+// after failover. An entry is dropped when it expires, when the server behind the endpoint
+// reports another version, and when a connection to it fails.
+class SERVER_INFO_CACHE {
+public:
+    SERVER_INFO_CACHE(std::chrono::milliseconds ttl);
+    SERVER_INFO_CACHE(SERVER_INFO_CACHE const&) = delete;
+    SERVER_INFO_CACHE& operator=(SERVER_INFO_CACHE const&) = delete;
+
+    static SERVER_INFO_CACHE& get_instance();
+
+    // Whether the host always reaches the same instance
+    static bool is_cacheable(const std::string& host);
+
+    // Returns false if nothing is cached for the endpoint or the server version changed
+    bool get(const std::string& host, unsigned int port,
+             const std::string& server_version, SERVER_INFO& info);
+    void put(const std::string& host, unsigned int port, const SERVER_INFO& info);
+    void invalidate(const std::string& host, unsigned int port);
+    void clear();
+    size_t size();
+
+private:
+    struct ENTRY {
+        SERVER_INFO info;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    static std::string get_key(const std::string& host, unsigned int port);
+
+    const std::chrono::milliseconds ttl;
+    std::map<std::string, ENTRY> entries;
+    std::mutex mutex_;
+};
+
+#endif /* __SERVERINFOCACHE_H__ */
@@ -0,0 +1,364 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "session_state.h"
+#include "driver.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    const std::string USER_VARIABLE_PREFIX("@");
+    const std::string CHARSET_KEY("names");
+
+    std::string to_upper(std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char)std::toupper(c); });
+        return str;
+    }
+
+    std::string to_lower(std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return str;
+    }
+
+    std::string trim(const std::string& str) {
+        const auto begin = str.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        return str.substr(begin, str.find_last_not_of(" \t\r\n") - begin + 1);
+    }
+
+    bool starts_with(const std::string& str, const std::string& prefix) {
+        return str.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    // Removes the prefix, compared case-insensitively, from the start of str
+    bool consume_prefix(std::string& str, const std::string& prefix) {
+        if (str.size() < prefix.size() || to_upper(str.substr(0, prefix.size())) != prefix) {
+            return false;
+        }
+        str = trim(str.substr(prefix.size()));
+        return true;
+    }
+
+    // Splits on the commas that are outside of quotes and parentheses
+    std::vector<std::string> split_list(const std::string& str) {
+        std::vector<std::string> items;
+        char quote = 0;
+        int depth = 0;
+        size_t start = 0;
+        for (size_t i = 0; i < str.size(); i++) {
+            const char c = str[i];
+            if (quote) {
+                if (c == '\\' && quote != '`') {
+                    i++;
+                } else if (c == quote) {
+                    quote = 0;
+                }
+            } else if (c == '\'' || c == '"' || c == '`') {
+                quote = c;
+            } else if (c == '(') {
+                depth++;
+            } else if (c == ')') {
+                depth--;
+            } else if (c == ',' && depth == 0) {
+                items.push_back(trim(str.substr(start, i - start)));
+                start = i + 1;
+            }
+        }
+        items.push_back(trim(str.substr(start)));
+        return items;
+    }
+
+    bool is_quoted_string(const std::string& value) {
+        if (value.size() < 2 || (value[0] != '\'' && value[0] != '"') || value.back() != value[0]) {
+            return false;
+        }
+        // The closing quote must be the first one that is neither escaped nor doubled
+        const char quote = value[0];
+        size_t i = 1;
+        while (i < value.size() - 1) {
+            if (value[i] == '\\' || (value[i] == quote && value[i + 1] == quote && i + 1 < value.size() - 1)) {
+                i += 2;
+            } else if (value[i] == quote) {
+                return false;
+            } else {
+                i++;
+            }
+        }
+        return i == value.size() - 1;
+    }
+
+    // Numbers, and for system variables the keywords they accept, such as ON or a mode name
+    bool is_literal(const std::string& value, bool allow_words) {
+        if (value.empty()) {
+            return false;
+        }
+        if (is_quoted_string(value)) {
+            return true;
+        }
+
+        const std::string upper = to_upper(value);
+        if (upper == "NULL" || upper == "TRUE" || upper == "FALSE") {
+            return true;
+        }
+
+        bool has_letter = false;
+        for (const char c : value) {
+            if (std::isalpha((unsigned char)c) || c == '_') {
+                has_letter = true;
+            } else if (!std::isdigit((unsigned char)c) && c != '.' && c != '-' && c != '+') {
+                return false;
+            }
+        }
+        if (!has_letter) {
+            return true;
+        }
+        // Hexadecimal and exponent notations
+        if (starts_with(upper, "0X") || (std::isdigit((unsigned char)value[0]) && upper.find('E') != std::string::npos)) {
+            return true;
+        }
+        return allow_words && !std::isdigit((unsigned char)value[0]);
+    }
+
+    std::string unquote_identifier(const std::string& identifier) {
+        if (identifier.size() >= 2 && identifier[0] == '`' && identifier.back() == '`') {
+            return identifier.substr(1, identifier.size() - 2);
+        }
+        return identifier;
+    }
+
+    // The variables were renamed in MySQL 8.0
+    std::string get_canonical_name(const std::string& name) {
+        if (name == "tx_isolation") {
+            return "transaction_isolation";
+        }
+        if (name == "tx_read_only") {
+            return "transaction_read_only";
+        }
+        return name;
+    }
+}
+
+void SESSION_STATE::track_statement(const std::string& statement) {
+    std::string body = trim(statement);
+    if (!consume_prefix(body, "SET ")) {
+        return;
+    }
+
+    // Statements that are not variable assignments
+    const std::string upper_body = to_upper(body);
+    if (starts_with(upper_body, "PASSWORD") || starts_with(upper_body, "ROLE ") ||
+        starts_with(upper_body, "DEFAULT ROLE ") || starts_with(upper_body, "RESOURCE GROUP ")) {
+        return;
+    }
+
+    // SET SESSION TRANSACTION is a statement of its own, without a scope it only applies to the next transaction
+    std::string transaction = body;
+    const bool session_transaction = consume_prefix(transaction, "SESSION ") || consume_prefix(transaction, "LOCAL ");
+    if (consume_prefix(transaction, "TRANSACTION ")) {
+        if (session_transaction) {
+            track_transaction_characteristics(transaction);
+        }
+        return;
+    }
+
+    enum { SESSION_SCOPE, GLOBAL_SCOPE } scope = SESSION_SCOPE;
+    for (auto item : split_list(body)) {
+        // A scope keyword applies to the following assignments without one
+        if (consume_prefix(item, "GLOBAL ") || consume_prefix(item, "PERSIST ") || consume_prefix(item, "PERSIST_ONLY ")) {
+            scope = GLOBAL_SCOPE;
+        } else if (consume_prefix(item, "SESSION ") || consume_prefix(item, "LOCAL ")) {
+            scope = SESSION_SCOPE;
+        }
+
+        const std::string upper_item = to_upper(item);
+        if (starts_with(upper_item, "NAMES ") || starts_with(upper_item, "CHARACTER SET ") || starts_with(upper_item, "CHARSET ")) {
+            set_assignment(CHARSET_KEY, item);
+            continue;
+        }
+
+        auto item_scope = scope;
+        if (consume_prefix(item, "@@GLOBAL.") || consume_prefix(item, "@@PERSIST.") || consume_prefix(item, "@@PERSIST_ONLY.")) {
+            item_scope = GLOBAL_SCOPE;
+        } else if (consume_prefix(item, "@@SESSION.") || consume_prefix(item, "@@LOCAL.") || consume_prefix(item, "@@")) {
+            item_scope = SESSION_SCOPE;
+        }
+
+        const auto equals = item.find('=');
+        if (equals == std::string::npos || equals == 0) {
+            continue;
+        }
+        const std::string name = trim(item.substr(0, item[equals - 1] == ':' ? equals - 1 : equals));
+        const std::string value = trim(item.substr(equals + 1));
+
+        const bool user_variable = starts_with(name, USER_VARIABLE_PREFIX);
+        if (!user_variable && item_scope == GLOBAL_SCOPE) {
+            // Global variables outlive the session
+            continue;
+        }
+
+        const std::string key = user_variable ? to_lower(name) : get_canonical_name(to_lower(unquote_identifier(name)));
+        // A new session starts with the default values
+        if (!is_literal(value, !user_variable) || (!user_variable && to_upper(value) == "DEFAULT") ||
+            (user_variable && to_upper(value) == "NULL")) {
+            remove_assignment(key);
+            continue;
+        }
+        set_assignment(key, value);
+    }
+}
+
+// Handles SET SESSION TRANSACTION, such as ISOLATION LEVEL READ COMMITTED, READ ONLY
+void SESSION_STATE::track_transaction_characteristics(const std::string& characteristics) {
+    for (auto item : split_list(characteristics)) {
+        if (consume_prefix(item, "ISOLATION LEVEL ")) {
+            std::string level = to_upper(item);
+            std::replace(level.begin(), level.end(), ' ', '-');
+            set_assignment("transaction_isolation", "'" + level + "'");
+        } else if (consume_prefix(item, "READ ONLY")) {
+            set_assignment("transaction_read_only", "1");
+        } else if (consume_prefix(item, "READ WRITE")) {
+            set_assignment("transaction_read_only", "0");
+        }
+    }
+}
+
+bool SESSION_STATE::get_used_database(const std::string& statement, std::string& database) {
+    std::string body = trim(statement);
+    if (!consume_prefix(body, "USE ") || body.empty()) {
+        return false;
+    }
+    database = unquote_identifier(body);
+    return true;
+}
+
+void SESSION_STATE::set_assignment(const std::string& key, const std::string& value) {
+    // The latest assignment goes last, it may override variables assigned before, e.g. by SET NAMES
+    remove_assignment(key);
+    this->assignments.emplace_back(key, value);
+}
+
+void SESSION_STATE::remove_assignment(const std::string& key) {
+    this->assignments.erase(
+        std::remove_if(this->assignments.begin(), this->assignments.end(),
+                       [&key](const std::pair<std::string, std::string>& assignment) { return assignment.first == key; }),
+        this->assignments.end());
+}
+
+void SESSION_STATE::clear() {
+    this->assignments.clear();
+}
+
+bool SESSION_STATE::empty() const {
+    return this->assignments.empty();
+}
+
+std::string SESSION_STATE::build_restore_query(const std::vector<std::string>& connection_assignments,
+                                               bool legacy_variable_names) const {
+    std::vector<std::string> items(connection_assignments);
+    for (const auto& assignment : this->assignments) {
+        const std::string& key = assignment.first;
+        if (key == CHARSET_KEY) {
+            items.push_back(assignment.second);
+        } else if (starts_with(key, USER_VARIABLE_PREFIX)) {
+            items.push_back(key + " = " + assignment.second);
+        } else {
+            std::string name = key;
+            if (legacy_variable_names && key == "transaction_isolation") {
+                name = "tx_isolation";
+            } else if (legacy_variable_names && key == "transaction_read_only") {
+                name = "tx_read_only";
+            }
+            items.push_back("@@SESSION." + name + " = " + assignment.second);
+        }
+    }
+
+    if (items.empty()) {
+        return "";
+    }
+
+    std::string query = "SET ";
+    for (size_t i = 0; i < items.size(); i++) {
+        if (i > 0) {
+            query.append(", ");
+        }
+        query.append(items[i]);
+    }
+    return query;
+}
+
+bool SESSION_STATE::restore(DBC* dbc, bool autocommit) const {
+    CONNECTION_PROXY* connection = dbc->connection_proxy;
+    const bool legacy_variable_names = !is_minimum_version(connection->get_server_version(), "8.0");
+
+    // The new connection was opened with the database of the data source
+    const char* ds_database = dbc->ds->opt_DATABASE;
+    if (!dbc->database.empty() && dbc->database != (ds_database ? ds_database : "") &&
+        connection->select_db(dbc->database.c_str())) {
+        MYLOG_DBC_TRACE(dbc, "[SESSION_STATE] Failed to restore the database: %s", connection->error());
+        return false;
+    }
+
+    std::vector<std::string> connection_assignments;
+    if (!autocommit && dbc->transactions_supported()) {
+        connection_assignments.push_back("@@SESSION.autocommit = 0");
+    }
+    if (dbc->txn_isolation != DEFAULT_TXN_ISOLATION) {
+        const char* level;
+        if (dbc->txn_isolation & SQL_TXN_SERIALIZABLE)
+            level = "'SERIALIZABLE'";
+        else if (dbc->txn_isolation & SQL_TXN_REPEATABLE_READ)
+            level = "'REPEATABLE-READ'";
+        else if (dbc->txn_isolation & SQL_TXN_READ_COMMITTED)
+            level = "'READ-COMMITTED'";
+        else
+            level = "'READ-UNCOMMITTED'";
+        connection_assignments.push_back(
+            std::string("@@SESSION.") + (legacy_variable_names ? "tx_isolation" : "transaction_isolation") + " = " + level);
+    }
+    // (SQLULEN)-1 if it was never set, 0 if it was set to DEFAULT
+    if (dbc->sql_select_limit != (SQLULEN)-1 && dbc->sql_select_limit != 0) {
+        connection_assignments.push_back("@@SESSION.sql_select_limit = " + std::to_string((unsigned long long)dbc->sql_select_limit));
+    }
+
+    const std::string query = build_restore_query(connection_assignments, legacy_variable_names);
+    if (query.empty()) {
+        return true;
+    }
+
+    MYLOG_DBC_TRACE(dbc, "[SESSION_STATE] Restoring the session state: %s", query.c_str());
+    if (connection->real_query(query.c_str(), (unsigned long)query.size())) {
+        MYLOG_DBC_TRACE(dbc, "[SESSION_STATE] Failed to restore the session state: %s", connection->error());
+        return false;
+    }
+    return true;
+}
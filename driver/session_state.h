@@ -0,0 +1,70 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __SESSION_STATE_H__
+#define __SESSION_STATE_H__
+
+#include <string>
+#include <utility>
+#include <vector>
+
+struct DBC;
+
+// Tracks the session state the application sets with SET statements, so that it can be
+// restored on the connection that replaces the current one after failover.
+class SESSION_STATE {
+public:
+    // Records the session and user variables assigned by a successfully executed statement.
+    // Variables assigned anything but a literal are forgotten, their value cannot be reproduced.
+    void track_statement(const std::string& statement);
+    // Returns whether the statement is a USE statement, and the database it selects
+    static bool get_used_database(const std::string& statement, std::string& database);
+    void clear();
+    bool empty() const;
+
+    // Builds a single SET statement assigning the given connection settings, then the tracked
+    // variables. Returns an empty string if there is nothing to assign.
+    std::string build_restore_query(const std::vector<std::string>& connection_assignments,
+                                    bool legacy_variable_names) const;
+
+    // Restores the state of the session dbc's connection replaced, in one round trip
+    // when the database is unchanged. Returns false if the server rejected it.
+    bool restore(DBC* dbc, bool autocommit) const;
+
+private:
+    // Latest assignment of each variable, in the order they were made
+    std::vector<std::pair<std::string, std::string>> assignments;
+
+    void set_assignment(const std::string& key, const std::string& assignment);
+    void remove_assignment(const std::string& key);
+    void track_transaction_characteristics(const std::string& characteristics);
+};
+
+#endif /* __SESSION_STATE_H__ */
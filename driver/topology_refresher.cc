@@ -0,0 +1,211 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "topology_refresher.h"
+
+#include <algorithm>
+
+std::map<std::string, std::weak_ptr<TOPOLOGY_REFRESHER>> TOPOLOGY_REFRESHER::refreshers;
+std::mutex TOPOLOGY_REFRESHER::refreshers_mutex;
+
+TOPOLOGY_REFRESHER::TOPOLOGY_REFRESHER(std::shared_ptr<TOPOLOGY_SERVICE> topology_service)
+    : topology_service{std::move(topology_service)} {
+
+    this->refresh_thread = std::thread(&TOPOLOGY_REFRESHER::run, this);
+}
+
+TOPOLOGY_REFRESHER::~TOPOLOGY_REFRESHER() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        this->stopped = true;
+    }
+    this->refresh_cv.notify_all();
+
+    if (this->refresh_thread.joinable()) {
+        this->refresh_thread.join();
+    }
+}
+
+std::shared_ptr<TOPOLOGY_REFRESHER> TOPOLOGY_REFRESHER::get_instance(const TOPOLOGY_SERVICE& topology_service) {
+    std::unique_lock<std::mutex> lock(refreshers_mutex);
+
+    auto& refresher = refreshers[topology_service.cluster_id];
+    auto instance = refresher.lock();
+    if (!instance) {
+        instance = std::make_shared<TOPOLOGY_REFRESHER>(std::make_shared<TOPOLOGY_SERVICE>(topology_service));
+        refresher = instance;
+    }
+
+    return instance;
+}
+
+void TOPOLOGY_REFRESHER::attach(const void* owner, TOPOLOGY_CONNECTION_FACTORY connection_factory,
+                                const TOPOLOGY_SERVICE& topology_service) {
+    {
+        std::unique_lock<std::mutex> lock(connection_factories_mutex);
+        this->connection_factories[owner] = std::move(connection_factory);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    this->topology_services[owner] = std::make_shared<TOPOLOGY_SERVICE>(topology_service);
+    update_topology_service();
+}
+
+// Waits for a connection attempt or refresh in progress and closes the connection the
+// owner's factory opened, so the owner may release what it uses as soon as this returns.
+void TOPOLOGY_REFRESHER::detach(const void* owner) {
+    std::unique_lock<std::mutex> connection_lock(connection_mutex);
+    if (this->connection_owner == owner) {
+        close_connection();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(connection_factories_mutex);
+        this->connection_factories.erase(owner);
+    }
+    connection_lock.unlock();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    this->topology_services.erase(owner);
+    update_topology_service();
+}
+
+// Must be called with mutex_ held. Keeps the settings until the last owner detaches,
+// the refresher stops right after.
+void TOPOLOGY_REFRESHER::update_topology_service() {
+    std::shared_ptr<TOPOLOGY_SERVICE> most_frequent;
+    for (const auto& topology_service : this->topology_services) {
+        if (!most_frequent || topology_service.second->refresh_rate_in_ms < most_frequent->refresh_rate_in_ms) {
+            most_frequent = topology_service.second;
+        }
+    }
+
+    if (most_frequent && most_frequent != this->topology_service) {
+        this->topology_service = most_frequent;
+        // The next refresh may be due sooner
+        this->settings_changed = true;
+        this->refresh_cv.notify_all();
+    }
+}
+
+void TOPOLOGY_REFRESHER::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!this->stopped) {
+        const auto next_refresh_time = get_next_refresh_time();
+        if (this->refresh_cv.wait_until(lock, next_refresh_time,
+                                        [this] { return this->stopped || this->settings_changed; })) {
+            this->settings_changed = false;
+            continue;
+        }
+
+        lock.unlock();
+        refresh();
+        lock.lock();
+    }
+    lock.unlock();
+
+    std::unique_lock<std::mutex> connection_lock(connection_mutex);
+    close_connection();
+}
+
+bool TOPOLOGY_REFRESHER::refresh() {
+    std::shared_ptr<TOPOLOGY_SERVICE> topology_service;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        topology_service = this->topology_service;
+        this->last_refresh_attempt = std::chrono::system_clock::now();
+    }
+
+    // Foreground refreshes of the cluster's topology wait for this one
+    const auto refresh_mutex = topology_service->get_refresh_mutex();
+    std::unique_lock<std::mutex> refresh_lock(*refresh_mutex);
+
+    const auto cached_topology = topology_service->load_from_cache();
+    if (!cached_topology) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> connection_lock(connection_mutex);
+    if (!this->connection_proxy || !this->connection_proxy->is_connected()) {
+        close_connection();
+        this->connection_proxy = connect();
+        if (!this->connection_proxy) {
+            return false;
+        }
+    }
+
+    const auto latest_topology = topology_service->query_for_topology(this->connection_proxy);
+    if (!latest_topology) {
+        close_connection();
+        return false;
+    }
+
+    topology_service->put_to_cache(latest_topology);
+    return true;
+}
+
+std::chrono::system_clock::time_point TOPOLOGY_REFRESHER::get_next_refresh_time() {
+    const auto earliest_refresh_time = this->last_refresh_attempt + topology_min_refresh_delay;
+
+    const auto cached_topology = this->topology_service->load_from_cache();
+    if (!cached_topology) {
+        // Nothing to revalidate until a connection caches the topology
+        return (std::max)(earliest_refresh_time,
+            std::chrono::system_clock::now() + std::chrono::milliseconds(this->topology_service->refresh_rate_in_ms));
+    }
+
+    // Matches TOPOLOGY_SERVICE::refresh_needed(), the topology expires once a whole second past the refresh rate
+    const auto expiry_time = std::chrono::system_clock::from_time_t(cached_topology->time_last_updated())
+        + std::chrono::seconds(this->topology_service->refresh_rate_in_ms / 1000 + 1);
+
+    return (std::max)(earliest_refresh_time, expiry_time - topology_refresh_lead_time);
+}
+
+CONNECTION_PROXY* TOPOLOGY_REFRESHER::connect() {
+    std::unique_lock<std::mutex> lock(connection_factories_mutex);
+    for (const auto& connection_factory : this->connection_factories) {
+        const auto connection = connection_factory.second();
+        if (connection) {
+            this->connection_owner = connection_factory.first;
+            return connection;
+        }
+    }
+
+    return nullptr;
+}
+
+void TOPOLOGY_REFRESHER::close_connection() {
+    if (this->connection_proxy) {
+        this->connection_proxy->close();
+        delete this->connection_proxy;
+        this->connection_proxy = nullptr;
+    }
+    this->connection_owner = nullptr;
+}
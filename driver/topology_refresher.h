@@ -0,0 +1,112 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __TOPOLOGYREFRESHER_H__
+#define __TOPOLOGYREFRESHER_H__
+
+#include "topology_service.h"
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // How long before the cached topology expires the background refresh runs
+    const std::chrono::seconds topology_refresh_lead_time(2);
+    // Minimum delay between background refreshes, also the retry delay after a failed refresh
+    const std::chrono::seconds topology_min_refresh_delay(1);
+}
+
+typedef std::function<CONNECTION_PROXY*()> TOPOLOGY_CONNECTION_FACTORY;
+
+// Keeps the cached topology of a cluster up to date from a background thread, so that
+// connections to the cluster are always served the current topology without querying it
+// themselves. The refresher queries the topology over its own connection shortly before
+// the cached topology expires. It only revalidates a topology that is already cached.
+//
+// Connections to the cluster attach a factory the refresher uses to open its connection
+// and detach it when they close, which also closes the connection their factory opened.
+// The refresher uses the settings of the attached connection with the lowest refresh
+// rate, so that the topology is current for all of them. It stops once no connection holds it.
+class TOPOLOGY_REFRESHER {
+public:
+    TOPOLOGY_REFRESHER(std::shared_ptr<TOPOLOGY_SERVICE> topology_service);
+    TOPOLOGY_REFRESHER(TOPOLOGY_REFRESHER const&) = delete;
+    TOPOLOGY_REFRESHER& operator=(TOPOLOGY_REFRESHER const&) = delete;
+    virtual ~TOPOLOGY_REFRESHER();
+
+    // Returns the running refresher of the cluster of the given topology service, or starts one
+    static std::shared_ptr<TOPOLOGY_REFRESHER> get_instance(const TOPOLOGY_SERVICE& topology_service);
+
+    void attach(const void* owner, TOPOLOGY_CONNECTION_FACTORY connection_factory,
+                const TOPOLOGY_SERVICE& topology_service);
+    void detach(const void* owner);
+
+protected:
+    void run();
+    bool refresh();
+    std::chrono::system_clock::time_point get_next_refresh_time();
+    void update_topology_service();
+    CONNECTION_PROXY* connect();
+    void close_connection();
+
+    // Settings the refresher uses, guarded by mutex_
+    std::shared_ptr<TOPOLOGY_SERVICE> topology_service;
+    // Settings of each attached owner, guarded by mutex_
+    std::map<const void*, std::shared_ptr<TOPOLOGY_SERVICE>> topology_services;
+    bool settings_changed = false;
+    CONNECTION_PROXY* connection_proxy = nullptr;
+    // Whose factory opened the connection, it uses the handles of that owner
+    const void* connection_owner = nullptr;
+    // Held while the connection is used, opened or closed
+    std::mutex connection_mutex;
+    std::chrono::system_clock::time_point last_refresh_attempt;
+
+    std::map<const void*, TOPOLOGY_CONNECTION_FACTORY> connection_factories;
+    std::mutex connection_factories_mutex;
+
+    std::thread refresh_thread;
+    std::condition_variable refresh_cv;
+    std::mutex mutex_;
+    bool stopped = false;
+
+    static std::map<std::string, std::weak_ptr<TOPOLOGY_REFRESHER>> refreshers;
+    static std::mutex refreshers_mutex;
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private methods
+    friend class TEST_UTILS;
+#endif
+};
+
+#endif /* __TOPOLOGYREFRESHER_H__ */
@@ -30,6 +30,93 @@
 #include "cluster_aware_metrics_container.h"
 #include "topology_service.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+namespace {
+    // Weight of the latest connect attempt in the host connect statistics
+    const double connect_stats_smoothing = 0.3;
+    // Success probability floor, so that hosts failing every attempt still rank by their cost
+    const double min_connect_success_rate = 0.01;
+
+    // Reads a fixed width number, returns -1 if the characters are not all digits
+    int parse_digits(const char* str, int length) {
+        int value = 0;
+        for (int i = 0; i < length; i++) {
+            if (str[i] < '0' || str[i] > '9') {
+                return -1;
+            }
+            value = value * 10 + (str[i] - '0');
+        }
+        return value;
+    }
+
+    // Parses a "YYYY-MM-DD hh:mm:ss[.ffffff]" UTC timestamp, returns the epoch if it is malformed
+    std::chrono::system_clock::time_point parse_timestamp(const char* timestamp) {
+        if (!timestamp || strlen(timestamp) < 19 || timestamp[4] != '-' || timestamp[7] != '-'
+            || timestamp[10] != ' ' || timestamp[13] != ':' || timestamp[16] != ':') {
+            return std::chrono::system_clock::time_point{};
+        }
+
+        int year = parse_digits(timestamp, 4);
+        const int month = parse_digits(timestamp + 5, 2);
+        const int day = parse_digits(timestamp + 8, 2);
+        const int hour = parse_digits(timestamp + 11, 2);
+        const int minute = parse_digits(timestamp + 14, 2);
+        const int second = parse_digits(timestamp + 17, 2);
+        if (year < 0 || month < 1 || month > 12 || day < 1 || hour < 0 || minute < 0 || second < 0) {
+            return std::chrono::system_clock::time_point{};
+        }
+
+        long long microseconds = 0;
+        if (timestamp[19] == '.') {
+            long long scale = 100000;
+            for (const char* c = timestamp + 20; *c >= '0' && *c <= '9' && scale > 0; c++, scale /= 10) {
+                microseconds += (*c - '0') * scale;
+            }
+        }
+
+        // Days since the epoch of the proleptic Gregorian date
+        year -= month <= 2;
+        const int era = year / 400;
+        const int year_of_era = year - era * 400;
+        const int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        const long long days = era * 146097LL + day_of_era - 719468;
+
+        const std::chrono::microseconds since_epoch(
+            ((days * 24 + hour) * 60 + minute) * 60 * 1000000LL + second * 1000000LL + microseconds);
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(since_epoch));
+    }
+
+    int parse_replica_lag(const char* replica_lag) {
+        if (!replica_lag) {
+            return HOST_INFO::NO_REPLICA_LAG;
+        }
+
+        char* end = nullptr;
+        const double lag = std::strtod(replica_lag, &end);
+        return end != replica_lag && lag >= 0 ? static_cast<int>(std::lround(lag)) : HOST_INFO::NO_REPLICA_LAG;
+    }
+}
+
+std::shared_ptr<const TOPOLOGY_CACHE> TOPOLOGY_SERVICE::topology_cache = std::make_shared<TOPOLOGY_CACHE>();
+std::mutex TOPOLOGY_SERVICE::topology_cache_mutex;
+std::map<std::string, std::weak_ptr<std::mutex>> TOPOLOGY_SERVICE::topology_refresh_mutexes;
+
+std::unordered_map<HOST_ID, HOST_CONNECT_STATS> TOPOLOGY_SERVICE::connect_stats;
+std::mutex TOPOLOGY_SERVICE::connect_stats_mutex;
+
+double HOST_CONNECT_STATS::get_expected_connect_time_ms() const {
+    const double success_rate = (std::max)(1.0 - failure_rate, min_connect_success_rate);
+    const double attempt_time_ms = (1.0 - failure_rate) * latency_ms + failure_rate * failure_latency_ms;
+    return attempt_time_ms / success_rate;
+}
+
 TOPOLOGY_SERVICE::TOPOLOGY_SERVICE(unsigned long dbc_id, bool enable_logging)
     : dbc_id{dbc_id},
       cluster_instance_host{nullptr},
@@ -50,6 +137,8 @@ TOPOLOGY_SERVICE::TOPOLOGY_SERVICE(const TOPOLOGY_SERVICE& ts) {
     logger = ts.logger;
     dbc_id = ts.dbc_id;
     metrics_container = ts.metrics_container;
+    snapshot_directory = ts.snapshot_directory;
+    snapshot_ttl_in_ms = ts.snapshot_ttl_in_ms;
 }
 
 TOPOLOGY_SERVICE::~TOPOLOGY_SERVICE() {
@@ -81,6 +170,15 @@ void TOPOLOGY_SERVICE::set_refresh_rate(int refresh_rate) {
     refresh_rate_in_ms = refresh_rate;
 }
 
+void TOPOLOGY_SERVICE::set_background_refresh(bool background_refresh) {
+    this->background_refresh = background_refresh;
+}
+
+void TOPOLOGY_SERVICE::set_topology_snapshot(std::string directory, int ttl_ms) {
+    snapshot_directory = directory;
+    snapshot_ttl_in_ms = ttl_ms;
+}
+
 std::shared_ptr<HOST_INFO> TOPOLOGY_SERVICE::get_last_used_reader() {
     auto topology_info = get_from_cache();
     if (!topology_info || refresh_needed(topology_info->time_last_updated())) {
@@ -92,24 +190,19 @@ std::shared_ptr<HOST_INFO> TOPOLOGY_SERVICE::get_last_used_reader() {
 
 void TOPOLOGY_SERVICE::set_last_used_reader(std::shared_ptr<HOST_INFO> reader) {
     if (reader) {
-        std::unique_lock<std::mutex> lock(topology_cache_mutex);
-        auto topology_info = get_from_cache();
-        if (topology_info) {
-            topology_info->set_last_used_reader(reader);
-        }
-        lock.unlock();
+        update_cached_topology([&reader](CLUSTER_TOPOLOGY_INFO& topology_info) {
+            topology_info.set_last_used_reader(reader);
+        });
     }
 }
 
-std::set<std::string> TOPOLOGY_SERVICE::get_down_hosts() {
-    std::set<std::string> down_hosts;
+std::set<HOST_ID> TOPOLOGY_SERVICE::get_down_hosts() {
+    std::set<HOST_ID> down_hosts;
 
-    std::unique_lock<std::mutex> lock(topology_cache_mutex);
     auto topology_info = get_from_cache();
     if (topology_info) {
         down_hosts = topology_info->get_down_hosts();
     }
-    lock.unlock();
 
     return down_hosts;
 }
@@ -119,14 +212,9 @@ void TOPOLOGY_SERVICE::mark_host_down(std::shared_ptr<HOST_INFO> host) {
         return;
     }
 
-    std::unique_lock<std::mutex> lock(topology_cache_mutex);
-
-    auto topology_info = get_from_cache();
-    if (topology_info) {
-        topology_info->mark_host_down(host);
-    }
-
-    lock.unlock();
+    update_cached_topology([&host](CLUSTER_TOPOLOGY_INFO& topology_info) {
+        topology_info.mark_host_down(host);
+    });
 }
 
 void TOPOLOGY_SERVICE::mark_host_up(std::shared_ptr<HOST_INFO> host) {
@@ -134,29 +222,49 @@ void TOPOLOGY_SERVICE::mark_host_up(std::shared_ptr<HOST_INFO> host) {
         return;
     }
 
-    std::unique_lock<std::mutex> lock(topology_cache_mutex);
-
-    auto topology_info = get_from_cache();
-    if (topology_info) {
-        topology_info->mark_host_up(host);
-    }
-
-    lock.unlock();
+    update_cached_topology([&host](CLUSTER_TOPOLOGY_INFO& topology_info) {
+        topology_info.mark_host_up(host);
+    });
 }
 
 void TOPOLOGY_SERVICE::set_gather_metric(bool can_gather) {
     this->metrics_container->set_gather_metric(can_gather);
 }
 
+void TOPOLOGY_SERVICE::record_connect_attempt(HOST_ID host_id, bool connected, std::chrono::milliseconds duration) {
+    std::unique_lock<std::mutex> lock(connect_stats_mutex);
+    auto& stats = connect_stats[host_id];
+    const double duration_ms = static_cast<double>(duration.count());
+    // The first attempt of a host sets its statistics, later ones move them towards their outcome
+    auto update = [](double& average, double sample, bool first_sample) {
+        average = first_sample ? sample : average + connect_stats_smoothing * (sample - average);
+    };
+
+    update(stats.failure_rate, connected ? 0.0 : 1.0, stats.successes + stats.failures == 0);
+    if (connected) {
+        update(stats.latency_ms, duration_ms, stats.successes++ == 0);
+    } else {
+        update(stats.failure_latency_ms, duration_ms, stats.failures++ == 0);
+    }
+}
+
+HOST_CONNECT_STATS TOPOLOGY_SERVICE::get_connect_stats(HOST_ID host_id) {
+    std::unique_lock<std::mutex> lock(connect_stats_mutex);
+    const auto stats = connect_stats.find(host_id);
+    return stats != connect_stats.end() ? stats->second : HOST_CONNECT_STATS();
+}
+
 void TOPOLOGY_SERVICE::clear_all() {
     std::unique_lock<std::mutex> lock(topology_cache_mutex);
-    topology_cache.clear();
+    std::atomic_store(&topology_cache, std::shared_ptr<const TOPOLOGY_CACHE>(std::make_shared<TOPOLOGY_CACHE>()));
     lock.unlock();
 }
 
 void TOPOLOGY_SERVICE::clear() {
     std::unique_lock<std::mutex> lock(topology_cache_mutex);
-    topology_cache.erase(cluster_id);
+    auto cache = std::make_shared<TOPOLOGY_CACHE>(*topology_cache);
+    cache->erase(cluster_id);
+    std::atomic_store(&topology_cache, std::shared_ptr<const TOPOLOGY_CACHE>(std::move(cache)));
     lock.unlock();
 }
 
@@ -169,54 +277,134 @@ std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SERVICE::get_cached_topology() {
 // CLUSTER_TOPOLOGY_INFO->time_last_updated() prior and after the call if non-null information was given prior.
 std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SERVICE::get_topology(CONNECTION_PROXY* connection, bool force_update)
 {
-    //TODO reconsider using this cache. It appears that we only store information for the current cluster Id.
-    // therefore instead of a map we can just keep CLUSTER_TOPOLOGY_INFO* topology_info member variable.
     auto cached_topology = get_from_cache();
-    if (!cached_topology
-        || force_update
-        || refresh_needed(cached_topology->time_last_updated()))
-    {
-        auto latest_topology = query_for_topology(connection);
-        if (latest_topology) {
-            put_to_cache(latest_topology);
-            return latest_topology;
+    if (cached_topology && !force_update) {
+        if (!refresh_needed(cached_topology->time_last_updated())) {
+            return cached_topology;
+        }
+
+        // The background refresher revalidates the topology, serve the current one
+        // unless the refresher has not been able to update it for too long.
+        if (background_refresh && !cache_expired(cached_topology->time_last_updated())) {
+            return cached_topology;
         }
     }
 
+    const auto refresh_mutex = get_refresh_mutex();
+    std::unique_lock<std::mutex> refresh_lock(*refresh_mutex, std::defer_lock);
+    if (!force_update) {
+        // Another connection to the cluster may have refreshed the topology while we waited
+        refresh_lock.lock();
+        cached_topology = load_from_cache();
+        if (cached_topology && !refresh_needed(cached_topology->time_last_updated())) {
+            return cached_topology;
+        }
+
+        // A new process starts with the topology persisted by a previous one, if it is recent enough.
+        // It is served as is, it will be revalidated once it is due for a refresh.
+        if (!cached_topology) {
+            auto snapshot_topology = load_snapshot();
+            if (snapshot_topology) {
+                return snapshot_topology;
+            }
+        }
+    }
+
+    auto latest_topology = query_for_topology(connection);
+    if (latest_topology) {
+        put_to_cache(latest_topology);
+        return latest_topology;
+    }
+
     return cached_topology;
 }
 
-// TODO consider thread safety and usage of pointers
 std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SERVICE::get_from_cache() {
-    if (topology_cache.empty()) {
-        metrics_container->register_use_cached_topology(false);
+    auto topology_info = load_from_cache();
+    metrics_container->register_use_cached_topology(topology_info != nullptr);
+    return topology_info;
+}
+
+std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SERVICE::load_from_cache() {
+    const auto cache = std::atomic_load(&topology_cache);
+    const auto result = cache->find(cluster_id);
+    return result != cache->end() ? result->second : nullptr;
+}
+
+void TOPOLOGY_SERVICE::put_to_cache(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info) {
+    std::unique_lock<std::mutex> lock(topology_cache_mutex);
+    auto cache = std::make_shared<TOPOLOGY_CACHE>(*topology_cache);
+    (*cache)[cluster_id] = topology_info;
+    std::atomic_store(&topology_cache, std::shared_ptr<const TOPOLOGY_CACHE>(std::move(cache)));
+    lock.unlock();
+
+    save_snapshot(topology_info);
+}
+
+std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SERVICE::load_snapshot() {
+    if (snapshot_directory.empty()) {
         return nullptr;
     }
-        
-    auto result = topology_cache.find(cluster_id);
-    if (result == topology_cache.end()) {
-        metrics_container->register_use_cached_topology(false);
+
+    TOPOLOGY_SNAPSHOT snapshot(snapshot_directory, cluster_id);
+    auto topology_info = snapshot.read(std::chrono::milliseconds(snapshot_ttl_in_ms));
+    if (!topology_info) {
         return nullptr;
     }
-    
-    metrics_container->register_use_cached_topology(true);
-    return result->second;
+
+    MYLOG_TRACE(logger, dbc_id,
+                "[TOPOLOGY_SERVICE] Loaded topology snapshot %s", snapshot.get_path().c_str());
+    std::unique_lock<std::mutex> lock(topology_cache_mutex);
+    auto cache = std::make_shared<TOPOLOGY_CACHE>(*topology_cache);
+    (*cache)[cluster_id] = topology_info;
+    std::atomic_store(&topology_cache, std::shared_ptr<const TOPOLOGY_CACHE>(std::move(cache)));
+    lock.unlock();
+
+    return topology_info;
 }
 
-// TODO consider thread safety and usage of pointers
-void TOPOLOGY_SERVICE::put_to_cache(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info) {
-    if (!topology_cache.empty())
-    {
-        auto result = topology_cache.find(cluster_id);
-        if (result != topology_cache.end()) {
-            result->second.reset();
-            result->second = topology_info;
-            return;
-        }
+void TOPOLOGY_SERVICE::save_snapshot(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info) {
+    if (snapshot_directory.empty()) {
+        return;
+    }
+
+    TOPOLOGY_SNAPSHOT snapshot(snapshot_directory, cluster_id);
+    if (!snapshot.write(topology_info)) {
+        MYLOG_TRACE(logger, dbc_id,
+                    "[TOPOLOGY_SERVICE] Unable to write topology snapshot %s", snapshot.get_path().c_str());
     }
+}
+
+// Replace the cached topology of the cluster with an updated copy
+void TOPOLOGY_SERVICE::update_cached_topology(const std::function<void(CLUSTER_TOPOLOGY_INFO&)>& update) {
     std::unique_lock<std::mutex> lock(topology_cache_mutex);
-    topology_cache[cluster_id] = topology_info;
-    lock.unlock();
+    auto result = topology_cache->find(cluster_id);
+    if (result == topology_cache->end() || !result->second) {
+        return;
+    }
+
+    auto topology_info = std::make_shared<CLUSTER_TOPOLOGY_INFO>(*result->second);
+    update(*topology_info);
+
+    auto cache = std::make_shared<TOPOLOGY_CACHE>(*topology_cache);
+    (*cache)[cluster_id] = topology_info;
+    std::atomic_store(&topology_cache, std::shared_ptr<const TOPOLOGY_CACHE>(std::move(cache)));
+}
+
+std::shared_ptr<std::mutex> TOPOLOGY_SERVICE::get_refresh_mutex() {
+    std::unique_lock<std::mutex> lock(topology_cache_mutex);
+    auto refresh_mutex = topology_refresh_mutexes[cluster_id].lock();
+    if (refresh_mutex) {
+        return refresh_mutex;
+    }
+
+    // No refresh of the cluster is under way, drop the mutexes of the clusters not being refreshed either
+    for (auto it = topology_refresh_mutexes.begin(); it != topology_refresh_mutexes.end();) {
+        it = it->second.expired() ? topology_refresh_mutexes.erase(it) : std::next(it);
+    }
+    refresh_mutex = std::make_shared<std::mutex>();
+    topology_refresh_mutexes[cluster_id] = refresh_mutex;
+    return refresh_mutex;
 }
 
 MYSQL_RES* TOPOLOGY_SERVICE::try_execute_query(CONNECTION_PROXY* connection_proxy, const char* query) {
@@ -233,6 +421,10 @@ bool TOPOLOGY_SERVICE::refresh_needed(std::time_t last_updated) {
     return  time(0) - last_updated > (refresh_rate_in_ms / 1000);
 }
 
+bool TOPOLOGY_SERVICE::cache_expired(std::time_t last_updated) {
+    return time(0) - last_updated > (std::max)(refresh_rate_in_ms, DEFAULT_CACHE_EXPIRE_MS) / 1000;
+}
+
 std::shared_ptr<HOST_INFO> TOPOLOGY_SERVICE::create_host(MYSQL_ROW& row) {
 
     //TEMP and TODO figure out how to fetch values from row by name, not by ordinal for now this enum is matching
@@ -263,8 +455,8 @@ std::shared_ptr<HOST_INFO> TOPOLOGY_SERVICE::create_host(MYSQL_ROW& row) {
 
     host_info->instance_name = row[SERVER_ID] ? row[SERVER_ID] : "";
     host_info->session_id = row[SESSION] ? row[SESSION] : "";
-    host_info->last_updated = row[LAST_UPDATE_TIMESTAMP] ? row[LAST_UPDATE_TIMESTAMP] : "";
-    host_info->replica_lag = row[REPLICA_LAG_MILLISECONDS] ? row[REPLICA_LAG_MILLISECONDS] : "";
+    host_info->last_updated = parse_timestamp(row[LAST_UPDATE_TIMESTAMP]);
+    host_info->replica_lag_ms = parse_replica_lag(row[REPLICA_LAG_MILLISECONDS]);
 
     return host_info;
 }
@@ -285,7 +477,6 @@ std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SERVICE::query_for_topology(CONN
             if (host_info) {
                 if (host_info->is_host_writer()) {
                     // Only mark the latest writer as true writer. Ignore other writers (possible stale records, multi-writer not supported)
-                    // Date in lexographic order, so str comparison works for most recent date
                     if (!latest_writer || host_info->last_updated > latest_writer->last_updated) {
                         latest_writer = host_info;
                     }
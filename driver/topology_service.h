@@ -35,11 +35,14 @@
 #include "cluster_aware_metrics_container.h"
 #include "cluster_topology_info.h"
 #include "connection_proxy.h"
+#include "topology_snapshot.h"
 
 #include <map>
 #include <mutex>
+#include <unordered_map>
 #include <chrono>
 #include <ctime>
+#include <functional>
 
 
 // TODO - consider - do we really need miliseconds for refresh? - the default numbers here are already 30 seconds.000;
@@ -50,8 +53,20 @@
     WHERE time_to_sec(timediff(now(), LAST_UPDATE_TIMESTAMP)) <= 300 \
     ORDER BY LAST_UPDATE_TIMESTAMP DESC"
 
-static std::map<std::string, std::shared_ptr<CLUSTER_TOPOLOGY_INFO>> topology_cache;
-static std::mutex topology_cache_mutex;
+typedef std::map<std::string, std::shared_ptr<CLUSTER_TOPOLOGY_INFO>> TOPOLOGY_CACHE;
+
+// Connect statistics of a host, smoothed with an exponentially weighted moving average
+struct HOST_CONNECT_STATS {
+    int successes = 0;
+    int failures = 0;
+    double latency_ms = 0;          // Time successful connects take
+    double failure_latency_ms = 0;  // Time failed connects take
+    double failure_rate = 0;        // Share of connects that fail, from 0 to 1
+
+    // Expected time until connected when trying the host first, counting the time
+    // failed attempts waste in proportion to how likely they are
+    double get_expected_connect_time_ms() const;
+};
 
 class TOPOLOGY_SERVICE {
 public:
@@ -68,11 +83,16 @@ public:
 
     std::shared_ptr<HOST_INFO> get_last_used_reader();
     void set_last_used_reader(std::shared_ptr<HOST_INFO> reader);
-    std::set<std::string> get_down_hosts();
+    std::set<HOST_ID> get_down_hosts();
     virtual void mark_host_down(std::shared_ptr<HOST_INFO> host);
     virtual void mark_host_up(std::shared_ptr<HOST_INFO> host);
     void set_refresh_rate(int refresh_rate);
+    void set_background_refresh(bool background_refresh);
+    void set_topology_snapshot(std::string directory, int ttl_ms);
     void set_gather_metric(bool can_gather);
+
+    static void record_connect_attempt(HOST_ID host_id, bool connected, std::chrono::milliseconds duration);
+    static HOST_CONNECT_STATS get_connect_stats(HOST_ID host_id);
     void clear_all();
     void clear();
 
@@ -99,6 +119,11 @@ private:
 protected:
     const int NO_CONNECTION_INDEX = -1;
     int refresh_rate_in_ms;
+    // Set while a TOPOLOGY_REFRESHER keeps the cluster's cached topology up to date
+    bool background_refresh = false;
+    // Directory of the on-disk topology snapshots, snapshots are not used when it is empty
+    std::string snapshot_directory;
+    int snapshot_ttl_in_ms = 0;
 
     std::string cluster_id;
     std::shared_ptr<HOST_INFO> cluster_instance_host;
@@ -106,6 +131,7 @@ protected:
     std::shared_ptr<CLUSTER_AWARE_METRICS_CONTAINER> metrics_container;
 
     bool refresh_needed(std::time_t last_updated);
+    bool cache_expired(std::time_t last_updated);
     std::shared_ptr<CLUSTER_TOPOLOGY_INFO> query_for_topology(CONNECTION_PROXY* connection);
     std::shared_ptr<HOST_INFO> create_host(MYSQL_ROW& row);
     std::string get_host_endpoint(const char* node_name);
@@ -114,9 +140,33 @@ protected:
         std::shared_ptr<HOST_INFO> host_info);
 
     std::shared_ptr<CLUSTER_TOPOLOGY_INFO> get_from_cache();
+    std::shared_ptr<CLUSTER_TOPOLOGY_INFO> load_from_cache();
     void put_to_cache(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info);
+    std::shared_ptr<CLUSTER_TOPOLOGY_INFO> load_snapshot();
+    void save_snapshot(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info);
+    void update_cached_topology(const std::function<void(CLUSTER_TOPOLOGY_INFO&)>& update);
+    std::shared_ptr<std::mutex> get_refresh_mutex();
+
+    // Process-wide topology cache keyed by cluster id. Readers load the current snapshot of the
+    // cache without locking, writers copy it under topology_cache_mutex and swap the copy in.
+    // Topologies are never modified once cached, changes are made to a copy of the topology.
+    static std::shared_ptr<const TOPOLOGY_CACHE> topology_cache;
+    static std::mutex topology_cache_mutex;
+    // Serializes topology refreshes per cluster so that concurrent connections query it only once.
+    // A mutex only lives while a refresh of the cluster holds or waits for it.
+    static std::map<std::string, std::weak_ptr<std::mutex>> topology_refresh_mutexes;
+    // Process-wide connect statistics of the hosts, used to rank failover candidates
+    static std::unordered_map<HOST_ID, HOST_CONNECT_STATS> connect_stats;
+    static std::mutex connect_stats_mutex;
 
     MYSQL_RES* try_execute_query(CONNECTION_PROXY* connection_proxy, const char* query);
+
+    friend class TOPOLOGY_REFRESHER;
+
+#ifdef UNIT_TEST_BUILD
+    // Allows for testing private/protected methods
+    friend class TEST_UTILS;
+#endif
 };
 
 #endif /* __TOPOLOGYSERVICE_H__ */
@@ -0,0 +1,271 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "topology_snapshot.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char SNAPSHOT_HEADER[] = "AWS_TOPOLOGY_SNAPSHOT 1";
+    const char SNAPSHOT_EXTENSION[] = ".topology";
+    const char FIELD_SEPARATOR = '\t';
+    const char LINE_SEPARATOR = '\n';
+
+    enum HOST_FIELDS {
+        ROLE,
+        HOST,
+        PORT,
+        INSTANCE_NAME,
+        SESSION_ID,
+        REPLICA_LAG_MS,
+        LAST_UPDATED_US,
+        HOST_FIELD_COUNT
+    };
+
+    // Cluster ids are host:port pairs or user supplied, keep them to characters valid in file names
+    std::string get_file_name(const std::string& cluster_id) {
+        std::string file_name = cluster_id;
+        for (auto& c : file_name) {
+            const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                               (c >= '0' && c <= '9') || c == '.' || c == '-';
+            if (!valid) {
+                c = '_';
+            }
+        }
+        return file_name + SNAPSHOT_EXTENSION;
+    }
+
+    std::string get_snapshot_path(const std::string& directory, const std::string& cluster_id) {
+        if (directory.empty() || directory.back() == '/' || directory.back() == '\\') {
+            return directory + get_file_name(cluster_id);
+        }
+        return directory + '/' + get_file_name(cluster_id);
+    }
+
+    std::vector<std::string> split(const char* begin, const char* end, char separator) {
+        std::vector<std::string> parts;
+        const char* part_begin = begin;
+        for (const char* c = begin; c != end; c++) {
+            if (*c == separator) {
+                parts.emplace_back(part_begin, c);
+                part_begin = c + 1;
+            }
+        }
+        parts.emplace_back(part_begin, end);
+        return parts;
+    }
+
+    bool parse_number(const std::string& str, long long& value) {
+        if (str.empty()) {
+            return false;
+        }
+        char* end = nullptr;
+        value = std::strtoll(str.c_str(), &end, 10);
+        return *end == '\0';
+    }
+
+    std::string get_temp_path(const std::string& path) {
+        static std::atomic<unsigned int> temp_file_counter{0};
+#ifdef _WIN32
+        const unsigned long pid = GetCurrentProcessId();
+#else
+        const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+        return path + ".tmp." + std::to_string(pid) + "." + std::to_string(temp_file_counter++);
+    }
+
+    // Replaces the file at path with the temporary file, atomically where the platform allows it
+    bool replace_file(const std::string& temp_path, const std::string& path) {
+#ifdef _WIN32
+        return MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+    }
+}
+
+TOPOLOGY_SNAPSHOT::TOPOLOGY_SNAPSHOT(std::string directory, std::string cluster_id)
+    : cluster_id{cluster_id},
+      path{get_snapshot_path(directory, cluster_id)} {}
+
+const std::string& TOPOLOGY_SNAPSHOT::get_path() {
+    return path;
+}
+
+// The snapshot is mapped rather than read so that loading it costs no more than parsing it
+std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SNAPSHOT::read(std::chrono::milliseconds ttl) {
+    std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data) {
+                topology_info = parse(static_cast<const char*>(data), static_cast<size_t>(size.QuadPart), ttl);
+                UnmapViewOfFile(data);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        const size_t size = static_cast<size_t>(file_stat.st_size);
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            topology_info = parse(static_cast<const char*>(data), size, ttl);
+            munmap(data, size);
+        }
+    }
+    close(fd);
+#endif
+
+    return topology_info;
+}
+
+bool TOPOLOGY_SNAPSHOT::write(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info) {
+    if (!topology_info || topology_info->total_hosts() == 0) {
+        return false;
+    }
+
+    const std::string contents = serialize(topology_info);
+    const std::string temp_path = get_temp_path(path);
+
+    FILE* file = std::fopen(temp_path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written || !replace_file(temp_path, path)) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<CLUSTER_TOPOLOGY_INFO> TOPOLOGY_SNAPSHOT::parse(
+    const char* data, size_t size, std::chrono::milliseconds ttl) {
+
+    const auto lines = split(data, data + size, LINE_SEPARATOR);
+    // Header, cluster id, time the snapshot was taken, at least one host and the final line break
+    if (lines.size() < 5 || lines[0] != SNAPSHOT_HEADER || lines[1] != cluster_id || !lines.back().empty()) {
+        return nullptr;
+    }
+
+    long long saved_time = 0;
+    if (!parse_number(lines[2], saved_time)) {
+        return nullptr;
+    }
+
+    const auto age = std::chrono::system_clock::now() - std::chrono::system_clock::from_time_t(saved_time);
+    if (age > ttl) {
+        return nullptr;
+    }
+
+    auto topology_info = std::make_shared<CLUSTER_TOPOLOGY_INFO>();
+    for (size_t i = 3; i < lines.size() - 1; i++) {
+        const auto fields = split(lines[i].data(), lines[i].data() + lines[i].size(), FIELD_SEPARATOR);
+        long long port = 0, replica_lag_ms = 0, last_updated_us = 0;
+        if (fields.size() != HOST_FIELD_COUNT || fields[HOST].empty() ||
+            !parse_number(fields[PORT], port) ||
+            !parse_number(fields[REPLICA_LAG_MS], replica_lag_ms) ||
+            !parse_number(fields[LAST_UPDATED_US], last_updated_us)) {
+            return nullptr;
+        }
+
+        auto host_info = std::make_shared<HOST_INFO>(fields[HOST], static_cast<int>(port));
+        host_info->mark_as_writer(fields[ROLE] == "W");
+        host_info->instance_name = fields[INSTANCE_NAME];
+        host_info->session_id = fields[SESSION_ID];
+        host_info->replica_lag_ms = static_cast<int>(replica_lag_ms);
+        host_info->last_updated = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::microseconds(last_updated_us)));
+        topology_info->add_host(host_info);
+    }
+
+    // The topology is as old as the snapshot, so that it gets refreshed when it is due
+    topology_info->last_updated = static_cast<std::time_t>(saved_time);
+    return topology_info;
+}
+
+std::string TOPOLOGY_SNAPSHOT::serialize(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info) {
+    std::string contents = std::string(SNAPSHOT_HEADER) + LINE_SEPARATOR +
+                           cluster_id + LINE_SEPARATOR +
+                           std::to_string(static_cast<long long>(topology_info->time_last_updated())) +
+                           LINE_SEPARATOR;
+
+    auto append_hosts = [&contents](const std::vector<std::shared_ptr<HOST_INFO>>& hosts) {
+        for (const auto& host : hosts) {
+            const long long last_updated_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                host->last_updated.time_since_epoch()).count();
+            contents += (host->is_host_writer() ? "W" : "R") + std::string(1, FIELD_SEPARATOR) +
+                        host->get_host() + FIELD_SEPARATOR +
+                        std::to_string(host->get_port()) + FIELD_SEPARATOR +
+                        host->instance_name + FIELD_SEPARATOR +
+                        host->session_id + FIELD_SEPARATOR +
+                        std::to_string(host->replica_lag_ms) + FIELD_SEPARATOR +
+                        std::to_string(last_updated_us) + LINE_SEPARATOR;
+        }
+    };
+    append_hosts(topology_info->get_writers());
+    append_hosts(topology_info->get_readers());
+
+    return contents;
+}
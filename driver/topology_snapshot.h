@@ -0,0 +1,65 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#ifndef __TOPOLOGYSNAPSHOT_H__
+#define __TOPOLOGYSNAPSHOT_H__
+
+#include "cluster_topology_info.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+// Persists the topology of a cluster to disk so that a new process can start with the
+// topology a previous process discovered instead of querying it before its first connection.
+//
+// One snapshot file is kept per cluster id in the configured directory. Snapshots are
+// written to a temporary file which is then renamed over the previous snapshot, so readers
+// never see a partially written snapshot. Snapshots older than their TTL are ignored.
+class TOPOLOGY_SNAPSHOT {
+public:
+    TOPOLOGY_SNAPSHOT(std::string directory, std::string cluster_id);
+
+    const std::string& get_path();
+
+    // Returns the topology stored in the snapshot or nullptr if there is no valid
+    // snapshot of the cluster that was written within the last ttl.
+    std::shared_ptr<CLUSTER_TOPOLOGY_INFO> read(std::chrono::milliseconds ttl);
+    bool write(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info);
+
+private:
+    const std::string cluster_id;
+    const std::string path;
+
+    std::shared_ptr<CLUSTER_TOPOLOGY_INFO> parse(const char* data, size_t size, std::chrono::milliseconds ttl);
+    std::string serialize(std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info);
+};
+
+#endif /* __TOPOLOGYSNAPSHOT_H__ */
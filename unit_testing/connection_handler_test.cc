@@ -0,0 +1,108 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/connection_handler.h"
+#include "driver/driver.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "test_utils.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace {
+    class TEST_CONNECTION_HANDLER : public CONNECTION_HANDLER {
+    public:
+        TEST_CONNECTION_HANDLER(DBC* dbc) : CONNECTION_HANDLER(dbc) {}
+
+        MOCK_METHOD(SQLRETURN, do_connect, (DBC*, DataSource*, bool, bool), (override));
+    };
+}  // namespace
+
+class ConnectionHandlerTest : public testing::Test {
+protected:
+    SQLHENV env;
+    DBC* dbc;
+    DataSource* ds;
+
+    void SetUp() override {
+        allocate_odbc_handles(env, dbc, ds);
+        ds->opt_ENABLE_FAILURE_DETECTION = false;
+    }
+
+    void TearDown() override {
+        cleanup_odbc_handles(env, dbc, ds);
+    }
+};
+
+TEST_F(ConnectionHandlerTest, ConnectsWithoutApplicationHandle) {
+    TEST_CONNECTION_HANDLER connection_handler(dbc);
+    const size_t connections = dbc->env->conn_list.size();
+
+    EXPECT_CALL(connection_handler, do_connect(_, _, _, false))
+        .WillOnce(Invoke([&](DBC* connect_dbc, DataSource* connect_ds, bool, bool) {
+            EXPECT_NE(dbc, connect_dbc);
+            EXPECT_EQ(connections, dbc->env->conn_list.size());
+            EXPECT_STREQ("new-host", (const char*)connect_ds->opt_SERVER);
+            return SQL_SUCCESS;
+        }));
+
+    CONNECTION_PROXY* connection = connection_handler.connect(std::make_shared<HOST_INFO>("new-host", 3306), ds);
+    ASSERT_NE(nullptr, connection);
+    EXPECT_EQ(connections, dbc->env->conn_list.size());
+    EXPECT_EQ(dbc, TEST_UTILS::get_dbc(connection));
+
+    connection->delete_ds();
+    delete connection;
+}
+
+TEST_F(ConnectionHandlerTest, BackgroundConnectionWithoutHandle) {
+    TEST_CONNECTION_HANDLER connection_handler(dbc);
+
+    EXPECT_CALL(connection_handler, do_connect(_, _, _, true)).WillOnce(Return(SQL_SUCCESS));
+
+    CONNECTION_PROXY* connection = connection_handler.connect_background(std::make_shared<HOST_INFO>("new-host", 3306), ds, true);
+    ASSERT_NE(nullptr, connection);
+    EXPECT_EQ(nullptr, TEST_UTILS::get_dbc(connection));
+
+    connection->delete_ds();
+    delete connection;
+}
+
+TEST_F(ConnectionHandlerTest, FailedConnect) {
+    TEST_CONNECTION_HANDLER connection_handler(dbc);
+
+    EXPECT_CALL(connection_handler, do_connect(_, _, _, false)).WillOnce(Return(SQL_ERROR));
+
+    EXPECT_EQ(nullptr, connection_handler.connect(std::make_shared<HOST_INFO>("new-host", 3306), ds));
+}
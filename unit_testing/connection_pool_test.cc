@@ -0,0 +1,199 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/connection_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+class ConnectionPoolTest : public testing::Test {
+protected:
+    std::vector<MYSQL> handles = std::vector<MYSQL>(4);
+    std::set<MYSQL*> failing_reset;
+    std::set<MYSQL*> failing_validation;
+    std::vector<MYSQL*> resets;
+    std::vector<MYSQL*> closed;
+    // Default database of each connection, as changed by USE
+    std::map<MYSQL*, std::string> databases;
+    CONNECTION_POOL pool{
+        [this](MYSQL* mysql, const std::string& database) {
+            resets.push_back(mysql);
+            if (failing_reset.count(mysql)) {
+                return false;
+            }
+            if (database.empty()) {
+                return databases[mysql].empty();
+            }
+            databases[mysql] = database;
+            return true;
+        },
+        [this](MYSQL* mysql) { return failing_validation.count(mysql) == 0; },
+        [this](MYSQL* mysql) { closed.push_back(mysql); }};
+
+    MYSQL* handle(size_t i) { return &handles[i]; }
+
+    static CONNECTION_POOL_TAG tag(const std::string& key, const std::string& cluster_id = "cluster",
+                                   uint64_t generation = 0) {
+        CONNECTION_POOL_TAG tag;
+        tag.key = key;
+        tag.host = "database-test-name.cluster-XYZ.us-east-2.rds.amazonaws.com";
+        tag.port = 3306;
+        tag.cluster_id = cluster_id;
+        tag.generation = generation;
+        return tag;
+    }
+
+    static CONNECTION_POOL_TAG request(const std::string& key) {
+        CONNECTION_POOL_TAG tag;
+        tag.key = key;
+        return tag;
+    }
+};
+
+// Verify that a returned connection is reset and handed to the next connection with the same key only.
+TEST_F(ConnectionPoolTest, ReusesReturnedConnection) {
+    pool.release(tag("a"), handle(0), 10, std::chrono::minutes(1));
+    pool.release(tag("a"), handle(1), 10, std::chrono::minutes(1));
+    EXPECT_EQ(2u, pool.size());
+    EXPECT_EQ(std::vector<MYSQL*>({handle(0), handle(1)}), resets);
+
+    auto other = request("b");
+    EXPECT_EQ(nullptr, pool.acquire(other, false));
+
+    // The most recently returned connection first
+    auto next = request("a");
+    EXPECT_EQ(handle(1), pool.acquire(next, false));
+    EXPECT_EQ("database-test-name.cluster-XYZ.us-east-2.rds.amazonaws.com", next.host);
+    EXPECT_EQ(3306u, next.port);
+    EXPECT_EQ(1u, pool.size());
+    EXPECT_TRUE(closed.empty());
+}
+
+// Verify that connections returned to a full pool, or that fail to reset, are closed.
+TEST_F(ConnectionPoolTest, ClosesConnectionsItDoesNotKeep) {
+    failing_reset.insert(handle(2));
+
+    pool.release(tag("a"), handle(0), 1, std::chrono::minutes(1));
+    pool.release(tag("a"), handle(1), 1, std::chrono::minutes(1));
+    pool.release(tag("b"), handle(2), 1, std::chrono::minutes(1));
+    pool.release(tag("c"), handle(3), 0, std::chrono::minutes(1));
+
+    EXPECT_EQ(1u, pool.size());
+    EXPECT_EQ(std::vector<MYSQL*>({handle(1), handle(2), handle(3)}), closed);
+}
+
+// Verify that connections idle for longer than allowed are closed rather than handed out.
+TEST_F(ConnectionPoolTest, ClosesIdleConnections) {
+    pool.release(tag("a"), handle(0), 10, std::chrono::milliseconds(20));
+    pool.release(tag("b"), handle(1), 10, std::chrono::milliseconds(0));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto next = request("a");
+    EXPECT_EQ(nullptr, pool.acquire(next, false));
+    EXPECT_EQ(std::vector<MYSQL*>({handle(0)}), closed);
+
+    // Without a limit the connection is kept
+    next = request("b");
+    EXPECT_EQ(handle(1), pool.acquire(next, false));
+}
+
+// Verify that connections the server closed while they were idle are skipped.
+TEST_F(ConnectionPoolTest, SkipsDeadConnections) {
+    failing_validation.insert(handle(1));
+    pool.release(tag("a"), handle(0), 10, std::chrono::minutes(1));
+    pool.release(tag("a"), handle(1), 10, std::chrono::minutes(1));
+
+    auto next = request("a");
+    EXPECT_EQ(handle(0), pool.acquire(next, false));
+    EXPECT_EQ(std::vector<MYSQL*>({handle(1)}), closed);
+    EXPECT_EQ(0u, pool.size());
+}
+
+// Verify that connections opened without the failover timeouts are only taken when those are not needed.
+TEST_F(ConnectionPoolTest, MatchesFailoverTimeouts) {
+    auto with_timeouts = tag("a");
+    with_timeouts.failover_timeouts = true;
+    pool.release(with_timeouts, handle(0), 10, std::chrono::minutes(1));
+    pool.release(tag("a"), handle(1), 10, std::chrono::minutes(1));
+
+    auto next = request("a");
+    EXPECT_EQ(handle(0), pool.acquire(next, true));
+    EXPECT_TRUE(next.failover_timeouts);
+
+    next = request("a");
+    EXPECT_EQ(nullptr, pool.acquire(next, true));
+    EXPECT_EQ(handle(1), pool.acquire(next, false));
+    EXPECT_FALSE(next.failover_timeouts);
+}
+
+// Verify that invalidating a cluster closes its idle connections, and those opened before.
+TEST_F(ConnectionPoolTest, InvalidatesCluster) {
+    pool.release(tag("a", "cluster"), handle(0), 10, std::chrono::minutes(1));
+    pool.release(tag("b", "other-cluster"), handle(1), 10, std::chrono::minutes(1));
+
+    EXPECT_EQ(0u, pool.get_generation("cluster"));
+    pool.invalidate_cluster("cluster");
+    EXPECT_EQ(1u, pool.get_generation("cluster"));
+    EXPECT_EQ(std::vector<MYSQL*>({handle(0)}), closed);
+    EXPECT_EQ(1u, pool.size());
+
+    // Opened before the cluster was invalidated
+    pool.release(tag("a", "cluster", 0), handle(2), 10, std::chrono::minutes(1));
+    EXPECT_EQ(std::vector<MYSQL*>({handle(0), handle(2)}), closed);
+
+    pool.release(tag("a", "cluster", 1), handle(3), 10, std::chrono::minutes(1));
+    EXPECT_EQ(2u, pool.size());
+}
+
+// Verify that a connection whose application changed the default database is taken with the database of the data source.
+TEST_F(ConnectionPoolTest, RestoresDatabase) {
+    auto with_database = tag("a");
+    with_database.database = "db";
+    databases[handle(0)] = "otherdb";
+    pool.release(with_database, handle(0), 10, std::chrono::minutes(1));
+
+    auto next = request("a");
+    EXPECT_EQ(handle(0), pool.acquire(next, false));
+    EXPECT_EQ("db", databases[handle(0)]);
+    EXPECT_EQ("db", next.database);
+
+    // Without a database in the data source the connection can't be taken
+    databases[handle(1)] = "otherdb";
+    pool.release(tag("b"), handle(1), 10, std::chrono::minutes(1));
+    next = request("b");
+    EXPECT_EQ(nullptr, pool.acquire(next, false));
+    EXPECT_EQ(std::vector<MYSQL*>({handle(1)}), closed);
+}
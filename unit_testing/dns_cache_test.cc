@@ -0,0 +1,135 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/dns_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    const std::string host("database-test-name.cluster-XYZ.us-east-2.rds.amazonaws.com");
+}  // namespace
+
+class DnsCacheTest : public testing::Test {
+protected:
+    std::atomic<int> lookups{0};
+    std::mutex address_mutex;
+    std::string address = "10.10.10.10";
+    int resolve_delay_ms = 0;
+
+    HOST_RESOLVER resolver() {
+        return [this](const std::string& name) {
+            lookups++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(resolve_delay_ms));
+            std::lock_guard<std::mutex> lock(address_mutex);
+            return address;
+        };
+    }
+
+    void set_address(const std::string& new_address) {
+        std::lock_guard<std::mutex> lock(address_mutex);
+        address = new_address;
+    }
+};
+
+// Verify that a name is resolved once while its entry is fresh, and every time without a TTL.
+TEST_F(DnsCacheTest, CachesAddress) {
+    FAILOVER_EXECUTOR executor(1, 1);
+    DNS_CACHE cache(resolver(), executor);
+
+    EXPECT_EQ("10.10.10.10", cache.resolve(host, std::chrono::minutes(1)));
+    set_address("20.20.20.20");
+    EXPECT_EQ("10.10.10.10", cache.resolve(host, std::chrono::minutes(1)));
+    EXPECT_EQ(1, lookups);
+
+    EXPECT_EQ("20.20.20.20", cache.resolve(host, std::chrono::milliseconds(0)));
+    EXPECT_EQ(2, lookups);
+
+    cache.clear();
+    EXPECT_EQ("20.20.20.20", cache.resolve(host, std::chrono::minutes(1)));
+    EXPECT_EQ(3, lookups);
+}
+
+// Verify that names that do not resolve are not cached.
+TEST_F(DnsCacheTest, DoesNotCacheFailures) {
+    FAILOVER_EXECUTOR executor(1, 1);
+    DNS_CACHE cache(resolver(), executor);
+
+    set_address("");
+    EXPECT_EQ("", cache.resolve(host, std::chrono::minutes(1)));
+    set_address("10.10.10.10");
+    EXPECT_EQ("10.10.10.10", cache.resolve(host, std::chrono::minutes(1)));
+    EXPECT_EQ(2, lookups);
+}
+
+// Verify that an entry close to expiry is refreshed in the background while
+// the cached address is returned.
+TEST_F(DnsCacheTest, RefreshesBeforeExpiry) {
+    FAILOVER_EXECUTOR executor(1, 1);
+    DNS_CACHE cache(resolver(), executor);
+    const auto ttl = std::chrono::milliseconds(400);
+
+    EXPECT_EQ("10.10.10.10", cache.resolve(host, ttl));
+    set_address("20.20.20.20");
+
+    // Past three quarters of the TTL
+    std::this_thread::sleep_for(std::chrono::milliseconds(320));
+    EXPECT_EQ("10.10.10.10", cache.resolve(host, ttl));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ("20.20.20.20", cache.resolve(host, ttl));
+    EXPECT_EQ(2, lookups);
+}
+
+// Verify that concurrent lookups of a name that is not cached share one resolution.
+TEST_F(DnsCacheTest, SharesConcurrentLookups) {
+    FAILOVER_EXECUTOR executor(1, 1);
+    DNS_CACHE cache(resolver(), executor);
+    resolve_delay_ms = 200;
+
+    std::vector<std::string> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); i++) {
+        threads.emplace_back([&, i]() { results[i] = cache.resolve(host, std::chrono::minutes(1)); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& result : results) {
+        EXPECT_EQ("10.10.10.10", result);
+    }
+    EXPECT_EQ(1, lookups);
+}
@@ -37,6 +37,7 @@
 
 using testing::_;
 using testing::Return;
+using testing::StrEq;
 
 class EFMProxyTest : public testing::Test {
 protected:
@@ -104,6 +105,28 @@ TEST_F(EFMProxyTest, FailureDetectionEnabled) {
     efm_proxy.query(q);
 }
 
+TEST_F(EFMProxyTest, ReusesMonitoringContext) {
+    auto mock_context = std::make_shared<MONITOR_CONNECTION_CONTEXT>(
+        nullptr, std::set<std::string>(), std::chrono::milliseconds(0),
+        std::chrono::milliseconds(0), 0);
+    // Simulate the monitor having registered the context
+    mock_context->set_registered(true);
+
+    EXPECT_CALL(*mock_monitor_service, start_monitoring(_, _, _, _, _, _, _, _, _)).WillOnce(Return(mock_context));
+    EXPECT_CALL(*mock_monitor_service, stop_monitoring(mock_context)).Times(1);
+    const char *q = nullptr;
+    EXPECT_CALL(*mock_connection_proxy, query(q)).Times(3);
+    EXPECT_CALL(*mock_connection_proxy, mock_connection_proxy_destructor());
+
+    {
+        EFM_PROXY efm_proxy(dbc, ds, mock_connection_proxy, mock_monitor_service);
+        for (int i = 0; i < 3; i++) {
+            efm_proxy.query(q);
+            EXPECT_FALSE(mock_context->is_active_context());
+        }
+    }
+}
+
 TEST_F(EFMProxyTest, DoesNotNeedMonitoring) {
     EXPECT_CALL(*mock_monitor_service, start_monitoring(_, _, _, _, _, _, _, _, _)).Times(0);
     EXPECT_CALL(*mock_monitor_service, stop_monitoring(_)).Times(0);
@@ -113,3 +136,135 @@ TEST_F(EFMProxyTest, DoesNotNeedMonitoring) {
     EFM_PROXY efm_proxy(dbc, ds, mock_connection_proxy, mock_monitor_service);
     efm_proxy.close();
 }
+
+TEST_F(EFMProxyTest, LocalCallDoesNotNeedMonitoring) {
+    MYSQL_DATA data{};
+    MYSQL_RES buffered_result{};
+    buffered_result.data = &data;
+
+    EXPECT_CALL(*mock_monitor_service, start_monitoring(_, _, _, _, _, _, _, _, _)).Times(0);
+    EXPECT_CALL(*mock_monitor_service, stop_monitoring(_)).Times(0);
+    EXPECT_CALL(*mock_connection_proxy, fetch_row(&buffered_result)).WillOnce(Return(nullptr));
+    EXPECT_CALL(*mock_connection_proxy, mock_connection_proxy_destructor());
+
+    EFM_PROXY efm_proxy(dbc, ds, mock_connection_proxy, mock_monitor_service);
+    efm_proxy.fetch_row(&buffered_result);
+}
+
+TEST_F(EFMProxyTest, UnbufferedFetchNeedsMonitoring) {
+    auto mock_context = std::make_shared<MONITOR_CONNECTION_CONTEXT>(
+        nullptr, std::set<std::string>(), std::chrono::milliseconds(0),
+        std::chrono::milliseconds(0), 0);
+    MYSQL_RES unbuffered_result{};
+
+    EXPECT_CALL(*mock_monitor_service, start_monitoring(_, _, _, _, _, _, _, _, _)).WillOnce(Return(mock_context));
+    EXPECT_CALL(*mock_monitor_service, stop_monitoring(mock_context)).Times(1);
+    EXPECT_CALL(*mock_connection_proxy, fetch_row(&unbuffered_result)).WillOnce(Return(nullptr));
+    EXPECT_CALL(*mock_connection_proxy, mock_connection_proxy_destructor());
+
+    EFM_PROXY efm_proxy(dbc, ds, mock_connection_proxy, mock_monitor_service);
+    efm_proxy.fetch_row(&unbuffered_result);
+}
+
+TEST_F(EFMProxyTest, NetworkActivityClassification) {
+    const std::map<PROXY_CALL, NETWORK_ACTIVITY> expected = {
+        { PROXY_CALL::SET_CHARACTER_SET, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::CHANGE_USER, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::SELECT_DB, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::QUERY, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::REAL_QUERY, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STORE_RESULT, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::USE_RESULT, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::FREE_RESULT, NETWORK_ACTIVITY::RESULT_DEPENDENT },
+        { PROXY_CALL::FETCH_ROW, NETWORK_ACTIVITY::RESULT_DEPENDENT },
+        { PROXY_CALL::REAL_ESCAPE_STRING, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::BIND_PARAM, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::STMT_INIT, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::STMT_PREPARE, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STMT_EXECUTE, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STMT_FETCH, NETWORK_ACTIVITY::RESULT_DEPENDENT },
+        { PROXY_CALL::STMT_FETCH_COLUMN, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::STMT_STORE_RESULT, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STMT_BIND_NAMED_PARAM, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::STMT_BIND_PARAM, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::STMT_BIND_RESULT, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::STMT_CLOSE, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STMT_RESET, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STMT_FREE_RESULT, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STMT_SEND_LONG_DATA, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::STMT_RESULT_METADATA, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::NEXT_RESULT, NETWORK_ACTIVITY::NETWORK },
+        { PROXY_CALL::MORE_RESULTS, NETWORK_ACTIVITY::LOCAL },
+        { PROXY_CALL::STMT_NEXT_RESULT, NETWORK_ACTIVITY::NETWORK }
+    };
+
+    ASSERT_EQ(static_cast<size_t>(PROXY_CALL::COUNT), expected.size());
+    for (const auto& entry : expected) {
+        EXPECT_EQ(entry.second, EFM_PROXY::get_network_activity(entry.first))
+            << "Unexpected classification for call " << static_cast<int>(entry.first);
+    }
+}
+
+TEST_F(EFMProxyTest, ReportsNodeMarkedUnhealthy) {
+    const std::string node_key = "unhealthy-node.domain:3306";
+    EXPECT_CALL(*mock_connection_proxy, get_host()).WillRepeatedly(Return("unhealthy-node.domain"));
+    EXPECT_CALL(*mock_connection_proxy, get_port()).WillRepeatedly(Return(3306));
+    EXPECT_CALL(*mock_connection_proxy, is_node_unhealthy()).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mock_connection_proxy, mock_connection_proxy_destructor());
+
+    EFM_PROXY efm_proxy(dbc, ds, mock_connection_proxy, mock_monitor_service);
+    EXPECT_FALSE(efm_proxy.is_node_unhealthy());
+
+    // Another connection's monitor found the node to be dead
+    const auto node_health_table = NODE_HEALTH_TABLE::get_instance();
+    node_health_table->set_node_unhealthy({ node_key }, true);
+    EXPECT_TRUE(efm_proxy.is_node_unhealthy());
+
+    node_health_table->set_node_unhealthy({ node_key }, false);
+    EXPECT_FALSE(efm_proxy.is_node_unhealthy());
+}
+
+TEST_F(EFMProxyTest, CachesNodeKeysOfInstance) {
+    SERVER_INFO_CACHE::get_instance().clear();
+    const std::string host = "database-test-name-1.XYZ.us-east-2.rds.amazonaws.com";
+    char server_version[] = "8.0.32";
+    char* row[] = { (char*)"ip-10-0-0-1:3306" };
+    const std::set<std::string> node_keys = { host + ":3306", "ip-10-0-0-1:3306" };
+    auto mock_context = std::make_shared<MONITOR_CONNECTION_CONTEXT>(
+        nullptr, std::set<std::string>(), std::chrono::milliseconds(0),
+        std::chrono::milliseconds(0), 0);
+    auto other_connection_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+
+    for (auto proxy : { mock_connection_proxy, other_connection_proxy }) {
+        EXPECT_CALL(*proxy, is_connected()).WillRepeatedly(Return(true));
+        EXPECT_CALL(*proxy, get_host()).WillRepeatedly(Return(host));
+        EXPECT_CALL(*proxy, get_port()).WillRepeatedly(Return(3306));
+        EXPECT_CALL(*proxy, get_server_version()).WillRepeatedly(Return(server_version));
+        EXPECT_CALL(*proxy, select_db(_)).WillOnce(Return(0));
+        EXPECT_CALL(*proxy, mock_connection_proxy_destructor());
+    }
+
+    // Only the first connection to the instance queries its node keys
+    EXPECT_CALL(*mock_connection_proxy, query(StrEq("SELECT CONCAT(@@hostname, ':', @@port)"))).WillOnce(Return(0));
+    EXPECT_CALL(*mock_connection_proxy, store_result()).WillOnce(Return(nullptr));
+    EXPECT_CALL(*mock_connection_proxy, fetch_row(_)).WillOnce(Return(row)).WillOnce(Return(nullptr));
+    EXPECT_CALL(*mock_connection_proxy, free_result(_));
+    EXPECT_CALL(*other_connection_proxy, query(_)).Times(0);
+
+    EXPECT_CALL(*mock_monitor_service, start_monitoring(_, _, node_keys, _, _, _, _, _, _))
+        .Times(2).WillRepeatedly(Return(mock_context));
+    EXPECT_CALL(*mock_monitor_service, stop_monitoring(mock_context)).Times(2);
+
+    {
+        EFM_PROXY efm_proxy(dbc, ds, nullptr, mock_monitor_service);
+        efm_proxy.set_next_proxy(mock_connection_proxy);
+        efm_proxy.select_db("test");
+    }
+    {
+        EFM_PROXY efm_proxy(dbc, ds, nullptr, mock_monitor_service);
+        efm_proxy.set_next_proxy(other_connection_proxy);
+        efm_proxy.select_db("test");
+    }
+
+    SERVER_INFO_CACHE::get_instance().clear();
+}
@@ -0,0 +1,172 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/failover.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+    template <typename PREDICATE>
+    bool wait_until(PREDICATE predicate, int timeout_ms = 5000) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+}  // namespace
+
+class FailoverExecutorTest : public testing::Test {};
+
+// Verify that tasks beyond the parallelism queue up instead of starting more threads.
+TEST_F(FailoverExecutorTest, BoundsThreads) {
+    FAILOVER_EXECUTOR executor(2, 8);
+    auto release = std::make_shared<FAILOVER_SYNC>(1);
+    std::atomic<int> finished{0};
+
+    for (int i = 0; i < 6; i++) {
+        executor.submit([&](int id) {
+            release->wait_for_completion(5000);
+            finished++;
+        });
+    }
+
+    EXPECT_TRUE(wait_until([&]() { return executor.get_metrics().active_tasks == 2; }));
+    auto metrics = executor.get_metrics();
+    EXPECT_EQ(2, metrics.threads);
+    EXPECT_EQ(4, metrics.queue_depth);
+
+    release->mark_as_complete(true);
+    EXPECT_TRUE(wait_until([&]() { return finished == 6; }));
+    EXPECT_TRUE(wait_until([&]() { return executor.get_metrics().active_tasks == 0; }));
+    metrics = executor.get_metrics();
+    EXPECT_EQ(0, metrics.queue_depth);
+    EXPECT_EQ(6, metrics.completed_tasks);
+}
+
+// Verify that a task queued behind others is dropped once its token is cancelled.
+TEST_F(FailoverExecutorTest, DropsCancelledTasks) {
+    FAILOVER_EXECUTOR executor(1, 1);
+    auto release = std::make_shared<FAILOVER_SYNC>(1);
+    auto f_sync = std::make_shared<FAILOVER_SYNC>(1);
+    std::atomic<bool> ran{false};
+
+    executor.submit([&](int id) { release->wait_for_completion(5000); });
+    executor.submit([&](int id) { ran = true; }, f_sync);
+
+    EXPECT_TRUE(wait_until([&]() { return executor.get_metrics().active_tasks == 1; }));
+    f_sync->mark_as_complete(true);
+    release->mark_as_complete(true);
+
+    EXPECT_TRUE(wait_until([&]() { return executor.get_metrics().queue_depth == 0; }));
+    EXPECT_TRUE(wait_until([&]() { return executor.get_metrics().cancelled_tasks == 1; }));
+    EXPECT_FALSE(ran);
+
+    // Tasks with a cancelled token are not queued at all
+    executor.submit([&](int id) { ran = true; }, f_sync);
+    EXPECT_EQ(2, executor.get_metrics().cancelled_tasks);
+    EXPECT_FALSE(ran);
+}
+
+// Verify that a task waiting for the tasks it submitted does not hold back the only
+// thread they could run on. It runs one of them itself, and another thread picks the
+// other one up from its queue.
+TEST_F(FailoverExecutorTest, WaitingTaskLetsSubtasksRun) {
+    FAILOVER_EXECUTOR executor(1, 4);
+    auto done = std::make_shared<FAILOVER_SYNC>(1);
+    std::atomic<int> subtasks_completed{0};
+
+    executor.submit([&](int id) {
+        auto f_sync = std::make_shared<FAILOVER_SYNC>(2);
+        // Each subtask waits for the other one, so they have to run on different threads
+        auto first_started = std::make_shared<FAILOVER_SYNC>(1);
+        auto second_started = std::make_shared<FAILOVER_SYNC>(1);
+        for (int i = 0; i < 2; i++) {
+            auto started = i == 0 ? first_started : second_started;
+            auto other_started = i == 0 ? second_started : first_started;
+            executor.submit([&, f_sync, started, other_started](int id) {
+                started->mark_as_complete(true);
+                if (other_started->wait_for_completion(5000)) {
+                    subtasks_completed++;
+                }
+                f_sync->mark_as_complete(false);
+            });
+        }
+        f_sync->wait_and_complete(5000);
+        done->mark_as_complete(true);
+    });
+
+    EXPECT_TRUE(done->wait_for_completion(5000));
+    EXPECT_EQ(2, subtasks_completed);
+
+    const auto metrics = executor.get_metrics();
+    EXPECT_EQ(2, metrics.threads);
+    EXPECT_EQ(1, metrics.stolen_tasks);
+}
+
+// Verify that with more failovers at a time than threads, the connection attempts of each
+// failover still run, rather than waiting behind the other failovers until they time out.
+TEST_F(FailoverExecutorTest, MoreFailoversThanParallelism) {
+    FAILOVER_EXECUTOR executor(2, 4);
+    const int failovers = 8;
+    const int attempts = 3;
+    std::atomic<int> completed_failovers{0};
+    std::atomic<int> completed_attempts{0};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < failovers; i++) {
+        executor.submit([&](int id) {
+            auto f_sync = std::make_shared<FAILOVER_SYNC>(attempts);
+            for (int j = 0; j < attempts; j++) {
+                executor.submit([&, f_sync](int id) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    completed_attempts++;
+                    f_sync->mark_as_complete(false);
+                }, f_sync);
+            }
+            f_sync->wait_and_complete(10000);
+            completed_failovers++;
+        });
+    }
+
+    EXPECT_TRUE(wait_until([&]() { return completed_failovers == failovers; }, 10000));
+    EXPECT_EQ(failovers * attempts, completed_attempts);
+    // Well within the timeout of the waits
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_LE(executor.get_metrics().threads, 4u);
+}
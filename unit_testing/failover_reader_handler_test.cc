@@ -30,7 +30,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
+#include <ctime>
 #include <thread>
 
 #include "test_utils.h"
@@ -61,7 +63,7 @@ protected:
     MOCK_CONNECTION_PROXY* mock_reader_a_proxy;
     MOCK_CONNECTION_PROXY* mock_reader_b_proxy;
     MOCK_CONNECTION_PROXY* mock_writer_proxy;
-    ctpl::thread_pool failover_thread_pool;
+    FAILOVER_EXECUTOR failover_executor{4, 16};
 
     static std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology;
     
@@ -158,7 +160,7 @@ TEST_F(FailoverReaderHandlerTest, GenerateTopology) {
 }
 
 TEST_F(FailoverReaderHandlerTest, BuildHostsList) {
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 60000, 30000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
     std::shared_ptr<CLUSTER_TOPOLOGY_INFO> topology_info;
     std::vector<std::shared_ptr<HOST_INFO>> hosts_list;
 
@@ -218,6 +220,30 @@ TEST_F(FailoverReaderHandlerTest, BuildHostsList) {
     EXPECT_TRUE(hosts_list[2]->is_host_writer());
 }
 
+TEST_F(FailoverReaderHandlerTest, BuildHostsList_LeastLag) {
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0,
+                                           false, READER_SELECTOR(LEAST_LAG_SELECTION));
+
+    auto topology_info = std::make_shared<CLUSTER_TOPOLOGY_INFO>();
+    const int lags[] = { 300, 20, 100 };
+    for (int i = 0; i < 3; i++) {
+        auto reader = std::make_shared<HOST_INFO>("reader-" + std::to_string(i) + HOST_SUFFIX, 1234, UP, false);
+        reader->replica_lag_ms = lags[i];
+        topology_info->add_host(reader);
+    }
+    auto lagging_reader_down = std::make_shared<HOST_INFO>("reader-down" + HOST_SUFFIX, 1234, DOWN, false);
+    lagging_reader_down->replica_lag_ms = 0;
+    topology_info->add_host(lagging_reader_down);
+
+    // Readers that are up go first, each group ordered by replica lag.
+    auto hosts_list = reader_handler.build_hosts_list(topology_info, false);
+    ASSERT_EQ(4, hosts_list.size());
+    EXPECT_EQ(20, hosts_list[0]->replica_lag_ms);
+    EXPECT_EQ(100, hosts_list[1]->replica_lag_ms);
+    EXPECT_EQ(300, hosts_list[2]->replica_lag_ms);
+    EXPECT_TRUE(hosts_list[3]->is_host_down());
+}
+
 // Verify that reader failover handler fails to connect to any reader node or writer node.
 // Expected result: no new connection
 TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_Failure) {
@@ -230,7 +256,7 @@ TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_Failure) {
     EXPECT_CALL(*mock_ts, mark_host_down(reader_c_host)).Times(1);
     EXPECT_CALL(*mock_ts, mark_host_down(writer_host)).Times(1);
 
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 60000, 30000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
     auto hosts_list = reader_handler.build_hosts_list(topology, true);
     auto result = reader_handler.get_connection_from_hosts(hosts_list, mock_sync);
 
@@ -253,7 +279,7 @@ TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_Success_Reader) {
     // Reader C will not be used as it is put at the end. Will only try to connect to A and B
     EXPECT_CALL(*mock_ts, mark_host_up(reader_a_host)).Times(1);
 
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 60000, 30000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
     auto hosts_list = reader_handler.build_hosts_list(topology, true);
     auto result = reader_handler.get_connection_from_hosts(hosts_list, mock_sync);
 
@@ -279,7 +305,7 @@ TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_Success_Writer) {
 
     EXPECT_CALL(*mock_ts, mark_host_up(writer_host)).Times(1);
 
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 60000, 30000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
     auto hosts_list = reader_handler.build_hosts_list(topology, true);
     auto result = reader_handler.get_connection_from_hosts(hosts_list, mock_sync);
 
@@ -316,7 +342,7 @@ TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_FastestHost) {
             return mock_reader_b_proxy;
         }));
 
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 60000, 30000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
     auto hosts_list = reader_handler.build_hosts_list(topology, true);
     auto result = reader_handler.get_connection_from_hosts(hosts_list, mock_sync);
 
@@ -355,7 +381,7 @@ TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_Timeout) {
     EXPECT_CALL(*mock_ts, mark_host_down(_)).Times(AnyNumber());
     EXPECT_CALL(*mock_ts, mark_host_down(writer_host)).Times(1);
 
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 60000, 1000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 1000, false, 0);
     auto hosts_list = reader_handler.build_hosts_list(topology, true);
     auto result = reader_handler.get_connection_from_hosts(hosts_list, mock_sync);
 
@@ -363,6 +389,63 @@ TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_Timeout) {
     EXPECT_THAT(result->new_connection, nullptr);
 }
 
+// Verify that reader failover handler tries all hosts at once with a fan-out covering the whole list.
+// Expected result: new connection to the writer, without waiting for the slow readers
+TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_Fanout) {
+    mock_writer_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+
+    EXPECT_CALL(*mock_writer_proxy, is_connected()).WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mock_connection_handler, connect_impl(_, nullptr, false)).WillRepeatedly(Invoke([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5000));
+        return nullptr;
+    }));
+    EXPECT_CALL(*mock_connection_handler, connect_impl(writer_host, nullptr, false)).WillRepeatedly(Return(mock_writer_proxy));
+    EXPECT_CALL(*mock_ts, mark_host_down(_)).Times(AnyNumber());
+
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0,
+                                           READER_SELECTOR(), 4);
+    auto hosts_list = reader_handler.build_hosts_list(topology, true);
+    ASSERT_EQ(4, hosts_list.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = reader_handler.get_connection_from_hosts(hosts_list, mock_sync);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(result->connected);
+    EXPECT_THAT(result->new_connection, mock_writer_proxy);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(5000));
+
+    // Explicit delete as it is returned as result & is not deconstructed during failover
+    delete mock_writer_proxy;
+}
+
+// Verify that staggered attempts that have not started yet are cancelled once a host connects.
+// Expected result: new connection to reader A, reader B is never tried
+TEST_F(FailoverReaderHandlerTest, GetConnectionFromHosts_StaggeredAttemptCancelled) {
+    mock_reader_a_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+
+    EXPECT_CALL(*mock_reader_a_proxy, is_connected()).WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mock_connection_handler, connect_impl(reader_a_host, nullptr, false)).WillRepeatedly(Invoke([=]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return mock_reader_a_proxy;
+    }));
+    EXPECT_CALL(*mock_connection_handler, connect_impl(reader_b_host, nullptr, false)).Times(0);
+    EXPECT_CALL(*mock_ts, mark_host_up(reader_a_host)).Times(1);
+
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0,
+                                           READER_SELECTOR(), 2, 2000);
+    std::vector<std::shared_ptr<HOST_INFO>> hosts_list = { reader_a_host, reader_b_host };
+    auto result = reader_handler.get_connection_from_hosts(hosts_list, mock_sync);
+
+    EXPECT_TRUE(result->connected);
+    EXPECT_THAT(result->new_connection, mock_reader_a_proxy);
+
+    // Explicit delete on reader A as it is returned as valid connection/result
+    delete mock_reader_a_proxy;
+}
+
 // Verify that reader failover handler fails to connect to any reader node or
 // writer node. Expected result: no new connection
 TEST_F(FailoverReaderHandlerTest, Failover_Failure) {
@@ -375,7 +458,7 @@ TEST_F(FailoverReaderHandlerTest, Failover_Failure) {
     EXPECT_CALL(*mock_ts, mark_host_down(reader_c_host)).Times(AtLeast(1));
     EXPECT_CALL(*mock_ts, mark_host_down(writer_host)).Times(AtLeast(1));
 
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 3000, 1000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 3000, 1000, false, 0);
     auto result = reader_handler.failover(topology);
 
     EXPECT_FALSE(result->connected);
@@ -412,7 +495,7 @@ TEST_F(FailoverReaderHandlerTest, Failover_Success_Reader) {
         return mock_reader_b_proxy;
     }));
 
-    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_thread_pool, 60000, 30000, false, 0);
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
     auto result = reader_handler.failover(current_topology);
 
     EXPECT_TRUE(result->connected);
@@ -423,3 +506,41 @@ TEST_F(FailoverReaderHandlerTest, Failover_Success_Reader) {
     // Explicit delete on reader A as it's returned as a valid result
     delete mock_reader_a_proxy;
 }
+
+// Verify that looking for a reader during an outage, where every host refuses connections
+// right away, sleeps between attempts instead of retrying in a busy loop.
+// Expected result: a handful of attempts and little CPU time over the outage
+TEST_F(FailoverReaderHandlerTest, GetReaderConnection_Outage) {
+    const int outage_ms = 3000;
+    std::atomic<int> connect_attempts{0};
+
+    EXPECT_CALL(*mock_connection_handler, connect_impl(_, nullptr, false)).WillRepeatedly(Invoke([&]() {
+        connect_attempts++;
+        return nullptr;
+    }));
+    EXPECT_CALL(*mock_ts, mark_host_down(_)).Times(AnyNumber());
+
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
+    auto f_sync = std::make_shared<FAILOVER_SYNC>(1);
+
+#ifndef _WIN32
+    // std::clock measures wall time on Windows
+    const std::clock_t cpu_start = std::clock();
+#endif
+    std::shared_ptr<READER_FAILOVER_RESULT> result;
+    std::thread failover_thread([&]() {
+        result = reader_handler.get_reader_connection(topology, f_sync);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(outage_ms));
+    f_sync->mark_as_complete(true);
+    failover_thread.join();
+
+    EXPECT_FALSE(result->connected);
+    // Three readers per round, about one round per second
+    EXPECT_LE(connect_attempts, 3 * (outage_ms / 1000 + 2));
+#ifndef _WIN32
+    const double cpu_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    EXPECT_LT(cpu_ms, outage_ms / 10);
+#endif
+}
@@ -69,7 +69,7 @@ class FailoverWriterHandlerTest : public testing::Test {
     MOCK_CONNECTION_PROXY* mock_reader_b_proxy;
     MOCK_CONNECTION_PROXY* mock_writer_proxy;
     MOCK_CONNECTION_PROXY* mock_new_writer_proxy;
-    ctpl::thread_pool failover_thread_pool;
+    FAILOVER_EXECUTOR failover_executor{4, 16};
 
     static void SetUpTestSuite() {}
 
@@ -134,7 +134,7 @@ TEST_F(FailoverWriterHandlerTest, ReconnectToWriter_TaskBEmptyReaderResult) {
         .WillRepeatedly(Return(nullptr));
 
     FAILOVER_WRITER_HANDLER writer_handler(
-        mock_ts, mock_reader_handler, mock_connection_handler, failover_thread_pool, 5000, 2000, 2000, 0);
+        mock_ts, mock_reader_handler, mock_connection_handler, failover_executor, 5000, 2000, 2000, 0);
     auto result = writer_handler.failover(current_topology);
 
     EXPECT_TRUE(result->connected);
@@ -195,7 +195,7 @@ TEST_F(FailoverWriterHandlerTest, ReconnectToWriter_SlowReaderA) {
                                           mock_reader_a_proxy))));
 
     FAILOVER_WRITER_HANDLER writer_handler(
-        mock_ts, mock_reader_handler, mock_connection_handler, failover_thread_pool, 60000, 5000, 5000, 0);
+        mock_ts, mock_reader_handler, mock_connection_handler, failover_executor, 60000, 5000, 5000, 0);
     const auto result = writer_handler.failover(current_topology);
 
     EXPECT_TRUE(result->connected);
@@ -240,7 +240,7 @@ TEST_F(FailoverWriterHandlerTest, ReconnectToWriter_TaskBDefers) {
                                                     mock_reader_a_proxy)));
 
     FAILOVER_WRITER_HANDLER writer_handler(
-        mock_ts, mock_reader_handler, mock_connection_handler, failover_thread_pool, 60000, 2000, 2000, 0);
+        mock_ts, mock_reader_handler, mock_connection_handler, failover_executor, 60000, 2000, 2000, 0);
     auto result = writer_handler.failover(current_topology);
 
     EXPECT_TRUE(result->connected);
@@ -303,7 +303,7 @@ TEST_F(FailoverWriterHandlerTest, ConnectToReaderA_SlowWriter) {
                                                     mock_reader_a_proxy)));
 
     FAILOVER_WRITER_HANDLER writer_handler(
-        mock_ts, mock_reader_handler, mock_connection_handler, failover_thread_pool, 60000, 5000, 5000, 0);
+        mock_ts, mock_reader_handler, mock_connection_handler, failover_executor, 60000, 5000, 5000, 0);
     auto result = writer_handler.failover(current_topology);
 
     EXPECT_TRUE(result->connected);
@@ -362,7 +362,7 @@ TEST_F(FailoverWriterHandlerTest, ConnectToReaderA_TaskADefers) {
                                                     mock_reader_a_proxy)));
 
     FAILOVER_WRITER_HANDLER writer_handler(
-        mock_ts, mock_reader_handler, mock_connection_handler, failover_thread_pool, 60000, 5000, 5000, 0);
+        mock_ts, mock_reader_handler, mock_connection_handler, failover_executor, 60000, 5000, 5000, 0);
     auto result = writer_handler.failover(current_topology);
 
     EXPECT_TRUE(result->connected);
@@ -431,7 +431,7 @@ TEST_F(FailoverWriterHandlerTest, FailedToConnect_FailoverTimeout) {
                                                     mock_reader_a_proxy)));
 
     FAILOVER_WRITER_HANDLER writer_handler(
-        mock_ts, mock_reader_handler, mock_connection_handler, failover_thread_pool, 1000, 2000, 2000, 0);
+        mock_ts, mock_reader_handler, mock_connection_handler, failover_executor, 1000, 2000, 2000, 0);
     auto result = writer_handler.failover(current_topology);
 
     EXPECT_FALSE(result->connected);
@@ -480,7 +480,7 @@ TEST_F(FailoverWriterHandlerTest, FailedToConnect_TaskAFailed_TaskBWriterFailed)
                                                     mock_reader_a_proxy)));
 
     FAILOVER_WRITER_HANDLER writer_handler(
-        mock_ts, mock_reader_handler, mock_connection_handler, failover_thread_pool, 5000, 2000, 2000, 0);
+        mock_ts, mock_reader_handler, mock_connection_handler, failover_executor, 5000, 2000, 2000, 0);
     auto result = writer_handler.failover(current_topology);
 
     EXPECT_FALSE(result->connected);
@@ -240,3 +240,13 @@ TEST_F(IamProxyTest, UseRegularPortWhenAuthPortIsNotProvided) {
 
     TEST_UTILS::clear_token_cache(iam_proxy);
 }
+
+TEST_F(IamProxyTest, AuthUtilCreatesClientLazily) {
+    // Constructing the helper must not initialize the AWS API or create a client;
+    // that only happens when a token has to be generated.
+    AUTH_UTIL auth_util(TEST_REGION.c_str());
+    EXPECT_FALSE(TEST_UTILS::has_rds_client(auth_util));
+
+    AUTH_UTIL default_region_auth_util;
+    EXPECT_FALSE(TEST_UTILS::has_rds_client(default_region_auth_util));
+}
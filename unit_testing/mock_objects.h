@@ -75,13 +75,22 @@ public:
     MOCK_METHOD(char**, fetch_row, (MYSQL_RES*));
     MOCK_METHOD(void, free_result, (MYSQL_RES*));
     MOCK_METHOD(void, close_socket, ());
+    MOCK_METHOD(bool, is_node_unhealthy, ());
     MOCK_METHOD(void, mock_connection_proxy_destructor, ());
     MOCK_METHOD(void, close, ());
     MOCK_METHOD(void, init, ());
     MOCK_METHOD(int, ping, ());
+    MOCK_METHOD(net_async_status, ping_nonblocking, ());
     MOCK_METHOD(void, delete_ds, ());
     MOCK_METHOD(bool, connect, (const char*, const char*, const char*, const char*, unsigned int, const char*, unsigned long));
     MOCK_METHOD(unsigned int, error_code, ());
+    MOCK_METHOD(const char*, error, ());
+    MOCK_METHOD(int, select_db, (const char*));
+    MOCK_METHOD(int, real_query, (const char*, unsigned long));
+    MOCK_METHOD(char*, get_server_version, (), (const));
+    MOCK_METHOD(unsigned long, get_server_capabilities, (), (const));
+    MOCK_METHOD(unsigned int, get_server_status, (), (const));
+    MOCK_METHOD(void, get_character_set_info, (MY_CHARSET_INFO*));
 };
 
 class MOCK_TOPOLOGY_SERVICE : public TOPOLOGY_SERVICE {
@@ -97,11 +106,9 @@ public:
 
 class MOCK_READER_HANDLER : public FAILOVER_READER_HANDLER {
 public:
-    MOCK_READER_HANDLER() : FAILOVER_READER_HANDLER(nullptr, nullptr, thread_pool, 0, 0, false, 0) {}
+    MOCK_READER_HANDLER() : FAILOVER_READER_HANDLER(nullptr, nullptr, FAILOVER_EXECUTOR::get_instance(), 0, 0, false, 0) {}
     MOCK_METHOD(std::shared_ptr<READER_FAILOVER_RESULT>, get_reader_connection,
         (std::shared_ptr<CLUSTER_TOPOLOGY_INFO>, std::shared_ptr<FAILOVER_SYNC>));
-
-    ctpl::thread_pool thread_pool;
 };
 
 class MOCK_CONNECTION_HANDLER : public CONNECTION_HANDLER {
@@ -155,16 +162,16 @@ public:
     MOCK_METHOD(void, start_monitoring, (std::shared_ptr<MONITOR_CONNECTION_CONTEXT>));
     MOCK_METHOD(void, stop_monitoring, (std::shared_ptr<MONITOR_CONNECTION_CONTEXT>));
     MOCK_METHOD(bool, is_stopped, ());
-    MOCK_METHOD(void, run, (std::shared_ptr<MONITOR_SERVICE>));
+    MOCK_METHOD(bool, run_once, (std::shared_ptr<MONITOR_SERVICE>, std::chrono::milliseconds&));
 };
 
-// Meant for tests that only need to mock Monitor.run()
+// Meant for tests that only need to mock Monitor.run_once()
 class MOCK_MONITOR2 : public MONITOR {
 public:
     MOCK_MONITOR2(std::shared_ptr<HOST_INFO> host, std::chrono::milliseconds disposal_time)
         : MONITOR(host, nullptr, std::chrono::seconds{ 5 }, disposal_time, nullptr, nullptr) {}
 
-    MOCK_METHOD(void, run, (std::shared_ptr<MONITOR_SERVICE>));
+    MOCK_METHOD(bool, run_once, (std::shared_ptr<MONITOR_SERVICE>, std::chrono::milliseconds&));
 };
 
 // Meant for tests that only need to mock get_current_time()
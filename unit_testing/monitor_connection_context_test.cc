@@ -127,3 +127,39 @@ TEST_F(MonitorConnectionContextTest, IsNodeUnhealthyExceedsFailureDetectionCount
     context->set_connection_valid(false, status_check_start_time, status_check_end_time);
     EXPECT_TRUE(context->is_node_unhealthy());
 }
+
+TEST_F(MonitorConnectionContextTest, IsNodeUnhealthyExceedsSuspicionThreshold) {
+    const double suspicion_threshold = 8;
+    std::chrono::steady_clock::time_point current_time = std::chrono::steady_clock::now();
+
+    // Failed checks below the threshold don't make the node unhealthy, however many there are
+    for (int i = 0; i < 7; i++) {
+        context->update_connection_suspicion(
+            current_time, current_time + validation_interval, false, suspicion_threshold / 2, suspicion_threshold);
+        EXPECT_FALSE(context->is_node_unhealthy());
+        current_time += validation_interval;
+    }
+    EXPECT_EQ(7, context->get_failure_count());
+
+    context->update_connection_suspicion(
+        current_time, current_time + validation_interval, false, suspicion_threshold, suspicion_threshold);
+    EXPECT_TRUE(context->is_node_unhealthy());
+}
+
+// Verify that a single slow probe doesn't abort the connection, however suspicious, before the
+// node has been unresponsive for the failure interval times the failure count.
+TEST_F(MonitorConnectionContextTest, SingleLatencySpikeKeepsNodeHealthy) {
+    const double suspicion_threshold = 8;
+    std::chrono::steady_clock::time_point current_time = std::chrono::steady_clock::now();
+
+    context->update_connection_suspicion(
+        current_time, current_time + validation_interval, false, suspicion_threshold * 2, suspicion_threshold);
+    EXPECT_FALSE(context->is_node_unhealthy());
+
+    current_time += validation_interval;
+    context->update_connection_suspicion(
+        current_time, current_time + std::chrono::milliseconds(1), true, 0, suspicion_threshold);
+    EXPECT_FALSE(context->is_node_unhealthy());
+    EXPECT_EQ(0, context->get_failure_count());
+    EXPECT_FALSE(context->is_invalid_node_start_time_defined());
+}
@@ -81,7 +81,7 @@ TEST_F(MonitorServiceTest, StartMonitoring) {
         .WillOnce(Return(mock_monitor));
 
     EXPECT_CALL(*mock_monitor, start_monitoring(_)).Times(1);
-    EXPECT_CALL(*mock_monitor, run(_)).Times(1);
+    EXPECT_CALL(*mock_monitor, run_once(_, _)).Times(1);
 
     auto context = monitor_service->start_monitoring(
         dbc,
@@ -103,7 +103,7 @@ TEST_F(MonitorServiceTest, StartMonitoringCalledMultipleTimes) {
     const int runs = 5;
 
     EXPECT_CALL(*mock_monitor, start_monitoring(_)).Times(runs);
-    EXPECT_CALL(*mock_monitor, run(_)).Times(1);
+    EXPECT_CALL(*mock_monitor, run_once(_, _)).Times(1);
 
     for (int i = 0; i < runs; i++) {
         auto context = monitor_service->start_monitoring(
@@ -125,7 +125,7 @@ TEST_F(MonitorServiceTest, StopMonitoring) {
         .WillOnce(Return(mock_monitor));
 
     EXPECT_CALL(*mock_monitor, start_monitoring(_)).Times(1);
-    EXPECT_CALL(*mock_monitor, run(_)).Times(1);
+    EXPECT_CALL(*mock_monitor, run_once(_, _)).Times(1);
 
     auto context = monitor_service->start_monitoring(
         dbc,
@@ -149,7 +149,7 @@ TEST_F(MonitorServiceTest, StopMonitoringCalledTwice) {
         .WillOnce(Return(mock_monitor));
 
     EXPECT_CALL(*mock_monitor, start_monitoring(_)).Times(1);
-    EXPECT_CALL(*mock_monitor, run(_)).Times(1);
+    EXPECT_CALL(*mock_monitor, run_once(_, _)).Times(1);
 
     auto context = monitor_service->start_monitoring(
         dbc,
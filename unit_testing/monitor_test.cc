@@ -41,6 +41,7 @@ using ::testing::AllOf;
 using ::testing::AtLeast;
 using ::testing::Eq;
 using ::testing::Field;
+using ::testing::Invoke;
 using ::testing::Return;
 
 namespace {
@@ -198,6 +199,170 @@ TEST_F(MonitorTest, IsConnectionHealthyAfterFailedConnection) {
     EXPECT_TRUE(second_status.elapsed_time >= std::chrono::milliseconds(0));
 }
 
+TEST_F(MonitorTest, PollConnectionStatusWaitsForReply) {
+    mock_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+    auto monitorA =
+        std::make_shared<MONITOR>(host, mock_connection_handler, failure_detection_timeout, short_interval, ds, mock_proxy);
+
+    EXPECT_CALL(*mock_proxy, is_connected()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_proxy, ping()).Times(0);
+    EXPECT_CALL(*mock_proxy, ping_nonblocking())
+        .WillOnce(Return(NET_ASYNC_NOT_READY))
+        .WillOnce(Return(NET_ASYNC_NOT_READY))
+        .WillOnce(Return(NET_ASYNC_COMPLETE))
+        .WillOnce(Return(NET_ASYNC_ERROR));
+
+    CONNECTION_STATUS status;
+    EXPECT_FALSE(TEST_UTILS::poll_connection_status(monitorA, status));
+    EXPECT_FALSE(TEST_UTILS::poll_connection_status(monitorA, status));
+    EXPECT_TRUE(TEST_UTILS::poll_connection_status(monitorA, status));
+    EXPECT_TRUE(status.is_valid);
+
+    EXPECT_TRUE(TEST_UTILS::poll_connection_status(monitorA, status));
+    EXPECT_FALSE(status.is_valid);
+}
+
+TEST_F(MonitorTest, PollConnectionStatusTimesOut) {
+    const auto timeout = std::chrono::seconds(1);
+    mock_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+    auto monitorA =
+        std::make_shared<MONITOR>(host, mock_connection_handler, timeout, short_interval, ds, mock_proxy);
+
+    EXPECT_CALL(*mock_proxy, is_connected()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_proxy, ping_nonblocking()).WillRepeatedly(Return(NET_ASYNC_NOT_READY));
+    // The unresponsive monitoring connection is dropped so that the next check reconnects
+    EXPECT_CALL(*mock_proxy, close()).Times(1);
+    EXPECT_CALL(*mock_proxy, mock_connection_proxy_destructor());
+
+    CONNECTION_STATUS status;
+    while (!TEST_UTILS::poll_connection_status(monitorA, status)) {
+        std::this_thread::sleep_for(validation_interval);
+    }
+
+    EXPECT_FALSE(status.is_valid);
+    EXPECT_TRUE(status.elapsed_time >= timeout);
+}
+
+// Verify that monitors whose node hangs while connecting don't hold the thread checking them,
+// the connects run on other threads while the check is polled.
+TEST_F(MonitorTest, PollConnectionStatusDoesNotWaitForConnect) {
+    const int hanging_nodes = 6;
+    std::atomic_bool released{false};
+    std::atomic_int connects_started{0};
+    std::vector<MOCK_CONNECTION_PROXY*> proxies;
+    for (int i = 0; i < hanging_nodes; i++) {
+        proxies.push_back(new MOCK_CONNECTION_PROXY(dbc, ds));
+        EXPECT_CALL(*proxies.back(), is_connected()).WillRepeatedly(Return(true));
+    }
+
+    EXPECT_CALL(*mock_connection_handler, connect_impl(host, _, true))
+        .Times(hanging_nodes)
+        .WillRepeatedly(Invoke([&](std::shared_ptr<HOST_INFO>, DataSource*, bool) -> CONNECTION_PROXY* {
+            const int i = connects_started++;
+            for (int wait = 0; wait < 500 && !released; wait++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return proxies[i];
+        }));
+
+    std::vector<std::shared_ptr<MONITOR>> monitors;
+    CONNECTION_STATUS status;
+    for (int i = 0; i < hanging_nodes; i++) {
+        monitors.push_back(
+            std::make_shared<MONITOR>(host, mock_connection_handler, failure_detection_timeout, short_interval, ds, nullptr));
+        EXPECT_FALSE(TEST_UTILS::poll_connection_status(monitors.back(), status));
+    }
+
+    // All nodes are being connected to at the same time
+    for (int wait = 0; wait < 500 && connects_started < hanging_nodes; wait++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(hanging_nodes, connects_started);
+    for (const auto& monitor : monitors) {
+        EXPECT_FALSE(TEST_UTILS::poll_connection_status(monitor, status));
+    }
+
+    released = true;
+    for (const auto& monitor : monitors) {
+        bool completed = false;
+        for (int wait = 0; wait < 500 && !completed; wait++) {
+            completed = TEST_UTILS::poll_connection_status(monitor, status);
+            if (!completed) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        EXPECT_TRUE(completed);
+        EXPECT_TRUE(status.is_valid);
+    }
+}
+
+// Verify that a connect taking longer than the failure detection timeout fails the check,
+// and that the connection is closed once the connect completes.
+TEST_F(MonitorTest, PollConnectionStatusConnectTimesOut) {
+    const auto timeout = std::chrono::seconds(1);
+    std::atomic_bool released{false};
+    std::atomic_bool closed{false};
+    auto proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+    EXPECT_CALL(*proxy, close()).WillOnce(Invoke([&closed]() { closed = true; }));
+    EXPECT_CALL(*proxy, delete_ds());
+    EXPECT_CALL(*proxy, mock_connection_proxy_destructor());
+
+    EXPECT_CALL(*mock_connection_handler, connect_impl(host, _, true))
+        .WillOnce(Invoke([&](std::shared_ptr<HOST_INFO>, DataSource*, bool) -> CONNECTION_PROXY* {
+            for (int wait = 0; wait < 500 && !released; wait++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return proxy;
+        }));
+
+    auto monitorA = std::make_shared<MONITOR>(host, mock_connection_handler, timeout, short_interval, ds, nullptr);
+
+    CONNECTION_STATUS status;
+    while (!TEST_UTILS::poll_connection_status(monitorA, status)) {
+        std::this_thread::sleep_for(validation_interval);
+    }
+    EXPECT_FALSE(status.is_valid);
+    EXPECT_TRUE(status.elapsed_time >= timeout);
+
+    released = true;
+    for (int wait = 0; wait < 500 && !closed; wait++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(closed);
+}
+
+TEST_F(MonitorTest, PublishesNodeHealth) {
+    mock_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+    auto monitorA =
+        std::make_shared<MONITOR>(host, mock_connection_handler, failure_detection_timeout, monitor_disposal_time, ds, mock_proxy);
+
+    EXPECT_CALL(*mock_proxy, is_connected()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_proxy, ping_nonblocking())
+        .WillOnce(Return(NET_ASYNC_ERROR))
+        .WillOnce(Return(NET_ASYNC_COMPLETE));
+
+    // A single failed check is enough to declare the node dead
+    const std::string node_key = "published.node.domain";
+    auto context = std::make_shared<MONITOR_CONNECTION_CONTEXT>(
+        nullptr,
+        std::set<std::string>{ node_key },
+        std::chrono::milliseconds(0),
+        failure_detection_time,
+        0);
+    monitorA->start_monitoring(context);
+
+    const auto node_health_table = NODE_HEALTH_TABLE::get_instance();
+    std::chrono::milliseconds next_run_delay(0);
+
+    EXPECT_TRUE(monitorA->run_once(nullptr, next_run_delay));
+    EXPECT_TRUE(node_health_table->is_node_unhealthy(node_key));
+
+    // The monitored call has ended, but the monitor keeps checking the unhealthy node
+    context->invalidate();
+    EXPECT_TRUE(monitorA->run_once(nullptr, next_run_delay));
+    EXPECT_FALSE(node_health_table->is_node_unhealthy(node_key));
+}
+
 TEST_F(MonitorTest, RunWithoutContext) {
     std::shared_ptr<MONITOR_THREAD_CONTAINER> container = MONITOR_THREAD_CONTAINER::get_instance();
     auto monitor_service = std::make_shared<MONITOR_SERVICE>(container);
@@ -230,7 +395,7 @@ TEST_F(MonitorTest, RunWithContext) {
         .WillOnce(Return(proxy));
 
     EXPECT_CALL(*proxy, is_connected()).WillRepeatedly(Return(true));
-    EXPECT_CALL(*proxy, ping()).WillRepeatedly(Return(0));
+    EXPECT_CALL(*proxy, ping_nonblocking()).WillRepeatedly(Return(NET_ASYNC_COMPLETE));
 
     std::shared_ptr<MONITOR> monitorA = 
         std::make_shared<MONITOR>(host, mock_connection_handler, failure_detection_timeout, short_interval, ds, nullptr);
@@ -273,6 +438,86 @@ TEST_F(MonitorTest, RunWithContext) {
     EXPECT_FALSE(TEST_UTILS::has_task(container, monitorA));
 }
 
+TEST_F(MonitorTest, RunWakesUpWhenContextIsArmed) {
+    auto proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+
+    // The monitor only connects once it has been woken up by the armed context
+    EXPECT_CALL(*mock_connection_handler, connect_impl(host, _, true))
+        .WillOnce(Return(proxy));
+
+    EXPECT_CALL(*proxy, is_connected()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*proxy, ping_nonblocking()).WillRepeatedly(Return(NET_ASYNC_COMPLETE));
+
+    std::shared_ptr<MONITOR> monitorA =
+        std::make_shared<MONITOR>(host, mock_connection_handler, failure_detection_timeout, short_interval, ds, nullptr);
+
+    auto container = MONITOR_THREAD_CONTAINER::get_instance();
+    auto monitor_service = std::make_shared<MONITOR_SERVICE>(container);
+
+    std::string node_key = "monitorA";
+    TEST_UTILS::populate_monitor_map(container, { node_key }, monitorA);
+    TEST_UTILS::populate_task_map(container, monitorA);
+
+    auto context = std::make_shared<MONITOR_CONNECTION_CONTEXT>(
+        nullptr,
+        node_keys,
+        failure_detection_time,
+        long_interval,
+        failure_detection_count);
+
+    // Register the context but leave it disarmed, so the monitor stays idle
+    monitorA->start_monitoring(context);
+    context->invalidate();
+
+    std::thread thread(
+        [&monitorA, &context]() {
+            std::this_thread::sleep_for(short_interval);
+            context->arm(std::chrono::steady_clock::now());
+            std::this_thread::sleep_for(short_interval);
+            context->invalidate();
+            monitorA->stop_monitoring(context);
+        });
+
+    // Run monitor. Should end by itself after above thread stops monitoring.
+    monitorA->run(monitor_service);
+
+    thread.join();
+
+    EXPECT_FALSE(TEST_UTILS::has_monitor(container, node_key));
+    EXPECT_FALSE(TEST_UTILS::has_task(container, monitorA));
+}
+
+// Verify that only the first context armed since the monitor went idle wakes it up.
+TEST_F(MonitorTest, ArmingIdleMonitorWakesItOnce) {
+    auto container = MONITOR_THREAD_CONTAINER::get_instance();
+    auto monitor_service = std::make_shared<MONITOR_SERVICE>(container);
+    monitor->start();
+    monitor->set_thread_container(container);
+
+    auto context = std::make_shared<MONITOR_CONNECTION_CONTEXT>(
+        nullptr,
+        node_keys,
+        failure_detection_time,
+        short_interval,
+        failure_detection_count);
+    monitor->start_monitoring(context);
+    context->invalidate();
+
+    // No context is armed, the monitor gets parked
+    std::chrono::milliseconds next_run_delay(0);
+    EXPECT_TRUE(monitor->run_once(monitor_service, next_run_delay));
+    EXPECT_EQ((std::chrono::milliseconds::max)(), next_run_delay);
+    EXPECT_EQ(0, TEST_UTILS::get_woken_task_count(container));
+
+    context->arm(std::chrono::steady_clock::now());
+    context->invalidate();
+    context->arm(std::chrono::steady_clock::now());
+    EXPECT_EQ(1, TEST_UTILS::get_woken_task_count(container));
+
+    context->invalidate();
+    monitor->stop_monitoring(context);
+}
+
 // Verify that if 0 timeout is passed in, we should set it to default value
 TEST_F(MonitorTest, ZeroEFMTimeout) {
     auto proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
@@ -213,7 +213,7 @@ TEST_F(MonitorThreadContainerTest, AvailableMonitorsQueue) {
         .WillOnce(Return(false))
         .WillOnce(Return(true));
 
-    EXPECT_CALL(*mock_monitor1, run(_));
+    EXPECT_CALL(*mock_monitor1, run_once(_, _));
     
     // This first call should create the monitor.
     auto monitor1 = mock_thread_container->get_or_create_monitor(
@@ -33,6 +33,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <iostream>
+
 using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::Return;
@@ -167,7 +170,7 @@ TEST_F(MultiThreadedMonitorServiceTest, StartAndStopMonitoring_MultipleConnectio
         auto mock_monitor = std::make_shared<MOCK_MONITOR2>(host, monitor_disposal_time);
         monitors.push_back(mock_monitor);
 
-        EXPECT_CALL(*monitors[i], run(_)).Times(AtLeast(1));
+        EXPECT_CALL(*monitors[i], run_once(_, _)).Times(AtLeast(1));
     }
 
     Sequence s1;
@@ -207,7 +210,7 @@ TEST_F(MultiThreadedMonitorServiceTest, StartAndStopMonitoring_MultipleConnectio
     EXPECT_CALL(*mock_container, create_monitor(_, _, _, _, _, _))
         .WillOnce(Return(mock_monitor));
 
-    EXPECT_CALL(*mock_monitor, run(_)).Times(AtLeast(1));
+    EXPECT_CALL(*mock_monitor, run_once(_, _)).Times(AtLeast(1));
 
     run_start_monitor(num_connections, services, node_key_list, host);
 
@@ -228,3 +231,57 @@ TEST_F(MultiThreadedMonitorServiceTest, StartAndStopMonitoring_MultipleConnectio
 
     EXPECT_EQ(0, TEST_UTILS::get_contexts(mock_monitor).size());
 }
+
+// Measures monitor lookups for connections to already monitored nodes under contention.
+// Reports lookups/sec for each thread count, no thresholds are enforced. It only reports
+// timings, so it is run with --gtest_also_run_disabled_tests.
+TEST_F(MultiThreadedMonitorServiceTest, DISABLED_MonitorLookupContention) {
+    const int num_nodes = 64;
+    const std::chrono::milliseconds run_time(100);
+
+    std::vector<std::set<std::string>> node_key_list;
+    for (int i = 0; i < num_nodes; i++) {
+        std::set<std::string> node_keys = { "node" + std::to_string(i), "instance-" + std::to_string(i) + ".domain:3306" };
+        auto mock_monitor = std::make_shared<MOCK_MONITOR2>(host, monitor_disposal_time);
+        TEST_UTILS::populate_monitor_map(mock_container, node_keys, mock_monitor);
+        node_key_list.push_back(node_keys);
+    }
+
+    EXPECT_CALL(*mock_container, create_monitor(_, _, _, _, _, _)).Times(0);
+
+    for (const int num_threads : { 1, 4, 16, 64 }) {
+        std::atomic_bool done{ false };
+        std::atomic<long long> lookups{ 0 };
+        std::atomic_int failed_lookups{ 0 };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; i++) {
+            threads.push_back(std::thread([&, i]() {
+                long long count = 0;
+                while (!done) {
+                    const auto& node_keys = node_key_list[(i + count) % num_nodes];
+                    const auto monitor = mock_container->get_or_create_monitor(
+                        node_keys, host, failure_detection_timeout, monitor_disposal_time, ds, nullptr);
+                    if (monitor == nullptr) {
+                        failed_lookups++;
+                    }
+                    count++;
+                }
+                lookups += count;
+            }));
+        }
+
+        std::this_thread::sleep_for(run_time);
+        done = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::cout << "[ BENCHMARK ] " << num_threads << " threads: "
+                  << lookups * 1000 / run_time.count() << " lookups/sec" << std::endl;
+        EXPECT_LT(0, lookups.load());
+        EXPECT_EQ(0, failed_lookups.load());
+    }
+
+    EXPECT_EQ(2 * num_nodes, TEST_UTILS::get_map_size(mock_container));
+}
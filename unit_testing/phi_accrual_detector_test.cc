@@ -0,0 +1,130 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+#include "driver/phi_accrual_detector.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+    const double phi_threshold = 8;
+
+    typedef std::chrono::duration<double, std::milli> RTT;
+
+    // Probes may take up to 100ms longer than usual, the standard deviation is at least 10ms
+    const std::chrono::milliseconds interval(100);
+
+    // Round-trip times of a node on a quiet network, 20ms +/- 1ms
+    const std::vector<double> steady_trace = {
+        20.1, 19.8, 20.4, 19.6, 20.0, 21.0, 19.2, 20.3, 19.9, 20.6,
+        19.5, 20.2, 20.8, 19.7, 20.0, 19.4, 20.5, 20.1, 19.9, 20.0 };
+
+    // Round-trip times of a node behind a jittery link, between 10ms and 200ms
+    const std::vector<double> jittery_trace = {
+        15.0, 180.0, 42.0, 110.0, 12.0, 195.0, 67.0, 150.0, 25.0, 88.0,
+        170.0, 33.0, 125.0, 10.0, 200.0, 55.0, 140.0, 20.0, 98.0, 160.0 };
+}
+
+class PhiAccrualDetectorTest : public testing::Test {
+protected:
+    static void replay(PHI_ACCRUAL_DETECTOR& detector, const std::vector<double>& trace) {
+        for (const double rtt : trace) {
+            detector.add_sample(RTT(rtt));
+        }
+    }
+};
+
+TEST_F(PhiAccrualDetectorTest, NotEnoughSamples) {
+    PHI_ACCRUAL_DETECTOR detector;
+    for (size_t i = 0; i < phi_min_samples - 1; i++) {
+        detector.add_sample(RTT(20));
+    }
+
+    EXPECT_FALSE(detector.has_enough_samples());
+    EXPECT_EQ(0, detector.phi(RTT(10000)));
+
+    detector.add_sample(RTT(20));
+    EXPECT_TRUE(detector.has_enough_samples());
+}
+
+TEST_F(PhiAccrualDetectorTest, SteadyTrace) {
+    PHI_ACCRUAL_DETECTOR detector;
+    replay(detector, steady_trace);
+
+    // A probe taking as long as usual raises no suspicion
+    EXPECT_LT(detector.phi(RTT(20), interval), 1);
+    EXPECT_LT(detector.phi(RTT(120), interval), 1);
+    // Suspicion grows with the time the node takes to answer
+    EXPECT_LT(detector.phi(RTT(140), interval), detector.phi(RTT(160), interval));
+    EXPECT_GE(detector.phi(RTT(200), interval), phi_threshold);
+}
+
+TEST_F(PhiAccrualDetectorTest, JitteryTraceToleratesSlowerProbes) {
+    PHI_ACCRUAL_DETECTOR steady_detector;
+    replay(steady_detector, steady_trace);
+
+    PHI_ACCRUAL_DETECTOR jittery_detector;
+    replay(jittery_detector, jittery_trace);
+
+    // A 350ms probe is abnormal for the steady node but not for the jittery one
+    EXPECT_GE(steady_detector.phi(RTT(350), interval), phi_threshold);
+    EXPECT_LT(jittery_detector.phi(RTT(350), interval), phi_threshold);
+
+    // The jittery node still gets suspected, only later
+    EXPECT_GE(jittery_detector.phi(RTT(1100), interval), phi_threshold);
+}
+
+TEST_F(PhiAccrualDetectorTest, SlidingWindow) {
+    PHI_ACCRUAL_DETECTOR detector(jittery_trace.size());
+    replay(detector, jittery_trace);
+    EXPECT_LT(detector.phi(RTT(350), interval), phi_threshold);
+
+    // Once the link settles, the old round-trip times no longer count
+    replay(detector, steady_trace);
+    PHI_ACCRUAL_DETECTOR steady_detector;
+    replay(steady_detector, steady_trace);
+
+    EXPECT_NEAR(steady_detector.phi(RTT(150), interval), detector.phi(RTT(150), interval), 0.001);
+    EXPECT_GE(detector.phi(RTT(350), interval), phi_threshold);
+}
+
+// Verify that a node answering in about 1ms is not suspected when a single probe stalls for
+// 50ms, as long as the stall is within the detection interval.
+TEST_F(PhiAccrualDetectorTest, LatencySpikeWithinDetectionInterval) {
+    PHI_ACCRUAL_DETECTOR detector;
+    for (int i = 0; i < 20; i++) {
+        detector.add_sample(RTT(i % 2 ? 1.1 : 0.9));
+    }
+
+    // Without an acceptable pause, the stall would be deemed a failure
+    EXPECT_GE(detector.phi(RTT(50)), phi_threshold);
+    EXPECT_LT(detector.phi(RTT(50), interval), 1);
+
+    // A node that stays silent past the interval is still suspected
+    EXPECT_GE(detector.phi(RTT(300), interval), phi_threshold);
+}
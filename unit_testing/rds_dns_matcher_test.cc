@@ -0,0 +1,239 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/rds_dns_matcher.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+    // The regular expressions the matcher replaces, used as its oracle
+    const std::regex AURORA_DNS_PATTERN(
+        R"#((.+)\.(proxy-|cluster-|cluster-ro-|cluster-custom-)?([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_PROXY_DNS_PATTERN(
+        R"#((.+)\.(proxy-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-|cluster-ro-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_WRITER_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_READER_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-ro-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CUSTOM_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-custom-)+([a-zA-Z0-9]+\.[a-zA-Z0-9\-]+\.rds\.amazonaws\.com))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CHINA_DNS_PATTERN(
+        R"#((.+)\.(proxy-|cluster-|cluster-ro-|cluster-custom-)?([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CHINA_PROXY_DNS_PATTERN(
+        R"#((.+)\.(proxy-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CHINA_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-|cluster-ro-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CHINA_WRITER_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CHINA_READER_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-ro-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
+        std::regex_constants::icase);
+    const std::regex AURORA_CHINA_CUSTOM_CLUSTER_PATTERN(
+        R"#((.+)\.(cluster-custom-)+([a-zA-Z0-9]+\.(rds\.[a-zA-Z0-9\-]+|[a-zA-Z0-9\-]+\.rds)\.amazonaws\.com\.cn))#",
+        std::regex_constants::icase);
+
+    bool matches(const std::string& host, const std::regex& pattern, const std::regex& china_pattern) {
+        return std::regex_match(host, pattern) || std::regex_match(host, china_pattern);
+    }
+
+    RDS_DNS_INFO oracle(const std::string& host) {
+        RDS_DNS_INFO info;
+        info.is_rds = matches(host, AURORA_DNS_PATTERN, AURORA_CHINA_DNS_PATTERN);
+        info.is_proxy = matches(host, AURORA_PROXY_DNS_PATTERN, AURORA_CHINA_PROXY_DNS_PATTERN);
+        info.is_cluster = matches(host, AURORA_CLUSTER_PATTERN, AURORA_CHINA_CLUSTER_PATTERN);
+        info.is_writer_cluster = matches(host, AURORA_WRITER_CLUSTER_PATTERN, AURORA_CHINA_WRITER_CLUSTER_PATTERN);
+        info.is_reader_cluster = matches(host, AURORA_READER_CLUSTER_PATTERN, AURORA_CHINA_READER_CLUSTER_PATTERN);
+        info.is_custom_cluster = matches(host, AURORA_CUSTOM_CLUSTER_PATTERN, AURORA_CHINA_CUSTOM_CLUSTER_PATTERN);
+
+        // The groups are taken from the pattern the whole host matches, as a search can find
+        // a match inside a longer host, e.g. dropping the ".cn" from a China endpoint.
+        std::smatch m;
+        if (info.is_rds && (std::regex_match(host, m, AURORA_DNS_PATTERN) ||
+                            std::regex_match(host, m, AURORA_CHINA_DNS_PATTERN))) {
+            info.instance_host_pattern = "?." + m.str(3);
+        }
+        if (info.is_cluster && (std::regex_match(host, m, AURORA_CLUSTER_PATTERN) ||
+                                std::regex_match(host, m, AURORA_CHINA_CLUSTER_PATTERN))) {
+            info.cluster_host_url = m.str(1) + ".cluster-" + m.str(3);
+        }
+        return info;
+    }
+
+    void expect_same(const RDS_DNS_INFO& expected, const RDS_DNS_INFO& actual, const std::string& host) {
+        EXPECT_EQ(expected.is_rds, actual.is_rds) << host;
+        EXPECT_EQ(expected.is_proxy, actual.is_proxy) << host;
+        EXPECT_EQ(expected.is_cluster, actual.is_cluster) << host;
+        EXPECT_EQ(expected.is_writer_cluster, actual.is_writer_cluster) << host;
+        EXPECT_EQ(expected.is_reader_cluster, actual.is_reader_cluster) << host;
+        EXPECT_EQ(expected.is_custom_cluster, actual.is_custom_cluster) << host;
+        EXPECT_EQ(expected.instance_host_pattern, actual.instance_host_pattern) << host;
+        EXPECT_EQ(expected.cluster_host_url, actual.cluster_host_url) << host;
+    }
+
+    const std::vector<std::string> hosts = {
+        "database-test-name.cluster-XYZ.us-east-2.rds.amazonaws.com",
+        "database-test-name.cluster-ro-XYZ.us-east-2.rds.amazonaws.com",
+        "proxy-test-name.proxy-XYZ.us-east-2.rds.amazonaws.com",
+        "custom-test-name.cluster-custom-XYZ.us-east-2.rds.amazonaws.com",
+        "instance-1.XYZ.us-east-2.rds.amazonaws.com",
+        "database-test-name.cluster-XYZ.rds.cn-northwest-1.amazonaws.com.cn",
+        "database-test-name.cluster-ro-XYZ.rds.cn-northwest-1.amazonaws.com.cn",
+        "proxy-test-name.proxy-XYZ.rds.cn-northwest-1.amazonaws.com.cn",
+        "custom-test-name.cluster-custom-XYZ.rds.cn-northwest-1.amazonaws.com.cn",
+        "instance-1.XYZ.cn-northwest-1.rds.amazonaws.com.cn",
+        "DATABASE.CLUSTER-RO-XYZ.US-EAST-2.RDS.AMAZONAWS.COM",
+        "a.b.c.cluster-XYZ.us-east-2.rds.amazonaws.com",
+        "a.cluster-cluster-ro-XYZ.us-east-2.rds.amazonaws.com",
+        "a.proxy-proxy-XYZ.us-east-2.rds.amazonaws.com",
+        "a.cluster-custom-cluster-custom-XYZ.rds.cn-north-1.amazonaws.com.cn",
+        "a.cluster-proxy-XYZ.us-east-2.rds.amazonaws.com",
+        "a.ro-XYZ.us-east-2.rds.amazonaws.com",
+        "a.cluster-.us-east-2.rds.amazonaws.com",
+        "a.cluster-X_Z.us-east-2.rds.amazonaws.com",
+        ".cluster-XYZ.us-east-2.rds.amazonaws.com",
+        "cluster-XYZ.us-east-2.rds.amazonaws.com",
+        "a.cluster-XYZ..rds.amazonaws.com",
+        "a.cluster-XYZ.us_east.rds.amazonaws.com",
+        "a.cluster-XYZ.us-east-2.rds.amazonaws.com.",
+        "a.cluster-XYZ.rds.amazonaws.com",
+        "a.cluster-XYZ.rds.rds.amazonaws.com.cn",
+        "a.cluster-XYZ.cn-north-1.amazonaws.com.cn",
+        "a.cluster-XYZ.rds.amazonaws.com.cn",
+        "a\n.cluster-XYZ.us-east-2.rds.amazonaws.com",
+        "10.10.10.10",
+        "localhost",
+        "",
+        "rds.amazonaws.com",
+        "my.db.example.com",
+    };
+}  // namespace
+
+class RdsDnsMatcherTest : public testing::Test {
+protected:
+    void SetUp() override {
+        RDS_DNS_MATCHER::clear_cache();
+    }
+};
+
+// Verify that hosts are classified the way the regular expressions classify them.
+TEST_F(RdsDnsMatcherTest, MatchesRegexOracle) {
+    for (const auto& host : hosts) {
+        expect_same(oracle(host), RDS_DNS_MATCHER::match(host), host);
+    }
+}
+
+// Verify the matcher against the oracle on hosts put together from Aurora host name fragments.
+TEST_F(RdsDnsMatcherTest, MatchesRegexOracleOnGeneratedHosts) {
+    const std::vector<std::string> fragments = {
+        "a", "db-1", ".", "..", "-", "_", "proxy-", "cluster-", "cluster-ro-", "cluster-custom-", "CLUSTER-",
+        "ro-", "XYZ", "us-east-2", "cn-north-1", "rds", ".rds", "amazonaws", ".com", ".cn", ".amazonaws.com",
+        ".rds.amazonaws.com", ".amazonaws.com.cn"};
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<size_t> fragment(0, fragments.size() - 1);
+    std::uniform_int_distribution<int> length(1, 8);
+
+    for (int i = 0; i < 3000; i++) {
+        std::string host;
+        const int n = length(random_engine);
+        for (int j = 0; j < n; j++) {
+            host += fragments[fragment(random_engine)];
+        }
+        // Most generated hosts would not come close to matching without an Aurora suffix
+        if (i % 2 == 0) {
+            host += i % 4 == 0 ? ".us-east-2.rds.amazonaws.com" : ".rds.cn-north-1.amazonaws.com.cn";
+        }
+        expect_same(oracle(host), RDS_DNS_MATCHER::match(host), host);
+    }
+}
+
+// Verify that cached classifications are the ones matched.
+TEST_F(RdsDnsMatcherTest, CachesClassification) {
+    for (int i = 0; i < 2; i++) {
+        for (const auto& host : hosts) {
+            expect_same(RDS_DNS_MATCHER::match(host), RDS_DNS_MATCHER::classify(host), host);
+        }
+    }
+}
+
+// Compares the time it takes to classify hosts with the matcher and with the regular expressions.
+// Timings vary with the machine, so it only reports them and is run with --gtest_also_run_disabled_tests.
+TEST_F(RdsDnsMatcherTest, DISABLED_Benchmark) {
+    const int iterations = 200;
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (const auto& host : hosts) {
+            oracle(host);
+        }
+    }
+    const auto regex_time = clock::now() - start;
+
+    start = clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (const auto& host : hosts) {
+            RDS_DNS_MATCHER::match(host);
+        }
+    }
+    const auto matcher_time = clock::now() - start;
+
+    start = clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (const auto& host : hosts) {
+            RDS_DNS_MATCHER::classify(host);
+        }
+    }
+    const auto cached_time = clock::now() - start;
+
+    const auto to_us = [](clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    std::cout << "[ BENCHMARK ] " << iterations * hosts.size() << " classifications: regex " << to_us(regex_time)
+              << " us, matcher " << to_us(matcher_time) << " us, cached " << to_us(cached_time) << " us" << std::endl;
+}
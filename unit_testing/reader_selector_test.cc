@@ -0,0 +1,165 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/reader_selector.h"
+#include "driver/driver.h"
+#include "driver/topology_service.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+    std::shared_ptr<HOST_INFO> make_reader(const std::string& host, int replica_lag_ms) {
+        auto reader = std::make_shared<HOST_INFO>(host, 1234, UP, false);
+        reader->replica_lag_ms = replica_lag_ms;
+        return reader;
+    }
+
+    std::vector<std::string> get_hosts(const std::vector<std::shared_ptr<HOST_INFO>>& readers) {
+        std::vector<std::string> hosts;
+        for (const auto& reader : readers) {
+            hosts.push_back(reader->get_host());
+        }
+        return hosts;
+    }
+}
+
+class ReaderSelectorTest : public testing::Test {
+protected:
+    std::vector<std::shared_ptr<HOST_INFO>> readers;
+
+    void SetUp() override {
+        readers = {
+            make_reader("reader-50", 50),
+            make_reader("reader-10", 10),
+            make_reader("reader-unknown", HOST_INFO::NO_REPLICA_LAG),
+            make_reader("reader-30", 30) };
+    }
+};
+
+TEST_F(ReaderSelectorTest, GetStrategy) {
+    EXPECT_EQ(RANDOM_SELECTION, READER_SELECTOR::get_strategy(nullptr));
+    EXPECT_EQ(RANDOM_SELECTION, READER_SELECTOR::get_strategy("random"));
+    EXPECT_EQ(RANDOM_SELECTION, READER_SELECTOR::get_strategy("unknown strategy"));
+    EXPECT_EQ(LEAST_LAG_SELECTION, READER_SELECTOR::get_strategy("least lag"));
+    EXPECT_EQ(LAG_WEIGHTED_SELECTION, READER_SELECTOR::get_strategy("LAG WEIGHTED"));
+    EXPECT_EQ(LOWEST_LATENCY_SELECTION, READER_SELECTOR::get_strategy("Lowest Latency"));
+}
+
+TEST_F(ReaderSelectorTest, LeastLag) {
+    READER_SELECTOR selector(LEAST_LAG_SELECTION);
+    selector.order_readers(readers);
+
+    const std::vector<std::string> expected = { "reader-10", "reader-30", "reader-50", "reader-unknown" };
+    EXPECT_EQ(expected, get_hosts(readers));
+}
+
+TEST_F(ReaderSelectorTest, MaxReplicaLag) {
+    READER_SELECTOR selector(LEAST_LAG_SELECTION, 40);
+    selector.order_readers(readers);
+
+    // Readers with an unknown lag are not known to exceed the maximum
+    const std::vector<std::string> expected = { "reader-10", "reader-30", "reader-unknown", "reader-50" };
+    EXPECT_EQ(expected, get_hosts(readers));
+
+    READER_SELECTOR random_selector(RANDOM_SELECTION, 20);
+    random_selector.order_readers(readers);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(i >= 2, readers[i]->replica_lag_ms > 20);
+    }
+}
+
+TEST_F(ReaderSelectorTest, LagWeighted) {
+    READER_SELECTOR selector(LAG_WEIGHTED_SELECTION);
+    std::vector<std::shared_ptr<HOST_INFO>> weighted_readers = {
+        make_reader("reader-lagging", 99), make_reader("reader-fresh", 0) };
+
+    // The fresh reader is a hundred times more likely to be picked first
+    int fresh_first = 0;
+    for (int i = 0; i < 1000; i++) {
+        selector.order_readers(weighted_readers);
+        ASSERT_EQ(2, weighted_readers.size());
+        if (weighted_readers[0]->get_host() == "reader-fresh") {
+            fresh_first++;
+        }
+    }
+
+    EXPECT_GT(fresh_first, 950);
+    EXPECT_LT(fresh_first, 1000);
+}
+
+TEST_F(ReaderSelectorTest, LowestLatency) {
+    TOPOLOGY_SERVICE::record_connect_attempt(readers[0]->get_host_id(), true, std::chrono::milliseconds(5));
+    TOPOLOGY_SERVICE::record_connect_attempt(readers[1]->get_host_id(), true, std::chrono::milliseconds(500));
+    TOPOLOGY_SERVICE::record_connect_attempt(readers[3]->get_host_id(), true, std::chrono::milliseconds(50));
+
+    READER_SELECTOR selector(LOWEST_LATENCY_SELECTION);
+    selector.order_readers(readers);
+
+    // Readers never connected to are expected to take the average time
+    const std::vector<std::string> expected = { "reader-50", "reader-30", "reader-unknown", "reader-10" };
+    EXPECT_EQ(expected, get_hosts(readers));
+}
+
+TEST_F(ReaderSelectorTest, LowestLatency_FailingReader) {
+    std::vector<std::shared_ptr<HOST_INFO>> failing_readers = {
+        make_reader("reader-fast-failing", 0), make_reader("reader-slow", 0) };
+
+    TOPOLOGY_SERVICE::record_connect_attempt(failing_readers[0]->get_host_id(), true, std::chrono::milliseconds(5));
+    for (int i = 0; i < 3; i++) {
+        TOPOLOGY_SERVICE::record_connect_attempt(failing_readers[0]->get_host_id(), false, std::chrono::milliseconds(1000));
+    }
+    TOPOLOGY_SERVICE::record_connect_attempt(failing_readers[1]->get_host_id(), true, std::chrono::milliseconds(200));
+
+    READER_SELECTOR selector(LOWEST_LATENCY_SELECTION);
+    selector.order_readers(failing_readers);
+
+    const std::vector<std::string> expected = { "reader-slow", "reader-fast-failing" };
+    EXPECT_EQ(expected, get_hosts(failing_readers));
+}
+
+TEST_F(ReaderSelectorTest, LowestLatency_Jitter) {
+    std::vector<std::shared_ptr<HOST_INFO>> similar_readers = {
+        make_reader("reader-similar-1", 0), make_reader("reader-similar-2", 0) };
+    TOPOLOGY_SERVICE::record_connect_attempt(similar_readers[0]->get_host_id(), true, std::chrono::milliseconds(100));
+    TOPOLOGY_SERVICE::record_connect_attempt(similar_readers[1]->get_host_id(), true, std::chrono::milliseconds(105));
+
+    // Readers about as fast as each other are both picked first, spreading the load
+    READER_SELECTOR selector(LOWEST_LATENCY_SELECTION);
+    int first_picked_first = 0;
+    for (int i = 0; i < 1000; i++) {
+        selector.order_readers(similar_readers);
+        if (similar_readers[0]->get_host() == "reader-similar-1") {
+            first_picked_first++;
+        }
+    }
+
+    EXPECT_GT(first_picked_first, 400);
+    EXPECT_LT(first_picked_first, 700);
+}
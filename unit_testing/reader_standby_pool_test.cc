@@ -0,0 +1,254 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/failover.h"
+#include "driver/reader_standby_pool.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "test_utils.h"
+#include "mock_objects.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::DeleteArg;
+using ::testing::Return;
+using ::testing::ReturnNew;
+using ::testing::StrEq;
+
+namespace {
+    const std::string cluster_id("reader-standby-pool-test-cluster");
+
+    char* reader_a[4] = { "reader-a", "Replica", "2020-09-15 17:51:53.0", "13.5" };
+    char* reader_b[4] = { "reader-b", "Replica", "2020-09-15 17:51:53.0", "13.5" };
+    char* reader_c[4] = { "reader-c", "Replica", "2020-09-15 17:51:53.0", "13.5" };
+    char* writer[4] = { "writer", WRITER_SESSION_ID, "2020-09-15 17:51:53.0", "13.5" };
+}  // namespace
+
+class ReaderStandbyPoolTest : public testing::Test {
+protected:
+    SQLHENV env;
+    DBC* dbc;
+    DataSource* ds;
+    std::shared_ptr<TOPOLOGY_SERVICE> ts;
+
+    std::mutex proxies_mutex;
+    std::vector<MOCK_CONNECTION_PROXY*> proxies;
+    std::vector<std::shared_ptr<HOST_INFO>> connected_hosts;
+
+    void SetUp() override {
+        allocate_odbc_handles(env, dbc, ds);
+
+        ts = std::make_shared<TOPOLOGY_SERVICE>(0);
+        ts->set_cluster_instance_template(std::make_shared<HOST_INFO>("?.XYZ.us-east-2.rds.amazonaws.com", 1234));
+        ts->set_cluster_id(cluster_id);
+
+        // Caches the topology the pool picks readers from
+        auto mock_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+        EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL))).WillOnce(Return(0));
+        EXPECT_CALL(*mock_proxy, store_result()).WillRepeatedly(ReturnNew<MYSQL_RES>());
+        EXPECT_CALL(*mock_proxy, free_result(_)).WillRepeatedly(DeleteArg<0>());
+        EXPECT_CALL(*mock_proxy, fetch_row(_))
+            .WillOnce(Return(reader_a))
+            .WillOnce(Return(reader_b))
+            .WillOnce(Return(reader_c))
+            .WillOnce(Return(writer))
+            .WillOnce(Return(MYSQL_ROW{}));
+        ASSERT_NE(nullptr, ts->get_topology(mock_proxy));
+        delete mock_proxy;
+    }
+
+    void TearDown() override {
+        ts->clear_all();
+        cleanup_odbc_handles(env, dbc, ds);
+    }
+
+    // Opens standby connections whose pings return the given results, then 0
+    STANDBY_CONNECTION_FACTORY proxy_factory(std::vector<int> ping_results = {}) {
+        return [this, ping_results](std::shared_ptr<HOST_INFO> host) -> CONNECTION_PROXY* {
+            auto proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+            std::unique_lock<std::mutex> lock(proxies_mutex);
+            const size_t index = proxies.size();
+            EXPECT_CALL(*proxy, ping()).WillRepeatedly(
+                Return(index < ping_results.size() ? ping_results[index] : 0));
+            EXPECT_CALL(*proxy, close()).Times(AnyNumber());
+            proxies.push_back(proxy);
+            connected_hosts.push_back(host);
+            return proxy;
+        };
+    }
+
+    static void wait_for_size(READER_STANDBY_POOL& pool, size_t size) {
+        for (int i = 0; i < 30 && pool.size() < size; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    static std::shared_ptr<HOST_INFO> get_host(const std::string& instance_name) {
+        auto host = std::make_shared<HOST_INFO>(instance_name + ".XYZ.us-east-2.rds.amazonaws.com", 1234);
+        host->instance_name = instance_name;
+        return host;
+    }
+};
+
+// Verify that the pool connects to different readers, and never to the writer.
+TEST_F(ReaderStandbyPoolTest, KeepsConnectionsToReaders) {
+    READER_STANDBY_POOL pool(ts, 0);
+    pool.attach(this, proxy_factory(), 2);
+
+    wait_for_size(pool, 2);
+    EXPECT_EQ(2, pool.size());
+
+    pool.stop();
+    EXPECT_EQ(0, pool.size());
+
+    std::unique_lock<std::mutex> lock(proxies_mutex);
+    ASSERT_EQ(2, connected_hosts.size());
+    for (const auto& host : connected_hosts) {
+        EXPECT_FALSE(host->is_host_writer());
+    }
+    EXPECT_FALSE(HOST_INFO::is_host_same(connected_hosts[0], connected_hosts[1]));
+}
+
+// Verify that a standby connection that fails its ping is closed instead of handed over,
+// and that the pool replaces it.
+TEST_F(ReaderStandbyPoolTest, TakeReplacesLostConnection) {
+    READER_STANDBY_POOL pool(ts, 0);
+    pool.attach(this, proxy_factory({ 1 }), 1);
+    wait_for_size(pool, 1);
+
+    STANDBY_CONNECTION standby;
+    for (int i = 0; i < 30 && !standby.connection; i++) {
+        standby = pool.take(nullptr, dbc);
+        if (!standby.connection) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(proxies_mutex);
+        ASSERT_LE(2, proxies.size());
+        EXPECT_NE(proxies[0], standby.connection);
+        EXPECT_EQ(proxies[1], standby.connection);
+    }
+    ASSERT_NE(nullptr, standby.host);
+    EXPECT_NE("writer", standby.host->instance_name);
+
+    pool.stop();
+    delete standby.connection;
+}
+
+// Verify that no standby connection to the host the taker is on is handed over.
+TEST_F(ReaderStandbyPoolTest, TakeSkipsExcludedHost) {
+    READER_STANDBY_POOL pool(ts, 0);
+    pool.attach(this, proxy_factory(), 1);
+    wait_for_size(pool, 1);
+    ASSERT_EQ(1, pool.size());
+
+    std::shared_ptr<HOST_INFO> pooled_host;
+    {
+        std::unique_lock<std::mutex> lock(proxies_mutex);
+        pooled_host = connected_hosts[0];
+    }
+    EXPECT_EQ(nullptr, pool.take(pooled_host, dbc).connection);
+    EXPECT_EQ(1, pool.size());
+
+    const auto standby = pool.take(get_host("writer"), dbc);
+    ASSERT_NE(nullptr, standby.connection);
+    EXPECT_TRUE(HOST_INFO::is_host_same(pooled_host, standby.host));
+
+    pool.stop();
+    delete standby.connection;
+}
+
+// Verify that the connections to a cluster with the same options share one pool, and that
+// detaching an owner closes the standby connections its factory opened while the others replace them.
+TEST_F(ReaderStandbyPoolTest, SharedByConnectionsToCluster) {
+    const int owner_a = 0;
+    const int owner_b = 0;
+
+    auto pool = READER_STANDBY_POOL::get_instance(*ts, "UID=user-a", 0);
+    EXPECT_EQ(pool, READER_STANDBY_POOL::get_instance(*ts, "UID=user-a", 0));
+    // Standby connections are never handed over to connections with other credentials
+    EXPECT_NE(pool, READER_STANDBY_POOL::get_instance(*ts, "UID=user-b", 0));
+
+    pool->attach(&owner_a, proxy_factory(), 2);
+    wait_for_size(*pool, 2);
+    ASSERT_EQ(2, pool->size());
+
+    pool->attach(&owner_b, proxy_factory(), 1);
+    pool->detach(&owner_a);
+
+    size_t connections = 0;
+    for (int i = 0; i < 30 && connections < 3; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::unique_lock<std::mutex> lock(proxies_mutex);
+        connections = proxies.size();
+    }
+    EXPECT_EQ(3, connections);
+    EXPECT_EQ(1, pool->size());
+
+    pool->detach(&owner_b);
+    EXPECT_EQ(0, pool->size());
+    pool.reset();
+}
+
+// Verify that reader failover hands over a standby connection without connecting to any host.
+TEST_F(ReaderStandbyPoolTest, ReaderFailoverTakesStandbyConnection) {
+    auto pool = std::make_shared<READER_STANDBY_POOL>(ts, 0);
+    pool->attach(this, proxy_factory(), 1);
+    wait_for_size(*pool, 1);
+    ASSERT_EQ(1, pool->size());
+
+    auto mock_ts = std::make_shared<MOCK_TOPOLOGY_SERVICE>();
+    auto mock_connection_handler = std::make_shared<MOCK_CONNECTION_HANDLER>();
+    EXPECT_CALL(*mock_connection_handler, connect_impl(_, _, _)).Times(0);
+    EXPECT_CALL(*mock_ts, mark_host_up(_)).Times(1);
+
+    FAILOVER_EXECUTOR failover_executor{4, 16};
+    FAILOVER_READER_HANDLER reader_handler(mock_ts, mock_connection_handler, failover_executor, 60000, 30000, false, 0);
+    reader_handler.set_standby_pool(pool, dbc);
+    auto result = reader_handler.failover(ts->get_cached_topology());
+
+    EXPECT_TRUE(result->connected);
+    {
+        std::unique_lock<std::mutex> lock(proxies_mutex);
+        EXPECT_EQ(proxies[0], result->new_connection);
+    }
+    EXPECT_FALSE(result->new_host->is_host_writer());
+
+    pool->stop();
+    delete result->new_connection;
+}
@@ -0,0 +1,98 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/server_info_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+    const std::string instance_host = "database-test-name-1.XYZ.us-east-2.rds.amazonaws.com";
+    const std::string server_version = "8.0.32";
+}  // namespace
+
+class ServerInfoCacheTest : public testing::Test {
+protected:
+    SERVER_INFO_CACHE cache{std::chrono::minutes(10)};
+    SERVER_INFO info;
+
+    void SetUp() override {
+        info.server_version = server_version;
+        info.node_keys = { "ip-10-0-0-1:3306" };
+    }
+};
+
+TEST_F(ServerInfoCacheTest, CachesInstanceEndpoints) {
+    SERVER_INFO cached;
+    EXPECT_FALSE(cache.get(instance_host, 3306, server_version, cached));
+
+    cache.put(instance_host, 3306, info);
+    ASSERT_TRUE(cache.get(instance_host, 3306, server_version, cached));
+    EXPECT_EQ(info.node_keys, cached.node_keys);
+
+    // Another port is another instance
+    EXPECT_FALSE(cache.get(instance_host, 3307, server_version, cached));
+}
+
+TEST_F(ServerInfoCacheTest, DoesNotCacheEndpointsOfChangingInstances) {
+    EXPECT_TRUE(SERVER_INFO_CACHE::is_cacheable(instance_host));
+    EXPECT_FALSE(SERVER_INFO_CACHE::is_cacheable("database-test-name.cluster-XYZ.us-east-2.rds.amazonaws.com"));
+    EXPECT_FALSE(SERVER_INFO_CACHE::is_cacheable("database-test-name.cluster-ro-XYZ.us-east-2.rds.amazonaws.com"));
+    EXPECT_FALSE(SERVER_INFO_CACHE::is_cacheable("database-test-name.cluster-custom-XYZ.us-east-2.rds.amazonaws.com"));
+    EXPECT_FALSE(SERVER_INFO_CACHE::is_cacheable("proxy-test-name.proxy-XYZ.us-east-2.rds.amazonaws.com"));
+    EXPECT_FALSE(SERVER_INFO_CACHE::is_cacheable("mysql.example.com"));
+
+    cache.put("database-test-name.cluster-XYZ.us-east-2.rds.amazonaws.com", 3306, info);
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST_F(ServerInfoCacheTest, DropsEntryOfAnotherServer) {
+    SERVER_INFO cached;
+    cache.put(instance_host, 3306, info);
+
+    // The instance was replaced or upgraded
+    EXPECT_FALSE(cache.get(instance_host, 3306, "8.0.36", cached));
+    EXPECT_FALSE(cache.get(instance_host, 3306, server_version, cached));
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST_F(ServerInfoCacheTest, InvalidatesEntries) {
+    SERVER_INFO cached;
+    cache.put(instance_host, 3306, info);
+    cache.invalidate(instance_host, 3306);
+    EXPECT_FALSE(cache.get(instance_host, 3306, server_version, cached));
+
+    SERVER_INFO_CACHE short_lived_cache(std::chrono::milliseconds(20));
+    short_lived_cache.put(instance_host, 3306, info);
+    EXPECT_TRUE(short_lived_cache.get(instance_host, 3306, server_version, cached));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(short_lived_cache.get(instance_host, 3306, server_version, cached));
+}
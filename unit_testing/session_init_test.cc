@@ -0,0 +1,134 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/driver.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "test_utils.h"
+#include "mock_objects.h"
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::StrEq;
+
+namespace {
+    char server_version[] = "8.0.32";
+    char legacy_server_version[] = "5.7.12";
+}  // namespace
+
+class SessionInitTest : public testing::Test {
+protected:
+    SQLHENV env;
+    DBC* dbc;
+    DataSource* ds;
+    MOCK_CONNECTION_PROXY* mock_proxy;
+
+    void SetUp() override {
+        allocate_odbc_handles(env, dbc, ds);
+        dbc->unicode = true;
+        dbc->commit_flag = CHECK_AUTOCOMMIT_OFF;
+        dbc->txn_isolation = SQL_TXN_READ_COMMITTED;
+
+        mock_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+        delete dbc->connection_proxy;
+        dbc->connection_proxy = mock_proxy;
+
+        EXPECT_CALL(*mock_proxy, is_connected()).WillRepeatedly(Return(true));
+        EXPECT_CALL(*mock_proxy, get_server_version()).WillRepeatedly(Return(server_version));
+        EXPECT_CALL(*mock_proxy, get_server_capabilities()).WillRepeatedly(Return(CLIENT_TRANSACTIONS));
+        EXPECT_CALL(*mock_proxy, get_server_status()).WillRepeatedly(Return(SERVER_STATUS_AUTOCOMMIT));
+        EXPECT_CALL(*mock_proxy, get_character_set_info(_)).WillRepeatedly(Invoke([](MY_CHARSET_INFO* charset) {
+            charset->number = 45; // utf8mb4_general_ci
+        }));
+        EXPECT_CALL(*mock_proxy, ping()).Times(0);
+    }
+
+    void TearDown() override {
+        cleanup_odbc_handles(env, dbc, ds);
+    }
+};
+
+// Connecting used to take a round trip per setting: SET NAMES, SET character_set_results,
+// SET SQL_AUTO_IS_NULL, autocommit and SET SESSION TRANSACTION ISOLATION LEVEL.
+TEST_F(SessionInitTest, InitializesSessionInOneRoundTrip) {
+    EXPECT_CALL(*mock_proxy, real_query(StrEq(
+        "SET NAMES utf8mb4, character_set_results = NULL, SQL_AUTO_IS_NULL = 0, "
+        "autocommit = 0, transaction_isolation = 'READ-COMMITTED'"), _)).WillOnce(Return(0));
+
+    EXPECT_EQ(SQL_SUCCESS, dbc->init_session(ds));
+    EXPECT_NE(nullptr, dbc->cxn_charset_info);
+}
+
+TEST_F(SessionInitTest, SkipsSettingsTheSessionAlreadyHas) {
+    ds->opt_AUTO_IS_NULL = true;
+    dbc->commit_flag = CHECK_AUTOCOMMIT_ON;
+    dbc->txn_isolation = DEFAULT_TXN_ISOLATION;
+
+    EXPECT_CALL(*mock_proxy, real_query(StrEq(
+        "SET NAMES utf8mb4, character_set_results = NULL"), _)).WillOnce(Return(0));
+
+    EXPECT_EQ(SQL_SUCCESS, dbc->init_session(ds));
+}
+
+TEST_F(SessionInitTest, UsesLegacyIsolationVariable) {
+    EXPECT_CALL(*mock_proxy, get_server_version()).WillRepeatedly(Return(legacy_server_version));
+    EXPECT_CALL(*mock_proxy, real_query(StrEq(
+        "SET NAMES utf8mb4, character_set_results = NULL, SQL_AUTO_IS_NULL = 0, "
+        "autocommit = 0, tx_isolation = 'READ-COMMITTED'"), _)).WillOnce(Return(0));
+
+    EXPECT_EQ(SQL_SUCCESS, dbc->init_session(ds));
+}
+
+// The settings INITSTMT could override are made after it
+TEST_F(SessionInitTest, RunsInitStatementBetweenSettings) {
+    ds->opt_INITSTMT = std::string("SET @a = 1");
+
+    InSequence sequence;
+    EXPECT_CALL(*mock_proxy, real_query(StrEq("SET NAMES utf8mb4, character_set_results = NULL"), _))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, real_query(StrEq("SET @a = 1"), _)).WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, real_query(StrEq(
+        "SET SQL_AUTO_IS_NULL = 0, autocommit = 0, transaction_isolation = 'READ-COMMITTED'"), _))
+        .WillOnce(Return(0));
+
+    EXPECT_EQ(SQL_SUCCESS, dbc->init_session(ds));
+}
+
+TEST_F(SessionInitTest, ReportsFailedSettings) {
+    EXPECT_CALL(*mock_proxy, real_query(_, _)).WillOnce(Return(1));
+    EXPECT_CALL(*mock_proxy, error_code()).WillRepeatedly(Return(1193));
+    EXPECT_CALL(*mock_proxy, error()).WillRepeatedly(Return("Unknown system variable"));
+
+    EXPECT_EQ(SQL_ERROR, dbc->init_session(ds));
+}
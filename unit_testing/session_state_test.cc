@@ -0,0 +1,151 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/driver.h"
+#include "driver/session_state.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "test_utils.h"
+#include "mock_objects.h"
+
+using ::testing::_;
+using ::testing::Return;
+using ::testing::StrEq;
+
+namespace {
+    char server_version[] = "8.0.32";
+}  // namespace
+
+class SessionStateTest : public testing::Test {
+protected:
+    SESSION_STATE session_state;
+};
+
+TEST_F(SessionStateTest, TracksSessionAndUserVariables) {
+    session_state.track_statement("SELECT 1");
+    EXPECT_TRUE(session_state.empty());
+
+    session_state.track_statement("SET @a = 5, @@session.sql_mode = 'ANSI', net_read_timeout = 30");
+    session_state.track_statement("set @b := 'x''y'");
+
+    EXPECT_EQ("SET @a = 5, @@SESSION.sql_mode = 'ANSI', @@SESSION.net_read_timeout = 30, @b = 'x''y'",
+              session_state.build_restore_query({}, false));
+}
+
+TEST_F(SessionStateTest, IgnoresGlobalVariables) {
+    // The scope applies to the following assignments without one
+    session_state.track_statement("SET GLOBAL max_connections = 10, wait_timeout = 20, SESSION net_read_timeout = 30");
+    session_state.track_statement("SET @@GLOBAL.max_allowed_packet = 1024, @a = 1");
+
+    EXPECT_EQ("SET @@SESSION.net_read_timeout = 30, @a = 1", session_state.build_restore_query({}, false));
+}
+
+TEST_F(SessionStateTest, KeepsLatestAssignment) {
+    session_state.track_statement("SET @a = 5, sql_mode = 'ANSI'");
+    session_state.track_statement("SET @a = 6");
+    // Back to the values a new session starts with
+    session_state.track_statement("SET sql_mode = DEFAULT");
+    // A value that cannot be reproduced on another server
+    session_state.track_statement("SET @b = 1");
+    session_state.track_statement("SET @b = (SELECT COUNT(*) FROM t)");
+
+    EXPECT_EQ("SET @a = 6", session_state.build_restore_query({}, false));
+
+    session_state.clear();
+    EXPECT_TRUE(session_state.empty());
+    EXPECT_EQ("", session_state.build_restore_query({}, false));
+}
+
+TEST_F(SessionStateTest, TracksTransactionCharacteristics) {
+    // Only applies to the next transaction
+    session_state.track_statement("SET TRANSACTION ISOLATION LEVEL SERIALIZABLE");
+    EXPECT_TRUE(session_state.empty());
+
+    session_state.track_statement("SET SESSION TRANSACTION ISOLATION LEVEL READ COMMITTED, READ ONLY");
+    EXPECT_EQ("SET @@SESSION.transaction_isolation = 'READ-COMMITTED', @@SESSION.transaction_read_only = 1",
+              session_state.build_restore_query({}, false));
+    EXPECT_EQ("SET @@SESSION.tx_isolation = 'READ-COMMITTED', @@SESSION.tx_read_only = 1",
+              session_state.build_restore_query({}, true));
+
+    // Both names of the variable are the same variable
+    session_state.track_statement("SET tx_isolation = 'SERIALIZABLE'");
+    EXPECT_EQ("SET @@SESSION.transaction_read_only = 1, @@SESSION.transaction_isolation = 'SERIALIZABLE'",
+              session_state.build_restore_query({}, false));
+}
+
+TEST_F(SessionStateTest, GetUsedDatabase) {
+    std::string database;
+    EXPECT_TRUE(SESSION_STATE::get_used_database("use `my db`", database));
+    EXPECT_EQ("my db", database);
+    EXPECT_TRUE(SESSION_STATE::get_used_database("USE test", database));
+    EXPECT_EQ("test", database);
+    EXPECT_FALSE(SESSION_STATE::get_used_database("SELECT 1", database));
+}
+
+// Verify that the state of the replaced session is restored with a single statement.
+TEST_F(SessionStateTest, Restore) {
+    SQLHENV env;
+    DBC* dbc;
+    DataSource* ds;
+    allocate_odbc_handles(env, dbc, ds);
+    dbc->ds = ds;
+
+    auto mock_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+    delete dbc->connection_proxy;
+    dbc->connection_proxy = mock_proxy;
+
+    dbc->txn_isolation = SQL_TXN_READ_COMMITTED;
+    dbc->sql_select_limit = 10;
+    dbc->session_state.track_statement("SET @a = 5");
+
+    EXPECT_CALL(*mock_proxy, get_server_version()).WillRepeatedly(Return(server_version));
+    EXPECT_CALL(*mock_proxy, get_server_capabilities()).WillRepeatedly(Return(CLIENT_TRANSACTIONS));
+    EXPECT_CALL(*mock_proxy, select_db(_)).Times(0);
+    EXPECT_CALL(*mock_proxy, real_query(StrEq(
+        "SET @@SESSION.autocommit = 0, @@SESSION.transaction_isolation = 'READ-COMMITTED', "
+        "@@SESSION.sql_select_limit = 10, @a = 5"), _)).WillOnce(Return(0));
+
+    EXPECT_TRUE(dbc->session_state.restore(dbc, false));
+
+    // A database selected after connecting is selected again
+    dbc->database = "other";
+    EXPECT_CALL(*mock_proxy, select_db(StrEq("other"))).WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, real_query(StrEq(
+        "SET @@SESSION.transaction_isolation = 'READ-COMMITTED', @@SESSION.sql_select_limit = 10, @a = 5"), _))
+        .WillOnce(Return(1));
+    EXPECT_CALL(*mock_proxy, error()).WillRepeatedly(Return("error"));
+
+    EXPECT_FALSE(dbc->session_state.restore(dbc, true));
+
+    dbc->ds = nullptr;
+    cleanup_odbc_handles(env, dbc, ds);
+}
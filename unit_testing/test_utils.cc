@@ -68,6 +68,10 @@ CONNECTION_STATUS TEST_UTILS::check_connection_status(std::shared_ptr<MONITOR> m
     return monitor->check_connection_status();
 }
 
+bool TEST_UTILS::poll_connection_status(std::shared_ptr<MONITOR> monitor, CONNECTION_STATUS& status) {
+    return monitor->poll_connection_status(status);
+}
+
 void TEST_UTILS::populate_monitor_map(std::shared_ptr<MONITOR_THREAD_CONTAINER> container,
     std::set<std::string> node_keys, std::shared_ptr<MONITOR> monitor) {
 
@@ -77,11 +81,12 @@ void TEST_UTILS::populate_monitor_map(std::shared_ptr<MONITOR_THREAD_CONTAINER>
 void TEST_UTILS::populate_task_map(std::shared_ptr<MONITOR_THREAD_CONTAINER> container,
     std::shared_ptr<MONITOR> monitor) {
 
-    container->task_map[monitor] = std::async(std::launch::async, []() {});
+    // Marked as running so the container's scheduler leaves the monitor alone
+    container->task_map[monitor].running = true;
 }
 
 bool TEST_UTILS::has_monitor(std::shared_ptr<MONITOR_THREAD_CONTAINER> container, std::string node_key) {
-    return container->monitor_map.count(node_key) > 0;
+    return container->get_monitor(node_key) != nullptr;
 }
 
 bool TEST_UTILS::has_task(std::shared_ptr<MONITOR_THREAD_CONTAINER> container, std::shared_ptr<MONITOR> monitor) {
@@ -104,7 +109,34 @@ bool TEST_UTILS::has_any_tasks(std::shared_ptr<MONITOR_THREAD_CONTAINER> contain
 }
 
 size_t TEST_UTILS::get_map_size(std::shared_ptr<MONITOR_THREAD_CONTAINER> container) {
-    return container->monitor_map.size();
+    size_t size = 0;
+    for (auto& shard : container->monitor_map) {
+        size += std::atomic_load(&shard.monitors)->size();
+    }
+    return size;
+}
+
+size_t TEST_UTILS::get_woken_task_count(std::shared_ptr<MONITOR_THREAD_CONTAINER> container) {
+    size_t count = 0;
+    for (WOKEN_TASK* woken = container->woken_tasks.load(); woken; woken = woken->next) {
+        count++;
+    }
+    return count;
+}
+
+DBC* TEST_UTILS::get_dbc(CONNECTION_PROXY* connection_proxy) {
+    return connection_proxy->dbc;
+}
+
+void TEST_UTILS::expire_cached_topology(TOPOLOGY_SERVICE* topology_service) {
+    topology_service->update_cached_topology([](CLUSTER_TOPOLOGY_INFO& topology) {
+        topology.last_updated = 0;
+    });
+}
+
+size_t TEST_UTILS::get_refresh_mutex_count() {
+    std::unique_lock<std::mutex> lock(TOPOLOGY_SERVICE::topology_cache_mutex);
+    return TOPOLOGY_SERVICE::topology_refresh_mutexes.size();
 }
 
 std::list<std::shared_ptr<MONITOR_CONNECTION_CONTEXT>> TEST_UTILS::get_contexts(std::shared_ptr<MONITOR> monitor) {
@@ -123,6 +155,10 @@ void TEST_UTILS::clear_token_cache(IAM_PROXY &iam_proxy) {
     iam_proxy.clear_token_cache();
 }
 
+bool TEST_UTILS::has_rds_client(AUTH_UTIL &auth_util) {
+    return auth_util.rds_client != nullptr;
+}
+
 std::map<std::pair<Aws::String, Aws::String>, Aws::Utils::Json::JsonValue>& TEST_UTILS::get_secrets_cache() {
     return std::ref(SECRETS_MANAGER_PROXY::secrets_cache);
 }
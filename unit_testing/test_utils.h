@@ -45,6 +45,7 @@ class TEST_UTILS {
 public:
     static std::chrono::milliseconds get_connection_check_interval(std::shared_ptr<MONITOR> monitor);
     static CONNECTION_STATUS check_connection_status(std::shared_ptr<MONITOR> monitor);
+    static bool poll_connection_status(std::shared_ptr<MONITOR> monitor, CONNECTION_STATUS& status);
     static void populate_monitor_map(std::shared_ptr<MONITOR_THREAD_CONTAINER> container,
         std::set<std::string> node_keys, std::shared_ptr<MONITOR> monitor);
     static void populate_task_map(std::shared_ptr<MONITOR_THREAD_CONTAINER> container,
@@ -55,10 +56,15 @@ public:
     static bool has_available_monitor(std::shared_ptr<MONITOR_THREAD_CONTAINER> container);
     static std::shared_ptr<MONITOR> get_available_monitor(std::shared_ptr<MONITOR_THREAD_CONTAINER> container);
     static size_t get_map_size(std::shared_ptr<MONITOR_THREAD_CONTAINER> container);
+    static size_t get_woken_task_count(std::shared_ptr<MONITOR_THREAD_CONTAINER> container);
+    static DBC* get_dbc(CONNECTION_PROXY* connection_proxy);
+    static void expire_cached_topology(TOPOLOGY_SERVICE* topology_service);
+    static size_t get_refresh_mutex_count();
     static std::list<std::shared_ptr<MONITOR_CONNECTION_CONTEXT>> get_contexts(std::shared_ptr<MONITOR> monitor);
     static std::string build_cache_key(const char* host, const char* region, unsigned int port, const char* user);
     static bool token_cache_contains_key(std::string cache_key);
     static void clear_token_cache(IAM_PROXY &iam_proxy);
+    static bool has_rds_client(AUTH_UTIL &auth_util);
     static std::map<std::pair<Aws::String, Aws::String>, Aws::Utils::Json::JsonValue>& get_secrets_cache();
     static bool try_parse_region_from_secret(std::string secret, std::string& region);
     static bool is_dns_pattern_valid(std::string host);
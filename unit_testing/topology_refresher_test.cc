@@ -0,0 +1,237 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/topology_refresher.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <thread>
+
+#include "test_utils.h"
+#include "mock_objects.h"
+
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::DeleteArg;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::ReturnNew;
+using ::testing::StrEq;
+
+namespace {
+    const std::string cluster_id("topology-refresher-test-cluster");
+
+    char* reader[4] = { "replica-instance", "Replica", "2020-09-15 17:51:53.0", "13.5" };
+    char* writer[4] = { "writer-instance", WRITER_SESSION_ID, "2020-09-15 17:51:53.0", "13.5" };
+}  // namespace
+
+class TopologyRefresherTest : public testing::Test {
+protected:
+    SQLHENV env;
+    DBC* dbc;
+    DataSource* ds;
+    MOCK_CONNECTION_PROXY* mock_proxy;
+    std::shared_ptr<TOPOLOGY_SERVICE> ts;
+
+    void SetUp() override {
+        allocate_odbc_handles(env, dbc, ds);
+
+        mock_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+        EXPECT_CALL(*mock_proxy, store_result()).WillRepeatedly(ReturnNew<MYSQL_RES>());
+        EXPECT_CALL(*mock_proxy, free_result(_)).WillRepeatedly(DeleteArg<0>());
+
+        ts = std::make_shared<TOPOLOGY_SERVICE>(0);
+        ts->set_cluster_instance_template(std::make_shared<HOST_INFO>("?.XYZ.us-east-2.rds.amazonaws.com", 1234));
+        ts->set_cluster_id(cluster_id);
+        ts->set_refresh_rate(1000);
+    }
+
+    void TearDown() override {
+        ts->clear_all();
+        delete mock_proxy;
+
+        cleanup_odbc_handles(env, dbc, ds);
+    }
+};
+
+TEST_F(TopologyRefresherTest, RefreshesCachedTopology) {
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL))).WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillOnce(Return(reader))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(MYSQL_ROW{}));
+
+    const auto cached_topology = ts->get_topology(mock_proxy);
+    ASSERT_NE(nullptr, cached_topology);
+
+    // Owned and deleted by the refresher
+    auto refresher_proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+    EXPECT_CALL(*refresher_proxy, is_connected()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*refresher_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL))).Times(AtLeast(1)).WillRepeatedly(Return(0));
+    EXPECT_CALL(*refresher_proxy, store_result()).WillRepeatedly(ReturnNew<MYSQL_RES>());
+    EXPECT_CALL(*refresher_proxy, free_result(_)).WillRepeatedly(DeleteArg<0>());
+    EXPECT_CALL(*refresher_proxy, fetch_row(_))
+        .WillRepeatedly(Return(MYSQL_ROW{}));
+    EXPECT_CALL(*refresher_proxy, close()).Times(1);
+    EXPECT_CALL(*refresher_proxy, mock_connection_proxy_destructor()).Times(1);
+
+    std::atomic_int connect_count{0};
+    auto refresher = TOPOLOGY_REFRESHER::get_instance(*ts);
+    EXPECT_EQ(refresher, TOPOLOGY_REFRESHER::get_instance(*ts));
+    refresher->attach(this, [&connect_count, refresher_proxy]() {
+        connect_count++;
+        return refresher_proxy;
+    }, *ts);
+
+    // The cached topology expires within two seconds, so it is refreshed right away
+    for (int i = 0; i < 30 && ts->get_cached_topology() == cached_topology; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_NE(cached_topology, ts->get_cached_topology());
+
+    refresher->detach(this);
+    refresher.reset();
+
+    EXPECT_EQ(1, connect_count);
+}
+
+TEST_F(TopologyRefresherTest, WaitsForCachedTopology) {
+    std::atomic_int connect_count{0};
+    auto refresher = TOPOLOGY_REFRESHER::get_instance(*ts);
+    refresher->attach(this, [&connect_count]() -> CONNECTION_PROXY* {
+        connect_count++;
+        return nullptr;
+    }, *ts);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    refresher->detach(this);
+    refresher.reset();
+
+    EXPECT_EQ(0, connect_count);
+}
+
+// Verify that detaching the owner whose factory opened the connection closes it right away,
+// and that the refresher reconnects through the factory of another owner.
+TEST_F(TopologyRefresherTest, DetachClosesConnectionOfOwner) {
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL))).WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillOnce(Return(reader))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(MYSQL_ROW{}));
+    ASSERT_NE(nullptr, ts->get_topology(mock_proxy));
+
+    std::atomic_bool first_closed{false};
+    std::atomic_int second_connect_count{0};
+    auto new_refresher_proxy = [this](std::atomic_bool* closed) {
+        // Owned and deleted by the refresher
+        auto proxy = new MOCK_CONNECTION_PROXY(dbc, ds);
+        EXPECT_CALL(*proxy, is_connected()).WillRepeatedly(Return(true));
+        EXPECT_CALL(*proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL))).WillRepeatedly(Return(0));
+        EXPECT_CALL(*proxy, store_result()).WillRepeatedly(ReturnNew<MYSQL_RES>());
+        EXPECT_CALL(*proxy, free_result(_)).WillRepeatedly(DeleteArg<0>());
+        EXPECT_CALL(*proxy, fetch_row(_)).WillRepeatedly(Return(MYSQL_ROW{}));
+        EXPECT_CALL(*proxy, close()).WillOnce(Invoke([closed]() {
+            if (closed) {
+                *closed = true;
+            }
+        }));
+        EXPECT_CALL(*proxy, mock_connection_proxy_destructor()).Times(1);
+        return proxy;
+    };
+
+    const int first_owner = 0;
+    const int second_owner = 0;
+    auto refresher = TOPOLOGY_REFRESHER::get_instance(*ts);
+    std::atomic_int first_connect_count{0};
+    refresher->attach(&first_owner, [&]() -> CONNECTION_PROXY* {
+        return first_connect_count++ == 0 ? new_refresher_proxy(&first_closed) : nullptr;
+    }, *ts);
+
+    for (int i = 0; i < 30 && first_connect_count == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ASSERT_EQ(1, first_connect_count);
+
+    refresher->attach(&second_owner, [&]() -> CONNECTION_PROXY* {
+        second_connect_count++;
+        return new_refresher_proxy(nullptr);
+    }, *ts);
+    refresher->detach(&first_owner);
+    EXPECT_TRUE(first_closed);
+
+    for (int i = 0; i < 30 && second_connect_count == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(1, second_connect_count);
+
+    refresher->detach(&second_owner);
+    refresher.reset();
+}
+
+// Verify that the refresher refreshes as often as the attached connection with the lowest refresh rate.
+TEST_F(TopologyRefresherTest, UsesLowestRefreshRate) {
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL))).WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillOnce(Return(reader))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(MYSQL_ROW{}));
+    ASSERT_NE(nullptr, ts->get_topology(mock_proxy));
+
+    TOPOLOGY_SERVICE slow_ts(*ts);
+    slow_ts.set_refresh_rate(60000);
+
+    std::atomic_int connect_count{0};
+    const auto factory = [&connect_count]() -> CONNECTION_PROXY* {
+        connect_count++;
+        return nullptr;
+    };
+    const int slow_owner = 0;
+    const int fast_owner = 0;
+    auto refresher = TOPOLOGY_REFRESHER::get_instance(slow_ts);
+    refresher->attach(&slow_owner, factory, slow_ts);
+
+    // The cached topology is current for another minute at the slow refresh rate
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    EXPECT_EQ(0, connect_count);
+
+    // It expires within two seconds at the fast refresh rate
+    refresher->attach(&fast_owner, factory, *ts);
+    for (int i = 0; i < 30 && connect_count == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_LE(1, connect_count);
+
+    refresher->detach(&fast_owner);
+    refresher->detach(&slow_owner);
+    refresher.reset();
+}
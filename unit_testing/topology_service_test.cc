@@ -29,7 +29,9 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <cstdio>
 #include <thread>
+#include <vector>
 
 #include "test_utils.h"
 #include "mock_objects.h"
@@ -79,6 +81,8 @@ protected:
         EXPECT_CALL(*mock_proxy, store_result()).WillRepeatedly(ReturnNew<MYSQL_RES>());
         EXPECT_CALL(*mock_proxy, free_result(_)).WillRepeatedly(DeleteArg<0>());
         ts->set_refresh_rate(DEFAULT_REFRESH_RATE_IN_MILLISECONDS);
+        ts->set_background_refresh(false);
+        ts->set_topology_snapshot("", 0);
     }
 
     void TearDown() override {
@@ -111,8 +115,8 @@ TEST_F(TopologyServiceTest, TopologyQuery) {
     EXPECT_EQ(1234, writer_host->get_port());
     EXPECT_EQ("writer-instance", writer_host->instance_name);
     EXPECT_EQ(WRITER_SESSION_ID, writer_host->session_id);
-    EXPECT_EQ("2020-09-15 17:51:53.0", writer_host->last_updated);
-    EXPECT_EQ("13.5", writer_host->replica_lag);
+    EXPECT_EQ(std::chrono::system_clock::from_time_t(1600192313), writer_host->last_updated);
+    EXPECT_EQ(14, writer_host->replica_lag_ms);
 }
 
 TEST_F(TopologyServiceTest, StaleRecord) {
@@ -137,8 +141,8 @@ TEST_F(TopologyServiceTest, StaleRecord) {
     EXPECT_EQ(1234, writer_host->get_port());
     EXPECT_EQ("writer-instance-3", writer_host->instance_name);
     EXPECT_EQ(WRITER_SESSION_ID, writer_host->session_id);
-    EXPECT_EQ("2020-09-15 17:51:55.0", writer_host->last_updated); // Only latest updated writer is counted
-    EXPECT_EQ("13.5", writer_host->replica_lag);
+    EXPECT_EQ(std::chrono::system_clock::from_time_t(1600192315), writer_host->last_updated); // Only latest updated writer is counted
+    EXPECT_EQ(14, writer_host->replica_lag_ms);
 }
 
 TEST_F(TopologyServiceTest, DuplicateInstances) {
@@ -164,8 +168,58 @@ TEST_F(TopologyServiceTest, DuplicateInstances) {
   EXPECT_EQ(1234, writer_host->get_port());
   EXPECT_EQ("writer-instance-1", writer_host->instance_name);
   EXPECT_EQ(WRITER_SESSION_ID, writer_host->session_id);
-  EXPECT_EQ("2020-09-15 17:51:53.0", writer_host->last_updated);
-  EXPECT_EQ("13.5", writer_host->replica_lag);
+  EXPECT_EQ(std::chrono::system_clock::from_time_t(1600192313), writer_host->last_updated);
+  EXPECT_EQ(14, writer_host->replica_lag_ms);
+}
+
+TEST_F(TopologyServiceTest, DownHostsTrackedById) {
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL)))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillOnce(Return(reader1))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(reader2))
+        .WillRepeatedly(Return(MYSQL_ROW{}));
+
+    auto topology = ts->get_topology(mock_proxy);
+    ASSERT_NE(nullptr, topology);
+
+    auto reader = topology->get_readers()[0];
+    // Hosts with the same host and port share an id
+    auto same_host = std::make_shared<HOST_INFO>(reader->get_host(), reader->get_port());
+    EXPECT_EQ(reader->get_host_id(), same_host->get_host_id());
+    EXPECT_NE(reader->get_host_id(), topology->get_writer()->get_host_id());
+    EXPECT_NE(reader->get_host_id(), std::make_shared<HOST_INFO>(reader->get_host(), 4321)->get_host_id());
+
+    ts->mark_host_down(same_host);
+    EXPECT_EQ(std::set<HOST_ID>{ reader->get_host_id() }, ts->get_down_hosts());
+    // The topology that was handed out before is not changed
+    EXPECT_FALSE(reader->is_host_down());
+    EXPECT_FALSE(same_host->is_host_down());
+    for (const auto& cached_reader : ts->get_cached_topology()->get_readers()) {
+        EXPECT_EQ(cached_reader->get_host_id() == reader->get_host_id(), cached_reader->is_host_down());
+    }
+
+    ts->mark_host_up(reader);
+    EXPECT_TRUE(ts->get_down_hosts().empty());
+}
+
+TEST_F(TopologyServiceTest, ConnectStats) {
+    const HOST_ID host_id = HOST_INFO("connect-stats-host", 1234).get_host_id();
+    EXPECT_EQ(0, TOPOLOGY_SERVICE::get_connect_stats(host_id).successes);
+
+    TOPOLOGY_SERVICE::record_connect_attempt(host_id, true, std::chrono::milliseconds(100));
+    TOPOLOGY_SERVICE::record_connect_attempt(host_id, true, std::chrono::milliseconds(200));
+    TOPOLOGY_SERVICE::record_connect_attempt(host_id, false, std::chrono::milliseconds(1000));
+
+    const auto stats = TOPOLOGY_SERVICE::get_connect_stats(host_id);
+    EXPECT_EQ(2, stats.successes);
+    EXPECT_EQ(1, stats.failures);
+    EXPECT_DOUBLE_EQ(130, stats.latency_ms);
+    EXPECT_DOUBLE_EQ(1000, stats.failure_latency_ms);
+    EXPECT_DOUBLE_EQ(0.3, stats.failure_rate);
+    // (0.7 * 130 + 0.3 * 1000) / 0.7
+    EXPECT_DOUBLE_EQ(391 / 0.7, stats.get_expected_connect_time_ms());
 }
 
 TEST_F(TopologyServiceTest, CachedTopology) {
@@ -233,6 +287,55 @@ TEST_F(TopologyServiceTest, RefreshTopology) {
     ts->get_topology(mock_proxy);
 }
 
+TEST_F(TopologyServiceTest, BackgroundRefreshServesCachedTopology) {
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL)))
+        .Times(1)
+        .WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillOnce(Return(reader1))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(reader2))
+        .WillRepeatedly(Return(MYSQL_ROW{}));
+
+    ts->set_refresh_rate(1);
+    ts->set_background_refresh(true);
+
+    auto topology1 = ts->get_topology(mock_proxy);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    // Stale, but a background refresher is expected to revalidate it
+    auto topology2 = ts->get_topology(mock_proxy);
+
+    EXPECT_NE(nullptr, topology1);
+    EXPECT_EQ(topology1, topology2);
+}
+
+TEST_F(TopologyServiceTest, TopologyLoadedFromSnapshot) {
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL)))
+        .Times(1)
+        .WillOnce(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillOnce(Return(reader1))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(reader2))
+        .WillRepeatedly(Return(MYSQL_ROW{}));
+
+    ts->set_topology_snapshot(".", 60000);
+    auto topology1 = ts->get_topology(mock_proxy);
+    ASSERT_NE(nullptr, topology1);
+
+    // A new process starts with an empty cache and finds the snapshot written by the query
+    ts->clear_all();
+    auto topology2 = ts->get_topology(mock_proxy);
+    std::remove(TOPOLOGY_SNAPSHOT(".", cluster_id).get_path().c_str());
+
+    ASSERT_NE(nullptr, topology2);
+    EXPECT_NE(topology1, topology2);
+    EXPECT_EQ(topology1->total_hosts(), topology2->total_hosts());
+    EXPECT_EQ(topology1->time_last_updated(), topology2->time_last_updated());
+    EXPECT_EQ(topology1->get_writer()->get_host_id(), topology2->get_writer()->get_host_id());
+    EXPECT_EQ(topology2, ts->get_cached_topology());
+}
+
 TEST_F(TopologyServiceTest, SharedTopology) {
     EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL)))
         .WillOnce(Return(0))
@@ -268,6 +371,66 @@ TEST_F(TopologyServiceTest, SharedTopology) {
     delete ts2;
 }
 
+TEST_F(TopologyServiceTest, ConcurrentRefreshQueriesOnce) {
+    // Each refresh interval the topology should be queried by only one of the connections.
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL)))
+        .Times(2)
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillOnce(Return(reader1))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(reader2))
+        .WillOnce(Return(MYSQL_ROW{}))
+        .WillOnce(Return(reader1))
+        .WillOnce(Return(writer))
+        .WillOnce(Return(reader2))
+        .WillRepeatedly(Return(MYSQL_ROW{}));
+
+    const int num_connections = 16;
+    std::vector<std::shared_ptr<TOPOLOGY_SERVICE>> services;
+    for (int i = 0; i < num_connections; i++) {
+        auto service = std::make_shared<TOPOLOGY_SERVICE>(0);
+        service->set_cluster_instance_template(cluster_instance);
+        service->set_cluster_id(cluster_id);
+        service->set_refresh_rate(1000);
+        services.push_back(service);
+    }
+
+    const auto refresh_all = [&services]() {
+        std::vector<std::thread> threads;
+        for (const auto& service : services) {
+            threads.push_back(std::thread([service]() {
+                EXPECT_NE(nullptr, service->get_topology(mock_proxy));
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
+    refresh_all();
+    refresh_all();
+    TEST_UTILS::expire_cached_topology(services[0].get());
+    refresh_all();
+}
+
+TEST_F(TopologyServiceTest, RefreshMutexesAreDropped) {
+    EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL)))
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(*mock_proxy, fetch_row(_))
+        .WillRepeatedly(Return(MYSQL_ROW{}));
+
+    for (int i = 0; i < 10; i++) {
+        TOPOLOGY_SERVICE service(0);
+        service.set_cluster_instance_template(cluster_instance);
+        service.set_cluster_id("cluster-" + std::to_string(i));
+        service.get_topology(mock_proxy);
+    }
+
+    // Only the mutex of the last cluster refreshed is left
+    EXPECT_EQ(1, TEST_UTILS::get_refresh_mutex_count());
+}
+
 TEST_F(TopologyServiceTest, ClearCache) {
     EXPECT_CALL(*mock_proxy, query(StrEq(RETRIEVE_TOPOLOGY_SQL)))
         .WillOnce(Return(0))
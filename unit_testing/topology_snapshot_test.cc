@@ -0,0 +1,139 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0
+// (GPLv2), as published by the Free Software Foundation, with the
+// following additional permissions:
+//
+// This program is distributed with certain software that is licensed
+// under separate terms, as designated in a particular file or component
+// or in the license documentation. Without limiting your rights under
+// the GPLv2, the authors of this program hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have included with the program.
+//
+// Without limiting the foregoing grant of rights under the GPLv2 and
+// additional permission as to separately licensed software, this
+// program is also subject to the Universal FOSS Exception, version 1.0,
+// a copy of which can be found along with its FAQ at
+// http://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see
+// http://www.gnu.org/licenses/gpl-2.0.html.
+
+
+#include "driver/topology_snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+namespace {
+    const std::string snapshot_directory(".");
+    const std::string cluster_id("test-cluster.cluster-XYZ.us-east-2.rds.amazonaws.com:1234");
+
+    std::shared_ptr<HOST_INFO> create_host(const std::string& instance_name, bool is_writer, int replica_lag_ms) {
+        auto host = std::make_shared<HOST_INFO>(instance_name + ".XYZ.us-east-2.rds.amazonaws.com", 1234);
+        host->mark_as_writer(is_writer);
+        host->instance_name = instance_name;
+        host->session_id = is_writer ? "MASTER_SESSION_ID" : "replica-session";
+        host->replica_lag_ms = replica_lag_ms;
+        host->last_updated = std::chrono::system_clock::from_time_t(1600192313) + std::chrono::microseconds(250);
+        return host;
+    }
+
+    void write_file(const std::string& path, const std::string& contents) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+    }
+}  // namespace
+
+class TopologySnapshotTest : public testing::Test {
+protected:
+    std::shared_ptr<TOPOLOGY_SNAPSHOT> snapshot;
+
+    void SetUp() override {
+        snapshot = std::make_shared<TOPOLOGY_SNAPSHOT>(snapshot_directory, cluster_id);
+    }
+
+    void TearDown() override {
+        std::remove(snapshot->get_path().c_str());
+    }
+};
+
+TEST_F(TopologySnapshotTest, WriteAndRead) {
+    auto topology = std::make_shared<CLUSTER_TOPOLOGY_INFO>();
+    topology->add_host(create_host("writer-instance", true, 0));
+    topology->add_host(create_host("replica-instance-1", false, 14));
+    topology->add_host(create_host("replica-instance-2", false, HOST_INFO::NO_REPLICA_LAG));
+
+    ASSERT_TRUE(snapshot->write(topology));
+
+    auto loaded = snapshot->read(std::chrono::minutes(5));
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(3, loaded->total_hosts());
+    EXPECT_EQ(2, loaded->num_readers());
+    EXPECT_EQ(topology->time_last_updated(), loaded->time_last_updated());
+
+    auto writer = loaded->get_writer();
+    ASSERT_NE(nullptr, writer);
+    EXPECT_TRUE(writer->is_host_writer());
+    EXPECT_EQ("writer-instance.XYZ.us-east-2.rds.amazonaws.com", writer->get_host());
+    EXPECT_EQ(1234, writer->get_port());
+    EXPECT_EQ("writer-instance", writer->instance_name);
+    EXPECT_EQ("MASTER_SESSION_ID", writer->session_id);
+    EXPECT_EQ(topology->get_writer()->last_updated, writer->last_updated);
+
+    auto readers = loaded->get_readers();
+    ASSERT_EQ(2, readers.size());
+    EXPECT_EQ("replica-instance-1", readers[0]->instance_name);
+    EXPECT_EQ(14, readers[0]->replica_lag_ms);
+    const int no_replica_lag = HOST_INFO::NO_REPLICA_LAG;
+    EXPECT_EQ(no_replica_lag, readers[1]->replica_lag_ms);
+}
+
+TEST_F(TopologySnapshotTest, ExpiredSnapshotIgnored) {
+    write_file(snapshot->get_path(),
+               "AWS_TOPOLOGY_SNAPSHOT 1\n" + cluster_id + "\n1600192313\n"
+               "W\twriter-instance.XYZ.us-east-2.rds.amazonaws.com\t1234\twriter-instance\tMASTER_SESSION_ID\t0\t0\n");
+
+    EXPECT_EQ(nullptr, snapshot->read(std::chrono::minutes(5)));
+
+    auto loaded = snapshot->read(std::chrono::hours(24 * 365 * 100));
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(1600192313, loaded->time_last_updated());
+}
+
+TEST_F(TopologySnapshotTest, OtherClusterIgnored) {
+    auto topology = std::make_shared<CLUSTER_TOPOLOGY_INFO>();
+    topology->add_host(create_host("writer-instance", true, 0));
+    ASSERT_TRUE(snapshot->write(topology));
+
+    // Maps to the same file name as the written cluster id
+    TOPOLOGY_SNAPSHOT other_snapshot(snapshot_directory, "test-cluster.cluster-XYZ.us-east-2.rds.amazonaws.com_1234");
+    ASSERT_EQ(snapshot->get_path(), other_snapshot.get_path());
+    EXPECT_EQ(nullptr, other_snapshot.read(std::chrono::minutes(5)));
+}
+
+TEST_F(TopologySnapshotTest, MalformedSnapshotIgnored) {
+    EXPECT_EQ(nullptr, snapshot->read(std::chrono::minutes(5)));
+
+    const std::string saved_time = std::to_string(static_cast<long long>(time(nullptr)));
+    write_file(snapshot->get_path(),
+               "AWS_TOPOLOGY_SNAPSHOT 1\n" + cluster_id + "\n" + saved_time + "\n"
+               "W\twriter-instance.XYZ.us-east-2.rds.amazonaws.com\t1234\twriter-ins");
+    EXPECT_EQ(nullptr, snapshot->read(std::chrono::minutes(5)));
+
+    write_file(snapshot->get_path(),
+               "AWS_TOPOLOGY_SNAPSHOT 1\n" + cluster_id + "\n" + saved_time + "\n"
+               "W\twriter-instance.XYZ.us-east-2.rds.amazonaws.com\tport\twriter-instance\tMASTER_SESSION_ID\t0\t0\n");
+    EXPECT_EQ(nullptr, snapshot->read(std::chrono::minutes(5)));
+}
@@ -266,9 +266,22 @@ static SQLWCHAR W_FAILOVER_TIMEOUT[] = { 'F', 'A', 'I', 'L', 'O', 'V', 'E', 'R',
 static SQLWCHAR W_FAILOVER_TOPOLOGY_REFRESH_RATE[] = { 'F', 'A', 'I', 'L', 'O', 'V', 'E', 'R', '_', 'T', 'O', 'P', 'O', 'L', 'O', 'G', 'Y', '_', 'R', 'E', 'F', 'R', 'E', 'S', 'H', '_', 'R', 'A', 'T', 'E', 0 };
 static SQLWCHAR W_FAILOVER_WRITER_RECONNECT_INTERVAL[] = { 'F', 'A', 'I', 'L', 'O', 'V', 'E', 'R', '_', 'W', 'R', 'I', 'T', 'E', 'R', '_', 'R', 'E', 'C', 'O', 'N', 'N', 'E', 'C', 'T', '_', 'I', 'N', 'T', 'E', 'R', 'V', 'A', 'L', 0 };
 static SQLWCHAR W_FAILOVER_READER_CONNECT_TIMEOUT[] = { 'F', 'A', 'I', 'L', 'O', 'V', 'E', 'R', '_', 'R', 'E', 'A', 'D', 'E', 'R', '_', 'C', 'O', 'N', 'N', 'E', 'C', 'T', '_', 'T', 'I', 'M', 'E', 'O', 'U', 'T', 0 };
+static SQLWCHAR W_FAILOVER_READER_FANOUT[] = { 'F', 'A', 'I', 'L', 'O', 'V', 'E', 'R', '_', 'R', 'E', 'A', 'D', 'E', 'R', '_', 'F', 'A', 'N', 'O', 'U', 'T', 0 };
+static SQLWCHAR W_FAILOVER_READER_STAGGER_DELAY[] = { 'F', 'A', 'I', 'L', 'O', 'V', 'E', 'R', '_', 'R', 'E', 'A', 'D', 'E', 'R', '_', 'S', 'T', 'A', 'G', 'G', 'E', 'R', '_', 'D', 'E', 'L', 'A', 'Y', 0 };
+static SQLWCHAR W_FAILOVER_STANDBY_CONNECTIONS[] = { 'F', 'A', 'I', 'L', 'O', 'V', 'E', 'R', '_', 'S', 'T', 'A', 'N', 'D', 'B', 'Y', '_', 'C', 'O', 'N', 'N', 'E', 'C', 'T', 'I', 'O', 'N', 'S', 0 };
+static SQLWCHAR W_READER_SELECTION_STRATEGY[] = { 'R', 'E', 'A', 'D', 'E', 'R', '_', 'S', 'E', 'L', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'S', 'T', 'R', 'A', 'T', 'E', 'G', 'Y', 0 };
+static SQLWCHAR W_MAX_REPLICA_LAG[] = { 'M', 'A', 'X', '_', 'R', 'E', 'P', 'L', 'I', 'C', 'A', '_', 'L', 'A', 'G', 0 };
+static SQLWCHAR W_TOPOLOGY_SNAPSHOT_DIR[] = { 'T', 'O', 'P', 'O', 'L', 'O', 'G', 'Y', '_', 'S', 'N', 'A', 'P', 'S', 'H', 'O', 'T', '_', 'D', 'I', 'R', 0 };
+static SQLWCHAR W_TOPOLOGY_SNAPSHOT_TTL[] = { 'T', 'O', 'P', 'O', 'L', 'O', 'G', 'Y', '_', 'S', 'N', 'A', 'P', 'S', 'H', 'O', 'T', '_', 'T', 'T', 'L', 0 };
+static SQLWCHAR W_DNS_CACHE_TTL[] = { 'D', 'N', 'S', '_', 'C', 'A', 'C', 'H', 'E', '_', 'T', 'T', 'L', 0 };
 static SQLWCHAR W_CONNECT_TIMEOUT[] = { 'C', 'O', 'N', 'N', 'E', 'C', 'T', '_', 'T', 'I', 'M', 'E', 'O', 'U', 'T', 0 };
 static SQLWCHAR W_NETWORK_TIMEOUT[] = { 'N', 'E', 'T', 'W', 'O', 'R', 'K', '_', 'T', 'I', 'M', 'E', 'O', 'U', 'T', 0 };
 
+/* Connection pool */
+static SQLWCHAR W_ENABLE_CONNECTION_POOL[] = { 'E', 'N', 'A', 'B', 'L', 'E', '_', 'C', 'O', 'N', 'N', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'P', 'O', 'O', 'L', 0 };
+static SQLWCHAR W_CONNECTION_POOL_MAX_SIZE[] = { 'C', 'O', 'N', 'N', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'P', 'O', 'O', 'L', '_', 'M', 'A', 'X', '_', 'S', 'I', 'Z', 'E', 0 };
+static SQLWCHAR W_CONNECTION_POOL_MAX_IDLE_TIME[] = { 'C', 'O', 'N', 'N', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'P', 'O', 'O', 'L', '_', 'M', 'A', 'X', '_', 'I', 'D', 'L', 'E', '_', 'T', 'I', 'M', 'E', 0 };
+
 /* Monitoring */
 static SQLWCHAR W_ENABLE_FAILURE_DETECTION[] = { 'E', 'N', 'A', 'B', 'L', 'E', '_', 'F', 'A', 'I', 'L', 'U', 'R', 'E', '_', 'D', 'E', 'T', 'E', 'C', 'T', 'I', 'O', 'N', 0 };
 static SQLWCHAR W_FAILURE_DETECTION_TIME[] = { 'F', 'A', 'I', 'L', 'U', 'R', 'E', '_', 'D', 'E', 'T', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'T', 'I', 'M', 'E', 0 };
@@ -276,6 +289,7 @@ static SQLWCHAR W_FAILURE_DETECTION_INTERVAL[] = { 'F', 'A', 'I', 'L', 'U', 'R',
 static SQLWCHAR W_FAILURE_DETECTION_COUNT[] = { 'F', 'A', 'I', 'L', 'U', 'R', 'E', '_', 'D', 'E', 'T', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'C', 'O', 'U', 'N', 'T', 0 };
 static SQLWCHAR W_MONITOR_DISPOSAL_TIME[] = { 'M', 'O', 'N', 'I', 'T', 'O', 'R', '_', 'D', 'I', 'S', 'P', 'O', 'S', 'A', 'L', '_', 'T', 'I', 'M', 'E', 0 };
 static SQLWCHAR W_FAILURE_DETECTION_TIMEOUT[] = { 'F', 'A', 'I', 'L', 'U', 'R', 'E', '_', 'D', 'E', 'T', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'T', 'I', 'M', 'E', 'O', 'U', 'T', 0 };
+static SQLWCHAR W_FAILURE_DETECTION_PHI_THRESHOLD[] = { 'F', 'A', 'I', 'L', 'U', 'R', 'E', '_', 'D', 'E', 'T', 'E', 'C', 'T', 'I', 'O', 'N', '_', 'P', 'H', 'I', '_', 'T', 'H', 'R', 'E', 'S', 'H', 'O', 'L', 'D', 0 };
 
 /* DS_PARAM */
 /* externally used strings */
@@ -327,12 +341,20 @@ SQLWCHAR *dsnparams[]= {W_DSN, W_DRIVER, W_DESCRIPTION, W_SERVER,
                         W_HOST_PATTERN, W_CLUSTER_ID, W_TOPOLOGY_REFRESH_RATE,
                         W_FAILOVER_TIMEOUT, W_FAILOVER_TOPOLOGY_REFRESH_RATE,
                         W_FAILOVER_WRITER_RECONNECT_INTERVAL,
-                        W_FAILOVER_READER_CONNECT_TIMEOUT, W_CONNECT_TIMEOUT,
-                        W_NETWORK_TIMEOUT,
+                        W_FAILOVER_READER_CONNECT_TIMEOUT, W_FAILOVER_READER_FANOUT,
+                        W_FAILOVER_READER_STAGGER_DELAY, W_FAILOVER_STANDBY_CONNECTIONS,
+                        W_CONNECT_TIMEOUT,
+                        W_NETWORK_TIMEOUT, W_READER_SELECTION_STRATEGY,
+                        W_MAX_REPLICA_LAG, W_TOPOLOGY_SNAPSHOT_DIR,
+                        W_TOPOLOGY_SNAPSHOT_TTL, W_DNS_CACHE_TTL,
                         /* Monitoring */
                         W_ENABLE_FAILURE_DETECTION, W_FAILURE_DETECTION_TIME,
                         W_FAILURE_DETECTION_INTERVAL, W_FAILURE_DETECTION_COUNT,
-                        W_MONITOR_DISPOSAL_TIME, W_FAILURE_DETECTION_TIMEOUT};
+                        W_MONITOR_DISPOSAL_TIME, W_FAILURE_DETECTION_TIMEOUT,
+                        W_FAILURE_DETECTION_PHI_THRESHOLD,
+                        /* Connection pool */
+                        W_ENABLE_CONNECTION_POOL, W_CONNECTION_POOL_MAX_SIZE,
+                        W_CONNECTION_POOL_MAX_IDLE_TIME};
 static const
 int dsnparamcnt= sizeof(dsnparams) / sizeof(SQLWCHAR *);
 /* DS_PARAM */
@@ -1039,8 +1061,11 @@ void DataSource::reset() {
   this->opt_TOPOLOGY_REFRESH_RATE.set_default(TOPOLOGY_REFRESH_RATE_MS);
   this->opt_FAILOVER_TIMEOUT.set_default(FAILOVER_TIMEOUT_MS);
   this->opt_FAILOVER_READER_CONNECT_TIMEOUT.set_default(FAILOVER_READER_CONNECT_TIMEOUT_MS);
+  this->opt_FAILOVER_READER_FANOUT.set_default(DEFAULT_FAILOVER_READER_FANOUT);
   this->opt_FAILOVER_TOPOLOGY_REFRESH_RATE.set_default(FAILOVER_TOPOLOGY_REFRESH_RATE_MS);
   this->opt_FAILOVER_WRITER_RECONNECT_INTERVAL.set_default(FAILOVER_WRITER_RECONNECT_INTERVAL_MS);
+  this->opt_TOPOLOGY_SNAPSHOT_TTL.set_default(TOPOLOGY_SNAPSHOT_TTL_MS);
+  this->opt_DNS_CACHE_TTL.set_default(DNS_CACHE_TTL_MS);
   this->opt_CONNECT_TIMEOUT.set_default(DEFAULT_CONNECT_TIMEOUT_SECS);
   this->opt_NETWORK_TIMEOUT.set_default(DEFAULT_NETWORK_TIMEOUT_SECS);
 
@@ -1051,6 +1076,9 @@ void DataSource::reset() {
   this->opt_MONITOR_DISPOSAL_TIME.set_default(MONITOR_DISPOSAL_TIME_MS);
   this->opt_FAILURE_DETECTION_TIMEOUT.set_default(FAILURE_DETECTION_TIMEOUT_SECS);
 
+  this->opt_CONNECTION_POOL_MAX_SIZE.set_default(DEFAULT_CONNECTION_POOL_MAX_SIZE);
+  this->opt_CONNECTION_POOL_MAX_IDLE_TIME.set_default(CONNECTION_POOL_MAX_IDLE_TIME_MS);
+
   this->opt_AUTH_PORT.set_default(-1);
 }
 
@@ -284,6 +284,9 @@ class Driver {
 #define FAILOVER_TIMEOUT_MS 60000
 #define FAILOVER_READER_CONNECT_TIMEOUT_MS 30000
 #define FAILOVER_WRITER_RECONNECT_INTERVAL_MS 5000
+#define TOPOLOGY_SNAPSHOT_TTL_MS 300000
+#define DNS_CACHE_TTL_MS 30000
+#define DEFAULT_FAILOVER_READER_FANOUT 2
 
 // Monitoring default settings
 #define FAILURE_DETECTION_TIME_MS 30000
@@ -292,6 +295,10 @@ class Driver {
 #define MONITOR_DISPOSAL_TIME_MS 60000
 #define FAILURE_DETECTION_TIMEOUT_SECS 5
 
+// Connection pool default settings
+#define DEFAULT_CONNECTION_POOL_MAX_SIZE 10
+#define CONNECTION_POOL_MAX_IDLE_TIME_MS 60000
+
 // Default timeout settings
 #define DEFAULT_CONNECT_TIMEOUT_SECS 30
 #define DEFAULT_NETWORK_TIMEOUT_SECS 30
@@ -335,7 +342,9 @@ unsigned int get_network_timeout(unsigned int seconds);
 #define FAILOVER_STR_OPTIONS_LIST(X) \
   X(HOST_PATTERN)                    \
   X(CLUSTER_ID)                      \
-  X(FAILOVER_MODE)
+  X(FAILOVER_MODE)                   \
+  X(READER_SELECTION_STRATEGY)        \
+  X(TOPOLOGY_SNAPSHOT_DIR)
 
 #define FAILOVER_INT_OPTIONS_LIST(X)    \
   X(TOPOLOGY_REFRESH_RATE)              \
@@ -343,6 +352,12 @@ unsigned int get_network_timeout(unsigned int seconds);
   X(FAILOVER_TOPOLOGY_REFRESH_RATE)     \
   X(FAILOVER_WRITER_RECONNECT_INTERVAL) \
   X(FAILOVER_READER_CONNECT_TIMEOUT)    \
+  X(FAILOVER_READER_FANOUT)             \
+  X(FAILOVER_READER_STAGGER_DELAY)      \
+  X(FAILOVER_STANDBY_CONNECTIONS)       \
+  X(MAX_REPLICA_LAG)                    \
+  X(TOPOLOGY_SNAPSHOT_TTL)              \
+  X(DNS_CACHE_TTL)                      \
   X(CONNECT_TIMEOUT)                    \
   X(NETWORK_TIMEOUT)
 
@@ -353,8 +368,15 @@ unsigned int get_network_timeout(unsigned int seconds);
   X(FAILURE_DETECTION_INTERVAL)        \
   X(FAILURE_DETECTION_COUNT)           \
   X(FAILURE_DETECTION_TIMEOUT)         \
+  X(FAILURE_DETECTION_PHI_THRESHOLD)   \
   X(MONITOR_DISPOSAL_TIME)
 
+#define CONNECTION_POOL_BOOL_OPTIONS_LIST(X) X(ENABLE_CONNECTION_POOL)
+
+#define CONNECTION_POOL_INT_OPTIONS_LIST(X) \
+  X(CONNECTION_POOL_MAX_SIZE)               \
+  X(CONNECTION_POOL_MAX_IDLE_TIME)
+
 #define STR_OPTIONS_LIST(X)                                                   \
   X(DSN)                                                                      \
   X(DRIVER)                                                                   \
@@ -374,7 +396,8 @@ unsigned int get_network_timeout(unsigned int seconds);
   X(READTIMEOUT)                                                 \
   X(WRITETIMEOUT)                                                \
   X(CLIENT_INTERACTIVE) X(PREFETCH) FAILOVER_INT_OPTIONS_LIST(X) \
-      AWS_AUTH_INT_OPTIONS_LIST(X) MONITORING_INT_OPTIONS_LIST(X) FED_AUTH_INT_OPTIONS_LIST(X)
+      AWS_AUTH_INT_OPTIONS_LIST(X) MONITORING_INT_OPTIONS_LIST(X) FED_AUTH_INT_OPTIONS_LIST(X) \
+          CONNECTION_POOL_INT_OPTIONS_LIST(X)
 
 // TODO: remove AUTO_RECONNECT when special handling (warning)
 //       is not needed anymore.
@@ -396,7 +419,8 @@ unsigned int get_network_timeout(unsigned int seconds);
                                   X(ENABLE_LOCAL_INFILE) X(ENABLE_DNS_SRV)     \
                                       X(MULTI_HOST)                            \
                                           FAILOVER_BOOL_OPTIONS_LIST(X)        \
-                                              MONITORING_BOOL_OPTIONS_LIST(X)
+                                              MONITORING_BOOL_OPTIONS_LIST(X)  \
+                                                  CONNECTION_POOL_BOOL_OPTIONS_LIST(X)
 
 #define FULL_OPTIONS_LIST(X) \
   STR_OPTIONS_LIST(X) INT_OPTIONS_LIST(X) BOOL_OPTIONS_LIST(X)
@@ -493,6 +517,11 @@ extern const SQLWCHAR W_INVALID_ATTR_STR[];
 #define FAILOVER_MODE_STRICT_READER     "STRICT READER"
 #define FAILOVER_MODE_READER_OR_WRITER  "READER OR WRITER"
 
+#define READER_SELECTION_RANDOM         "RANDOM"
+#define READER_SELECTION_LEAST_LAG      "LEAST LAG"
+#define READER_SELECTION_LAG_WEIGHTED   "LAG WEIGHTED"
+#define READER_SELECTION_LOWEST_LATENCY "LOWEST LATENCY"
+
 /*
  * Deprecated connection parameters
  */